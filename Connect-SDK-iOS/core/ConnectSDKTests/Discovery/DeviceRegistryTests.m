@@ -0,0 +1,125 @@
+//
+//  DeviceRegistryTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DeviceRegistry.h"
+
+@interface DeviceRegistryTests : XCTestCase
+
+@property (nonatomic, strong) DeviceRegistry *registry;
+
+@end
+
+@implementation DeviceRegistryTests
+
+- (void)setUp {
+    [super setUp];
+    self.registry = [DeviceRegistry new];
+}
+
+- (void)tearDown {
+    self.registry = nil;
+    [super tearDown];
+}
+
+#pragma mark - Tests
+
+- (void)testNewRegistryShouldBeEmpty {
+    XCTAssertEqual(self.registry.snapshot.allDevices.count, 0u);
+    XCTAssertEqual(self.registry.snapshot.compatibleDevices.count, 0u);
+}
+
+- (void)testUpdateShouldPublishBothDictionariesTogether {
+    id device = [NSObject new];
+
+    id result = [self.registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices) {
+        allDevices[@"10.0.0.2"] = device;
+        compatibleDevices[@"10.0.0.2"] = device;
+        return @"done";
+    }];
+
+    DeviceRegistrySnapshot *snapshot = self.registry.snapshot;
+    XCTAssertEqualObjects(result, @"done", @"update should return the block's result");
+    XCTAssertEqual(snapshot.allDevices[@"10.0.0.2"], device);
+    XCTAssertEqual(snapshot.compatibleDevices[@"10.0.0.2"], device);
+}
+
+- (void)testSnapshotShouldNotChangeAfterUpdate {
+    [self.registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices) {
+        allDevices[@"10.0.0.2"] = @"tv";
+        return nil;
+    }];
+
+    DeviceRegistrySnapshot *before = self.registry.snapshot;
+
+    [self.registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices) {
+        [allDevices removeAllObjects];
+        allDevices[@"10.0.0.3"] = @"speaker";
+        return nil;
+    }];
+
+    XCTAssertEqualObjects(before.allDevices, @{@"10.0.0.2": @"tv"},
+                          @"a snapshot taken earlier should keep its devices");
+    XCTAssertFalse([before.allDevices isKindOfClass:[NSMutableDictionary class]],
+                   @"snapshots should hold immutable dictionaries");
+    XCTAssertEqualObjects(self.registry.snapshot.allDevices, @{@"10.0.0.3": @"speaker"});
+}
+
+- (void)testRemoveAllDevicesShouldReturnPreviousSnapshot {
+    [self.registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices) {
+        allDevices[@"10.0.0.2"] = @"tv";
+        compatibleDevices[@"10.0.0.2"] = @"tv";
+        return nil;
+    }];
+
+    DeviceRegistrySnapshot *purged = [self.registry removeAllDevices];
+
+    XCTAssertEqualObjects(purged.compatibleDevices, @{@"10.0.0.2": @"tv"});
+    XCTAssertEqual(self.registry.snapshot.allDevices.count, 0u);
+    XCTAssertEqual(self.registry.snapshot.compatibleDevices.count, 0u);
+}
+
+- (void)testConcurrentUpdatesShouldNotLoseDevices {
+    static const NSUInteger kDeviceCount = 500;
+    DeviceRegistry *registry = self.registry;
+
+    dispatch_apply(kDeviceCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+        NSString *address = [NSString stringWithFormat:@"10.0.%zu.%zu", i / 256, i % 256];
+
+        [registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices) {
+            allDevices[address] = @(i);
+
+            if (i % 2 == 0)
+                compatibleDevices[address] = @(i);
+
+            return nil;
+        }];
+
+        // Readers should always see compatible devices as a subset of all
+        // devices
+        DeviceRegistrySnapshot *snapshot = registry.snapshot;
+        for (NSString *key in snapshot.compatibleDevices)
+            XCTAssertNotNil(snapshot.allDevices[key]);
+    });
+
+    XCTAssertEqual(registry.snapshot.allDevices.count, kDeviceCount);
+    XCTAssertEqual(registry.snapshot.compatibleDevices.count, kDeviceCount / 2);
+}
+
+@end
@@ -0,0 +1,80 @@
+//
+//  DiscoveryBenchmarkTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DiscoveryReplayHarness.h"
+
+/// Name of the recorded traffic in the test bundle.
+static NSString *const kTraceName = @"discovery_replay_trace";
+
+/// End-to-end benchmarks of discovery. Each test replays the recorded traffic
+/// for a number of simulated devices and logs what it measured; the numbers
+/// are for comparing changes, so only finding every device is asserted.
+@interface DiscoveryBenchmarkTests : XCTestCase
+
+@end
+
+@implementation DiscoveryBenchmarkTests
+
+#pragma mark - Replay Tests
+
+- (void)testReplayShouldFindEveryKindOfDevice {
+    DiscoveryReplayHarness *harness = [self harnessForDeviceCount:6];
+    harness.responseSpread = 0.1;
+
+    DiscoveryBenchmarkReport *report = [harness runWithTimeout:5];
+
+    XCTAssertEqual(report.devicesFound, 6u, @"every simulated device should be found");
+    XCTAssertGreaterThanOrEqual(report.timeToFirstDevice, 0);
+    XCTAssertGreaterThanOrEqual(report.timeToAllDevices, report.timeToFirstDevice);
+    XCTAssertEqual(harness.discoveryManager.allDevices.count, 6u);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testDiscoveryBenchmarkWithOneDevice {
+    [self runBenchmarkWithDeviceCount:1 timeout:5];
+}
+
+- (void)testDiscoveryBenchmarkWith50Devices {
+    [self runBenchmarkWithDeviceCount:50 timeout:10];
+}
+
+- (void)testDiscoveryBenchmarkWith500Devices {
+    [self runBenchmarkWithDeviceCount:500 timeout:30];
+}
+
+#pragma mark - Helpers
+
+- (DiscoveryReplayHarness *)harnessForDeviceCount:(NSUInteger)deviceCount {
+    DiscoveryReplayHarness *harness = [DiscoveryReplayHarness harnessWithTraceNamed:kTraceName
+                                                                         bundleClass:[self class]];
+    harness.deviceCount = deviceCount;
+
+    return harness;
+}
+
+- (void)runBenchmarkWithDeviceCount:(NSUInteger)deviceCount timeout:(NSTimeInterval)timeout {
+    DiscoveryBenchmarkReport *report = [[self harnessForDeviceCount:deviceCount] runWithTimeout:timeout];
+    NSLog(@"Discovery benchmark: %@", report);
+
+    XCTAssertEqual(report.devicesFound, deviceCount, @"every simulated device should be found");
+}
+
+@end
@@ -22,6 +22,10 @@
 
 #import "AppStateChangeNotifier.h"
 #import "DiscoveryProvider.h"
+#import "ConnectableDeviceStore.h"
+#import "NetworkChangeNotifier.h"
+#import "ServiceDescription.h"
+#import "TimingWheel_Private.h"
 
 #import "OCMArg+ArgumentCaptor.h"
 
@@ -34,6 +38,24 @@
 
 @end
 
+/// Reports whatever SSID it's told to, without listening to the system.
+@interface FakeNetworkChangeNotifier : NetworkChangeNotifier
+@property (nonatomic, copy) NSString *ssid;
+@end
+@implementation FakeNetworkChangeNotifier
+
+- (void)startListening {
+}
+
+- (void)stopListening {
+}
+
+- (NSString *)currentSSID {
+    return self.ssid;
+}
+
+@end
+
 
 
 @interface DiscoveryManagerTests : XCTestCase
@@ -41,6 +63,9 @@
 @property (nonatomic, strong) DiscoveryManager *discoveryManager;
 @property (nonatomic, strong) id /*AppStateChangeNotifier **/ stateNotifierMock;
 @property (nonatomic, strong) id /*DiscoveryProvider **/ discoveryProviderMock;
+@property (nonatomic, strong) FakeNetworkChangeNotifier *networkNotifier;
+@property (nonatomic, strong) TimingWheel *wheel;
+@property (nonatomic) NSTimeInterval now;
 
 @end
 
@@ -53,12 +78,22 @@
 
     self.stateNotifierMock = OCMClassMock([AppStateChangeNotifier class]);
     self.discoveryProviderMock = OCMClassMock([DiscoveryProvider class]);
+    self.networkNotifier = [FakeNetworkChangeNotifier new];
+    self.networkNotifier.ssid = @"home";
+
+    self.now = 1000;
+    self.wheel = [[TimingWheel alloc] initWithTickInterval:1 queue:dispatch_get_main_queue()];
+    __weak typeof(self) weakSelf = self;
+    self.wheel.timeSource = ^{ return weakSelf.now; };
+
     self.discoveryManager = [self createDiscoveryManager];
 }
 
 - (DiscoveryManager *)createDiscoveryManager {
     DiscoveryManager *discoveryManager = [[DiscoveryManager alloc]
-                                          initWithAppStateChangeNotifier:self.stateNotifierMock];
+                                          initWithAppStateChangeNotifier:self.stateNotifierMock
+                                          networkChangeNotifier:self.networkNotifier];
+    discoveryManager.timingWheel = self.wheel;
     [discoveryManager registerDeviceService:[MockDeviceService class]
                withDiscoveryProviderFactory:^{
                    return self.discoveryProviderMock;
@@ -71,6 +106,8 @@
     [self.discoveryManager stopDiscovery];
     self.discoveryManager = nil;
     self.stateNotifierMock = nil;
+    self.networkNotifier = nil;
+    self.wheel = nil;
 
     [super tearDown];
 }
@@ -126,4 +163,147 @@
     OCMVerifyAll(self.discoveryProviderMock);
 }
 
+#pragma mark - Fast Start Tests
+
+- (void)testFastStartShouldProbeStoredDevicesMostRecentFirst {
+    id deviceStoreMock = OCMProtocolMock(@protocol(ConnectableDeviceStore));
+    OCMStub([deviceStoreMock storedDevices]).andReturn((@{
+        @"old": @{@"lastKnownIPAddress": @"10.0.0.2", @"lastDetection": @100},
+        @"new": @{@"lastKnownIPAddress": @"10.0.0.3", @"lastConnected": @200},
+        @"noAddress": @{@"lastDetection": @300},
+    }));
+    self.discoveryManager.deviceStore = deviceStoreMock;
+    self.discoveryManager.fastStartEnabled = YES;
+
+    OCMExpect([self.discoveryProviderMock probeAddresses:(@[@"10.0.0.3", @"10.0.0.2"])]);
+    [self.discoveryManager startDiscovery];
+    OCMVerifyAll(self.discoveryProviderMock);
+}
+
+- (void)testStoredDevicesShouldNotBeProbedByDefault {
+    id deviceStoreMock = OCMProtocolMock(@protocol(ConnectableDeviceStore));
+    OCMStub([deviceStoreMock storedDevices]).andReturn((@{
+        @"tv": @{@"lastKnownIPAddress": @"10.0.0.2"},
+    }));
+    self.discoveryManager.deviceStore = deviceStoreMock;
+
+    [[self.discoveryProviderMock reject] probeAddresses:OCMOCK_ANY];
+    [self.discoveryManager startDiscovery];
+    OCMVerifyAll(self.discoveryProviderMock);
+}
+
+#pragma mark - Network Change Tests
+
+- (void)testDefaultNetworkNotifierShouldBeCreated {
+    DiscoveryManager *discoveryManager = [DiscoveryManager new];
+    XCTAssertNotNil(discoveryManager.networkChangeNotifier,
+                    @"a real NetworkChangeNotifier should be created");
+}
+
+- (void)testNetworkChangesShouldBeDebouncedBeforeRestartingDiscovery {
+    __block NSUInteger restarts = 0;
+    OCMStub([self.discoveryProviderMock probeAddresses:OCMOCK_ANY]).andDo(^(NSInvocation *invocation) {
+        ++restarts;
+    });
+    [self.discoveryManager startDiscovery];
+
+    self.networkNotifier.ssid = @"office";
+    self.networkNotifier.didChangeBlock();
+    [self advanceBy:1];
+    self.networkNotifier.didChangeBlock();
+    [self advanceBy:1];
+    XCTAssertEqual(restarts, 0u, @"discovery should wait for the changes to settle");
+
+    [self advanceBy:2];
+    XCTAssertEqual(restarts, 1u, @"discovery should restart once for a burst of changes");
+}
+
+- (void)testNetworkChangeOnSameSSIDShouldNotRestartDiscovery {
+    [self.discoveryManager startDiscovery];
+
+    [[self.discoveryProviderMock reject] probeAddresses:OCMOCK_ANY];
+    self.networkNotifier.didChangeBlock();
+    [self advanceBy:10];
+    OCMVerifyAll(self.discoveryProviderMock);
+}
+
+- (void)testSSIDChangeShouldOnlyDropDevicesNotFoundAgain {
+    id<DiscoveryProviderDelegate> providerDelegate = (id<DiscoveryProviderDelegate>)self.discoveryManager;
+    ServiceDescription *kept = [ServiceDescription descriptionWithAddress:@"10.0.0.2" UUID:@"kept"];
+    kept.serviceId = @"mockService";
+    ServiceDescription *gone = [ServiceDescription descriptionWithAddress:@"10.0.0.3" UUID:@"gone"];
+    gone.serviceId = @"mockService";
+
+    NSMutableArray *lostAddresses = [NSMutableArray array];
+    id delegateMock = OCMProtocolMock(@protocol(DiscoveryManagerDelegate));
+    OCMStub([delegateMock discoveryManager:OCMOCK_ANY
+                             didLoseDevice:[OCMArg checkWithBlock:^BOOL(ConnectableDevice *device) {
+        [lostAddresses addObject:device.address];
+        return YES;
+    }]]);
+    self.discoveryManager.delegate = delegateMock;
+
+    [self.discoveryManager startDiscovery];
+    [providerDelegate discoveryProvider:self.discoveryProviderMock didFindService:kept];
+    [providerDelegate discoveryProvider:self.discoveryProviderMock didFindService:gone];
+
+    OCMExpect([self.discoveryProviderMock probeAddresses:
+               [OCMArg checkWithBlock:^BOOL(NSArray *addresses) {
+        return [[NSSet setWithArray:addresses] isEqualToSet:[NSSet setWithArray:(@[@"10.0.0.2", @"10.0.0.3"])]];
+    }]]);
+    self.networkNotifier.ssid = @"office";
+    self.networkNotifier.didChangeBlock();
+    [self advanceBy:3];
+    OCMVerifyAll(self.discoveryProviderMock);
+
+    [providerDelegate discoveryProvider:self.discoveryProviderMock didFindService:kept];
+    XCTAssertEqual(lostAddresses.count, 0u, @"devices should be kept during the grace period");
+
+    [self advanceBy:10];
+    XCTAssertEqualObjects(lostAddresses, @[@"10.0.0.3"]);
+    XCTAssertEqualObjects(self.discoveryManager.allDevices.allKeys, @[@"10.0.0.2"]);
+}
+
+- (void)testSSIDChangeShouldReplaceADifferentDeviceAtTheSameAddress {
+    id<DiscoveryProviderDelegate> providerDelegate = (id<DiscoveryProviderDelegate>)self.discoveryManager;
+    ServiceDescription *oldTV = [ServiceDescription descriptionWithAddress:@"10.0.0.2" UUID:@"old"];
+    oldTV.serviceId = @"mockService";
+    ServiceDescription *newTV = [ServiceDescription descriptionWithAddress:@"10.0.0.2" UUID:@"new"];
+    newTV.serviceId = @"mockService";
+
+    NSMutableArray *lostDevices = [NSMutableArray array];
+    id delegateMock = OCMProtocolMock(@protocol(DiscoveryManagerDelegate));
+    OCMStub([delegateMock discoveryManager:OCMOCK_ANY
+                             didLoseDevice:[OCMArg checkWithBlock:^BOOL(ConnectableDevice *device) {
+        [lostDevices addObject:device];
+        return YES;
+    }]]);
+    self.discoveryManager.delegate = delegateMock;
+
+    [self.discoveryManager startDiscovery];
+    [providerDelegate discoveryProvider:self.discoveryProviderMock didFindService:oldTV];
+    ConnectableDevice *oldDevice = self.discoveryManager.allDevices[@"10.0.0.2"];
+
+    self.networkNotifier.ssid = @"office";
+    self.networkNotifier.didChangeBlock();
+    [self advanceBy:3];
+
+    [providerDelegate discoveryProvider:self.discoveryProviderMock didFindService:newTV];
+    ConnectableDevice *newDevice = self.discoveryManager.allDevices[@"10.0.0.2"];
+
+    XCTAssertEqualObjects(lostDevices, @[oldDevice], @"the old device should be lost straight away");
+    XCTAssertNotEqual(newDevice, oldDevice, @"the new device should not be merged into the old one");
+    XCTAssertEqualObjects([newDevice.services.firstObject serviceDescription].UUID, @"new");
+
+    [self advanceBy:10];
+    XCTAssertEqual(lostDevices.count, 1u, @"the new device should survive the purge");
+}
+
+#pragma mark - Helpers
+
+- (void)advanceBy:(NSTimeInterval)interval {
+    self.now += interval;
+    [self.wheel fireExpiredTimers];
+}
+
 @end
@@ -0,0 +1,93 @@
+//
+//  DiscoveryReplayHarness.h
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+@class DiscoveryManager;
+
+/// What a single replay measured. Times are in seconds from the moment
+/// discovery was started.
+@interface DiscoveryBenchmarkReport : NSObject
+
+@property (nonatomic) NSUInteger deviceCount;
+@property (nonatomic) NSUInteger devicesFound;
+
+/// When the delegate heard of the first device, or -1 if it never did.
+@property (nonatomic) NSTimeInterval timeToFirstDevice;
+
+/// When the delegate had heard of every simulated device, or -1 if it never
+/// did.
+@property (nonatomic) NSTimeInterval timeToAllDevices;
+
+/// User and system CPU time used by the whole process during the replay.
+@property (nonatomic) NSTimeInterval CPUTime;
+
+/// Net change in heap blocks and bytes during the replay. Objects that were
+/// created and freed again aren't counted.
+@property (nonatomic) NSInteger allocatedBlocks;
+@property (nonatomic) NSInteger allocatedBytes;
+
+/// How long the main run loop spent handling events rather than waiting, and
+/// that time as a fraction of the replay.
+@property (nonatomic) NSTimeInterval mainThreadBusyTime;
+@property (nonatomic) double mainThreadOccupancy;
+
+@end
+
+/**
+ * Drives a real DiscoveryManager with recorded SSDP and mDNS traffic, without
+ * touching the network.
+ *
+ * The trace holds the traffic of one device of each kind. Every simulated
+ * device replays one of them, taking turns, at its own address. SSDP replies
+ * are fed to the SSDPDiscoveryProvider whenever it sends a search, and its
+ * LOCATION requests are answered by OHHTTPStubs. mDNS services are announced
+ * by a stand-in NSNetServiceBrowser once the ZeroConfDiscoveryProvider starts
+ * browsing, and resolve after the recorded delay.
+ *
+ * Trace placeholders: @c {{ADDRESS}}, @c {{UUID}}, @c {{MAC}} and
+ * @c {{INDEX}}.
+ */
+@interface DiscoveryReplayHarness : NSObject
+
+/// The manager under test. A new one is created for each replay.
+@property (nonatomic, readonly) DiscoveryManager *discoveryManager;
+
+/// How many devices answer. Defaults to 1.
+@property (nonatomic) NSUInteger deviceCount;
+
+/// Replies are spread evenly over this many seconds, the way devices answer
+/// at random within the search's MX. Defaults to 1.
+@property (nonatomic) NSTimeInterval responseSpread;
+
+/// How long each LOCATION request takes to answer. Defaults to 10 ms.
+@property (nonatomic) NSTimeInterval descriptionLatency;
+
+/// Loads a trace from a JSON file in the bundle of @c bundleClass.
++ (instancetype)harnessWithTraceNamed:(NSString *)name bundleClass:(Class)bundleClass;
+
+- (instancetype)initWithTrace:(NSDictionary *)trace
+                 resourcePath:(NSString *)resourcePath;
+
+/// Starts discovery and runs the current run loop until every device has been
+/// found or @c timeout seconds have passed.
+- (DiscoveryBenchmarkReport *)runWithTimeout:(NSTimeInterval)timeout;
+
+@end
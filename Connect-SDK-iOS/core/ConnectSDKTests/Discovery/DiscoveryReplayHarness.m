@@ -0,0 +1,496 @@
+//
+//  DiscoveryReplayHarness.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DiscoveryReplayHarness.h"
+
+#import <OHHTTPStubs/OHHTTPStubs.h>
+#import <arpa/inet.h>
+#import <malloc/malloc.h>
+#import <sys/resource.h>
+
+#import "ConnectableDevice.h"
+#import "DeviceService.h"
+#import "DiscoveryManager_Private.h"
+#import "NSMutableDictionary+NilSafe.h"
+#import "SSDPDescriptionCache.h"
+#import "SSDPDiscoveryProvider_Private.h"
+#import "ZeroConfDiscoveryProvider_Private.h"
+
+static NSString *const kSSDPMulticastAddress = @"239.255.255.250";
+
+/// Fills in the per-device placeholders of a trace string.
+static NSString *fillPlaceholders(NSString *template, NSDictionary *values) {
+    NSMutableString *string = [template mutableCopy];
+
+    [values enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        [string replaceOccurrencesOfString:[NSString stringWithFormat:@"{{%@}}", key]
+                                withString:value
+                                   options:0
+                                     range:NSMakeRange(0, string.length)];
+    }];
+
+    return string;
+}
+
+static NSData *IPv4AddressData(NSString *address, in_port_t port) {
+    struct sockaddr_in socket;
+    bzero(&socket, sizeof(socket));
+    socket.sin_len = sizeof(socket);
+    socket.sin_family = AF_INET;
+    socket.sin_port = htons(port);
+    inet_pton(AF_INET, address.UTF8String, &socket.sin_addr);
+
+    return [NSData dataWithBytes:&socket length:sizeof(socket)];
+}
+
+#pragma mark - Measurements
+
+typedef struct {
+    NSTimeInterval CPUTime;
+    size_t blocksInUse;
+    size_t bytesInUse;
+} ResourceSample;
+
+static ResourceSample sampleResources(void) {
+    ResourceSample sample;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    sample.CPUTime = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                     usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+
+    malloc_statistics_t stats;
+    malloc_zone_statistics(NULL, &stats);
+    sample.blocksInUse = stats.blocks_in_use;
+    sample.bytesInUse = stats.size_in_use;
+
+    return sample;
+}
+
+@implementation DiscoveryBenchmarkReport
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%lu/%lu devices, first %.3fs, all %.3fs, CPU %.3fs, "
+                                      @"main thread %.3fs (%.0f%%), %+ld blocks, %+ld bytes",
+            (unsigned long)self.devicesFound, (unsigned long)self.deviceCount,
+            self.timeToFirstDevice, self.timeToAllDevices, self.CPUTime,
+            self.mainThreadBusyTime, self.mainThreadOccupancy * 100,
+            (long)self.allocatedBlocks, (long)self.allocatedBytes];
+}
+
+@end
+
+#pragma mark - Device Services
+
+@interface ReplayRendererService : DeviceService @end
+@implementation ReplayRendererService
+
++ (NSDictionary *)discoveryParameters {
+    return @{@"serviceId": @"ReplayRenderer",
+             @"ssdp": @{@"filter": @"urn:schemas-upnp-org:device:MediaRenderer:1"}};
+}
+
+@end
+
+@interface ReplayDIALService : DeviceService @end
+@implementation ReplayDIALService
+
++ (NSDictionary *)discoveryParameters {
+    return @{@"serviceId": @"ReplayDIAL",
+             @"ssdp": @{@"filter": @"urn:dial-multiscreen-org:service:dial:1"}};
+}
+
+@end
+
+@interface ReplayAirPlayService : DeviceService @end
+@implementation ReplayAirPlayService
+
++ (NSDictionary *)discoveryParameters {
+    return @{@"serviceId": @"ReplayAirPlay",
+             @"zeroconf": @{@"filter": @"_airplay._tcp"}};
+}
+
+@end
+
+#pragma mark - Network Stand-ins
+
+/// Hands every search to the harness instead of sending it.
+@interface ReplaySSDPSocket : SSDPSocketListener
+@property (nonatomic, copy) void (^searchBlock)(NSString *address);
+@end
+@implementation ReplaySSDPSocket
+
+- (void)open {
+}
+
+- (void)close {
+}
+
+- (void)sendData:(NSData *)aData toAddress:(NSString *)anAddress andPort:(NSUInteger)aPort {
+    if (self.searchBlock)
+        self.searchBlock(anAddress);
+}
+
+@end
+
+/// Hands every browse to the harness instead of multicasting it.
+@interface ReplayNetServiceBrowser : NSNetServiceBrowser
+@property (nonatomic, copy) void (^searchBlock)(NSString *type);
+@end
+@implementation ReplayNetServiceBrowser
+
+- (void)searchForServicesOfType:(NSString *)type inDomain:(NSString *)domainString {
+    if (self.searchBlock)
+        self.searchBlock(type);
+}
+
+- (void)stop {
+}
+
+@end
+
+/// Resolves to a recorded address and TXT record after a delay.
+@interface ReplayNetService : NSNetService
+@property (nonatomic, strong) NSArray *replayAddresses;
+@property (nonatomic, strong) NSData *replayTXTRecordData;
+@property (nonatomic) NSTimeInterval announceDelay;
+@property (nonatomic) NSTimeInterval resolveDelay;
+@end
+@implementation ReplayNetService
+
+- (NSArray *)addresses {
+    return self.replayAddresses;
+}
+
+- (NSData *)TXTRecordData {
+    return self.replayTXTRecordData;
+}
+
+- (void)resolveWithTimeout:(NSTimeInterval)timeout {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.resolveDelay * NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+        [self.delegate netServiceDidResolveAddress:self];
+    });
+}
+
+- (void)stop {
+}
+
+@end
+
+/// One simulated device's SSDP replies.
+@interface ReplaySSDPDevice : NSObject
+@property (nonatomic, strong) NSArray *datagrams;
+@property (nonatomic) NSTimeInterval delay;
+@end
+@implementation ReplaySSDPDevice
+@end
+
+#pragma mark - Harness
+
+@interface DiscoveryReplayHarness () <DiscoveryManagerDelegate>
+@end
+
+@implementation DiscoveryReplayHarness
+{
+    NSDictionary *_trace;
+    NSString *_resourcePath;
+
+    NSArray *_ssdpDevices;
+    NSArray *_zeroconfDevices;
+    NSDictionary *_descriptions;
+
+    SSDPDiscoveryProvider *_ssdpProvider;
+    ReplaySSDPSocket *_searchSocket;
+    ZeroConfDiscoveryProvider *_zeroconfProvider;
+    ReplayNetServiceBrowser *_netServiceBrowser;
+
+    NSMutableSet *_foundAddresses;
+    DiscoveryBenchmarkReport *_report;
+    CFAbsoluteTime _startTime;
+
+    CFAbsoluteTime _busyStart;
+    NSTimeInterval _busyTime;
+}
+
++ (instancetype)harnessWithTraceNamed:(NSString *)name bundleClass:(Class)bundleClass {
+    NSBundle *bundle = [NSBundle bundleForClass:bundleClass];
+    NSData *data = [NSData dataWithContentsOfFile:[bundle pathForResource:name ofType:@"json"]];
+    NSDictionary *trace = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    NSAssert(trace, @"Could not load the trace %@", name);
+
+    return [[self alloc] initWithTrace:trace resourcePath:bundle.resourcePath];
+}
+
+- (instancetype)initWithTrace:(NSDictionary *)trace
+                 resourcePath:(NSString *)resourcePath {
+    self = [super init];
+
+    if (self) {
+        _trace = trace;
+        _resourcePath = resourcePath;
+        _deviceCount = 1;
+        _responseSpread = 1;
+        _descriptionLatency = 0.01;
+    }
+
+    return self;
+}
+
+#pragma mark - Replay
+
+- (DiscoveryBenchmarkReport *)runWithTimeout:(NSTimeInterval)timeout {
+    NSAssert([NSThread isMainThread], @"The replay must run on the main thread");
+
+    [self prepareDevices];
+    id<OHHTTPStubsDescriptor> descriptionStub = [self stubDescriptions];
+    _discoveryManager = [self createDiscoveryManager];
+
+    _foundAddresses = [NSMutableSet set];
+    _report = [DiscoveryBenchmarkReport new];
+    _report.deviceCount = self.deviceCount;
+    _report.timeToFirstDevice = -1;
+    _report.timeToAllDevices = -1;
+
+    CFRunLoopObserverRef observer = [self createMainRunLoopObserver];
+    CFRunLoopAddObserver(CFRunLoopGetMain(), observer, kCFRunLoopCommonModes);
+
+    ResourceSample before = sampleResources();
+    _startTime = CFAbsoluteTimeGetCurrent();
+    _busyStart = _startTime;
+    _busyTime = 0;
+
+    [_discoveryManager startDiscovery];
+
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (_foundAddresses.count < self.deviceCount && deadline.timeIntervalSinceNow > 0)
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:deadline];
+
+    CFAbsoluteTime endTime = CFAbsoluteTimeGetCurrent();
+    ResourceSample after = sampleResources();
+
+    // The loop above has been running since the last wake-up
+    _busyTime += endTime - _busyStart;
+
+    CFRunLoopRemoveObserver(CFRunLoopGetMain(), observer, kCFRunLoopCommonModes);
+    CFRelease(observer);
+
+    [_discoveryManager stopDiscovery];
+    [OHHTTPStubs removeStub:descriptionStub];
+
+    _report.devicesFound = _foundAddresses.count;
+    _report.CPUTime = after.CPUTime - before.CPUTime;
+    _report.allocatedBlocks = (NSInteger)after.blocksInUse - (NSInteger)before.blocksInUse;
+    _report.allocatedBytes = (NSInteger)after.bytesInUse - (NSInteger)before.bytesInUse;
+    _report.mainThreadBusyTime = _busyTime;
+    _report.mainThreadOccupancy = _busyTime / MAX(endTime - _startTime, DBL_EPSILON);
+
+    return _report;
+}
+
+/// Counts the time the main run loop spends between waking up and going back
+/// to sleep.
+- (CFRunLoopObserverRef)createMainRunLoopObserver {
+    __weak typeof(self) wself = self;
+
+    return CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault,
+                                              kCFRunLoopBeforeWaiting | kCFRunLoopAfterWaiting,
+                                              true, 0,
+                                              ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        typeof(self) sself = wself;
+        if (!sself)
+            return;
+
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+        if (activity == kCFRunLoopBeforeWaiting)
+            sself->_busyTime += now - sself->_busyStart;
+        else
+            sself->_busyStart = now;
+    });
+}
+
+- (DiscoveryManager *)createDiscoveryManager {
+    _searchSocket = [[ReplaySSDPSocket alloc] initWithAddress:kSSDPMulticastAddress andPort:0];
+    _ssdpProvider = [SSDPDiscoveryProvider new];
+    _ssdpProvider.searchSocket = _searchSocket;
+    _ssdpProvider.multicastSocket = [[ReplaySSDPSocket alloc] initWithAddress:kSSDPMulticastAddress andPort:1900];
+    _ssdpProvider.descriptionCache = [SSDPDescriptionCache new];
+    _searchSocket.delegate = _ssdpProvider;
+
+    _netServiceBrowser = [ReplayNetServiceBrowser new];
+    _zeroconfProvider = [ZeroConfDiscoveryProvider new];
+    _zeroconfProvider.netServiceBrowser = _netServiceBrowser;
+    _netServiceBrowser.delegate = _zeroconfProvider;
+
+    __weak typeof(self) wself = self;
+    _searchSocket.searchBlock = ^(NSString *address) {
+        if ([address isEqualToString:kSSDPMulticastAddress])
+            [wself replySSDPDevices];
+    };
+    _netServiceBrowser.searchBlock = ^(NSString *type) {
+        [wself announceNetServicesOfType:type];
+    };
+
+    DiscoveryManager *manager = [[DiscoveryManager alloc] initWithAppStateChangeNotifier:nil
+                                                                   networkChangeNotifier:nil];
+    manager.delegate = self;
+
+    SSDPDiscoveryProvider *ssdpProvider = _ssdpProvider;
+    ZeroConfDiscoveryProvider *zeroconfProvider = _zeroconfProvider;
+    [manager registerDeviceService:[ReplayRendererService class]
+      withDiscoveryProviderFactory:^{ return ssdpProvider; }];
+    [manager registerDeviceService:[ReplayDIALService class]
+      withDiscoveryProviderFactory:^{ return ssdpProvider; }];
+    [manager registerDeviceService:[ReplayAirPlayService class]
+      withDiscoveryProviderFactory:^{ return zeroconfProvider; }];
+
+    return manager;
+}
+
+/// Every device answers every multicast search, each at its own time.
+- (void)replySSDPDevices {
+    SSDPDiscoveryProvider *provider = _ssdpProvider;
+    ReplaySSDPSocket *socket = _searchSocket;
+
+    for (ReplaySSDPDevice *device in _ssdpDevices) {
+        NSArray *datagrams = device.datagrams;
+
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(device.delay * NSEC_PER_SEC)),
+                       socket.delegateQueue, ^{
+            [provider socket:socket didReceiveDatagrams:datagrams];
+        });
+    }
+}
+
+- (void)announceNetServicesOfType:(NSString *)type {
+    ReplayNetServiceBrowser *browser = _netServiceBrowser;
+
+    for (ReplayNetService *service in _zeroconfDevices) {
+        if ([service.type rangeOfString:type].location == NSNotFound)
+            continue;
+
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(service.announceDelay * NSEC_PER_SEC)),
+                       dispatch_get_main_queue(), ^{
+            [browser.delegate netServiceBrowser:browser didFindService:service moreComing:NO];
+        });
+    }
+}
+
+- (id<OHHTTPStubsDescriptor>)stubDescriptions {
+    NSDictionary *descriptions = _descriptions;
+    NSTimeInterval latency = self.descriptionLatency;
+
+    return [OHHTTPStubs stubRequestsPassingTest:^BOOL(NSURLRequest *request) {
+        return descriptions[request.URL.host] != nil;
+    } withStubResponse:^OHHTTPStubsResponse *(NSURLRequest *request) {
+        return [[OHHTTPStubsResponse responseWithData:descriptions[request.URL.host]
+                                           statusCode:200
+                                              headers:@{@"Content-Type": @"text/xml"}]
+                requestTime:latency responseTime:0];
+    }];
+}
+
+#pragma mark - Simulated Devices
+
+/// Builds the traffic of every simulated device from the trace.
+- (void)prepareDevices {
+    NSArray *ssdpProfiles = _trace[@"ssdp"] ?: @[];
+    NSArray *zeroconfProfiles = _trace[@"zeroconf"] ?: @[];
+    NSUInteger profileCount = ssdpProfiles.count + zeroconfProfiles.count;
+    NSAssert(profileCount > 0, @"The trace has no devices");
+
+    NSMutableArray *ssdpDevices = [NSMutableArray array];
+    NSMutableArray *zeroconfDevices = [NSMutableArray array];
+    NSMutableDictionary *descriptions = [NSMutableDictionary dictionary];
+    NSMutableDictionary *descriptionFiles = [NSMutableDictionary dictionary];
+
+    for (NSUInteger index = 0; index < self.deviceCount; ++index) {
+        NSString *address = [NSString stringWithFormat:@"10.20.%lu.%lu",
+                             (unsigned long)(index / 250), (unsigned long)(index % 250 + 2)];
+        NSDictionary *values = @{
+            @"ADDRESS": address,
+            @"UUID": [NSString stringWithFormat:@"5eb4a1d0-0000-4000-8000-%012lx", (unsigned long)index],
+            @"MAC": [NSString stringWithFormat:@"%02lX:%02lX:%02lX:00:00:02",
+                     (unsigned long)(index & 0xff), (unsigned long)((index >> 8) & 0xff), (unsigned long)((index >> 16) & 0xff)],
+            @"INDEX": @(index).stringValue,
+        };
+
+        NSUInteger profileIndex = index % profileCount;
+        NSTimeInterval spread = self.responseSpread * index / self.deviceCount;
+
+        if (profileIndex < ssdpProfiles.count) {
+            NSDictionary *profile = ssdpProfiles[profileIndex];
+            NSMutableArray *datagrams = [NSMutableArray array];
+
+            for (NSArray *lines in profile[@"packets"]) {
+                NSString *packet = [[lines componentsJoinedByString:@"\r\n"] stringByAppendingString:@"\r\n\r\n"];
+                NSData *data = [fillPlaceholders(packet, values) dataUsingEncoding:NSUTF8StringEncoding];
+                [datagrams addObject:[[SSDPDatagram alloc] initWithData:data address:address]];
+            }
+
+            ReplaySSDPDevice *device = [ReplaySSDPDevice new];
+            device.datagrams = datagrams;
+            device.delay = [profile[@"delay"] doubleValue] + spread;
+            [ssdpDevices addObject:device];
+
+            NSString *file = profile[@"description"];
+            if (file && !descriptionFiles[file])
+                descriptionFiles[file] = [NSData dataWithContentsOfFile:[_resourcePath stringByAppendingPathComponent:file]];
+
+            [descriptions setNullableObject:descriptionFiles[file] forKey:address];
+        } else {
+            NSDictionary *profile = zeroconfProfiles[profileIndex - ssdpProfiles.count];
+            NSString *name = fillPlaceholders(profile[@"name"], values);
+            NSString *TXTRecord = fillPlaceholders(profile[@"txt"] ?: @"", values);
+            in_port_t port = (in_port_t)[profile[@"port"] unsignedIntegerValue];
+
+            ReplayNetService *service = [[ReplayNetService alloc] initWithDomain:@"local."
+                                                                            type:profile[@"type"]
+                                                                            name:name
+                                                                            port:port];
+            service.replayAddresses = @[IPv4AddressData(address, port)];
+            service.replayTXTRecordData = [TXTRecord dataUsingEncoding:NSUTF8StringEncoding];
+            service.announceDelay = [profile[@"delay"] doubleValue] + spread;
+            service.resolveDelay = [profile[@"resolveDelay"] doubleValue];
+            [zeroconfDevices addObject:service];
+        }
+    }
+
+    _ssdpDevices = ssdpDevices;
+    _zeroconfDevices = zeroconfDevices;
+    _descriptions = descriptions;
+}
+
+#pragma mark - DiscoveryManagerDelegate
+
+- (void)discoveryManager:(DiscoveryManager *)manager didFindDevice:(ConnectableDevice *)device {
+    NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - _startTime;
+
+    if (_foundAddresses.count == 0)
+        _report.timeToFirstDevice = elapsed;
+
+    [_foundAddresses addObject:device.address];
+
+    if (_foundAddresses.count == self.deviceCount && _report.timeToAllDevices < 0)
+        _report.timeToAllDevices = elapsed;
+}
+
+@end
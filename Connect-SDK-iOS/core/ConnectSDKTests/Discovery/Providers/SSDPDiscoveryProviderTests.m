@@ -22,6 +22,7 @@
 #import <OHHTTPStubs/OHHTTPStubs.h>
 
 #import "SSDPDiscoveryProvider_Private.h"
+#import "SSDPDescriptionCache.h"
 #import "SSDPSocketListener.h"
 #import "ServiceDescription.h"
 
@@ -55,6 +56,7 @@ static inline NSString *httpHeaderValue(CFHTTPMessageRef msg, NSString *header)
     [super setUp];
 
     self.provider = [SSDPDiscoveryProvider new];
+    self.provider.descriptionCache = [[SSDPDescriptionCache alloc] initWithPath:nil];
 }
 
 - (void)tearDown {
@@ -157,6 +159,37 @@ static inline NSString *httpHeaderValue(CFHTTPMessageRef msg, NSString *header)
                                  andPort:kSSDPMulticastTCPPort]);
 }
 
+/// Tests that probing an address sends a unicast M-SEARCH to it, addressed
+/// to the device and without MX.
+- (void)testProbeAddressesShouldSendUnicastSearchRequest {
+    id searchSocketMock = OCMClassMock([SSDPSocketListener class]);
+    self.provider.searchSocket = searchSocketMock;
+
+    NSDictionary *filter = @{kKeySSDP: @{kKeyFilter: @"some:thing"}};
+    [self.provider addDeviceFilter:filter];
+
+    [self.provider probeAddresses:@[@"10.0.0.2"]];
+
+    BOOL (^httpDataVerificationBlock)(id obj) = ^BOOL(NSData *data) {
+        CFHTTPMessageRef msg = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, YES);
+        XCTAssertTrue(CFHTTPMessageAppendBytes(msg, data.bytes, data.length),
+                      @"Couldn't parse the HTTP request");
+
+        XCTAssertEqualObjects(httpHeaderValue(msg, @"HOST"), @"10.0.0.2:1900");
+        XCTAssertEqualObjects(httpHeaderValue(msg, @"ST"), @"some:thing");
+        XCTAssertNil(httpHeaderValue(msg, @"MX"), @"A unicast search must not have MX");
+
+        CFRelease(msg);
+        return YES;
+    };
+
+    OCMVerify([searchSocketMock sendData:[OCMArg checkWithBlock:httpDataVerificationBlock]
+                               toAddress:@"10.0.0.2"
+                                 andPort:kSSDPMulticastTCPPort]);
+
+    [self.provider stopDiscovery];
+}
+
 /// Tests that the delegate's -discoveryProvider:didFindService: method is
 /// called with the correct service description after receiving a search
 /// response. The test uses the `ssdp_device_description.xml` file for mocked
@@ -356,4 +389,243 @@ static inline NSString *httpHeaderValue(CFHTTPMessageRef msg, NSString *header)
                                  }];
 }
 
+#pragma mark - Description Cache tests
+
+/// Tests that a device whose description is already cached is found without
+/// downloading the description again.
+- (void)testCachedDeviceShouldBeFoundWithoutDownloadingDescription {
+    // Arrange
+    id delegateMock = OCMProtocolMock(@protocol(DiscoveryProviderDelegate));
+    self.provider.delegate = delegateMock;
+
+    id searchSocketMock = OCMClassMock([SSDPSocketListener class]);
+    self.provider.searchSocket = searchSocketMock;
+
+    NSString *serviceType = @"urn:schemas-upnp-org:device:thing:1";
+    [self.provider addDeviceFilter:@{kKeySSDP: @{kKeyFilter: serviceType},
+                                     kKeyServiceID: @"SomethingNew"}];
+
+    NSString *kDeviceDescriptionURL = @"http://127.0.1.2:7676/root";
+    NSString *kUUID = @"f21e800a-1000-ab08-8e5a-76f4fcb5e772";
+
+    [self.provider.descriptionCache setEntry:[self descriptionCacheEntryForLocation:kDeviceDescriptionURL]
+                                     forUUID:kUUID];
+    [self stubSearchSocket:searchSocketMock
+        withResponseForType:serviceType
+                   location:kDeviceDescriptionURL
+                       UUID:kUUID];
+
+    __block NSUInteger requestCount = 0;
+    [OHHTTPStubs stubRequestsPassingTest:^BOOL(NSURLRequest *request) {
+        ++requestCount;
+        return NO;
+    } withStubResponse:^OHHTTPStubsResponse *(NSURLRequest *request) {
+        return nil;
+    }];
+
+    XCTestExpectation *didFindServiceExpectation = [self expectationWithDescription:@"Did find service"];
+    OCMExpect([delegateMock discoveryProvider:self.provider
+                               didFindService:[OCMArg checkWithBlock:^BOOL(ServiceDescription *service) {
+        XCTAssertEqualObjects(service.friendlyName, @"short user-friendly title", @"The friendly name is incorrect");
+        XCTAssertEqualObjects(service.commandURL.absoluteString, kDeviceDescriptionURL, @"The command URL is incorrect");
+        XCTAssertEqual(service.serviceList.count, 1, @"The service count is incorrect");
+
+        [didFindServiceExpectation fulfill];
+        return YES;
+    }]]);
+
+    // Act
+    [self.provider startDiscovery];
+
+    // Assert
+    [self waitForExpectationsWithTimeout:kDefaultAsyncTestTimeout
+                                 handler:^(NSError *error) {
+                                     XCTAssertNil(error, @"Test timeout");
+                                     OCMVerifyAll(delegateMock);
+                                 }];
+    XCTAssertEqual(requestCount, 0, @"The description should not be requested");
+}
+
+/// Tests that an expired cache entry is revalidated with its ETag, and that a
+/// 304 response is enough to find the device.
+- (void)testExpiredCacheEntryShouldBeRevalidatedWithETag {
+    // Arrange
+    id delegateMock = OCMProtocolMock(@protocol(DiscoveryProviderDelegate));
+    self.provider.delegate = delegateMock;
+
+    id searchSocketMock = OCMClassMock([SSDPSocketListener class]);
+    self.provider.searchSocket = searchSocketMock;
+
+    NSString *serviceType = @"urn:schemas-upnp-org:device:thing:1";
+    [self.provider addDeviceFilter:@{kKeySSDP: @{kKeyFilter: serviceType},
+                                     kKeyServiceID: @"SomethingNew"}];
+
+    NSString *kDeviceDescriptionURL = @"http://127.0.1.2:7676/root";
+    NSString *kUUID = @"f21e800a-1000-ab08-8e5a-76f4fcb5e772";
+    NSString *kETag = @"\"description-1\"";
+
+    SSDPDescriptionCacheEntry *entry = [self descriptionCacheEntryForLocation:kDeviceDescriptionURL];
+    entry.eTag = kETag;
+    entry.validated = 0;
+    [self.provider.descriptionCache setEntry:entry forUUID:kUUID];
+
+    [self stubSearchSocket:searchSocketMock
+        withResponseForType:serviceType
+                   location:kDeviceDescriptionURL
+                       UUID:kUUID];
+
+    __block NSString *sentETag;
+    [OHHTTPStubs stubRequestsPassingTest:^BOOL(NSURLRequest *request) {
+        return [kDeviceDescriptionURL isEqualToString:request.URL.absoluteString];
+    } withStubResponse:^OHHTTPStubsResponse *(NSURLRequest *request) {
+        sentETag = [request valueForHTTPHeaderField:@"If-None-Match"];
+        return [OHHTTPStubsResponse responseWithData:[NSData data]
+                                          statusCode:304
+                                             headers:nil];
+    }];
+
+    XCTestExpectation *didFindServiceExpectation = [self expectationWithDescription:@"Did find service"];
+    OCMExpect([delegateMock discoveryProvider:self.provider
+                               didFindService:[OCMArg checkWithBlock:^BOOL(ServiceDescription *service) {
+        XCTAssertEqualObjects(service.friendlyName, @"short user-friendly title", @"The friendly name is incorrect");
+
+        [didFindServiceExpectation fulfill];
+        return YES;
+    }]]);
+
+    // Act
+    [self.provider startDiscovery];
+
+    // Assert
+    [self waitForExpectationsWithTimeout:kDefaultAsyncTestTimeout
+                                 handler:^(NSError *error) {
+                                     XCTAssertNil(error, @"Test timeout");
+                                     OCMVerifyAll(delegateMock);
+                                 }];
+    XCTAssertEqualObjects(sentETag, kETag, @"The cached ETag should be sent");
+    XCTAssertGreaterThan(entry.validated, 0, @"The entry should be marked as revalidated");
+}
+
+/// Tests that an error page served in place of a description isn't cached,
+/// so the device is tried again the next time it's seen.
+- (void)testErrorResponseShouldNotBeCached {
+    NSString *kDeviceDescriptionURL = @"http://127.0.1.2:7676/root";
+    NSString *kUUID = @"f21e800a-1000-ab08-8e5a-76f4fcb5e772";
+
+    [self checkDescriptionResponseWithStatusCode:500
+                                            body:@"<html><body>Internal Server Error</body></html>"
+                                     cachedEntry:nil
+                                        location:kDeviceDescriptionURL
+                                            UUID:kUUID];
+
+    XCTAssertNil([self.provider.descriptionCache entryForUUID:kUUID location:kDeviceDescriptionURL configId:nil]);
+}
+
+/// Tests that an expired entry is dropped when the new description can't be
+/// parsed, rather than being kept or replaced by the broken one.
+- (void)testUnparseableDescriptionShouldEvictCacheEntry {
+    NSString *kDeviceDescriptionURL = @"http://127.0.1.2:7676/root";
+    NSString *kUUID = @"f21e800a-1000-ab08-8e5a-76f4fcb5e772";
+
+    SSDPDescriptionCacheEntry *entry = [self descriptionCacheEntryForLocation:kDeviceDescriptionURL];
+    entry.validated = 0;
+
+    [self checkDescriptionResponseWithStatusCode:200
+                                            body:@"<root><device>"
+                                     cachedEntry:entry
+                                        location:kDeviceDescriptionURL
+                                            UUID:kUUID];
+
+    XCTAssertNil([self.provider.descriptionCache entryForUUID:kUUID location:kDeviceDescriptionURL configId:nil]);
+}
+
+#pragma mark - Helpers
+
+/// Runs discovery against a device whose description request gets the given
+/// response, and checks that the device isn't announced.
+- (void)checkDescriptionResponseWithStatusCode:(int)statusCode
+                                          body:(NSString *)body
+                                   cachedEntry:(SSDPDescriptionCacheEntry *)entry
+                                      location:(NSString *)location
+                                          UUID:(NSString *)UUID {
+    id delegateMock = OCMProtocolMock(@protocol(DiscoveryProviderDelegate));
+    [[delegateMock reject] discoveryProvider:OCMOCK_ANY didFindService:OCMOCK_ANY];
+    self.provider.delegate = delegateMock;
+
+    id searchSocketMock = OCMClassMock([SSDPSocketListener class]);
+    self.provider.searchSocket = searchSocketMock;
+
+    NSString *serviceType = @"urn:schemas-upnp-org:device:thing:1";
+    [self.provider addDeviceFilter:@{kKeySSDP: @{kKeyFilter: serviceType},
+                                     kKeyServiceID: @"SomethingNew"}];
+
+    if (entry) {
+        [self.provider.descriptionCache setEntry:entry forUUID:UUID];
+    }
+
+    [self stubSearchSocket:searchSocketMock
+        withResponseForType:serviceType
+                   location:location
+                       UUID:UUID];
+
+    XCTestExpectation *requestedExpectation = [self expectationWithDescription:@"Description requested"];
+    [OHHTTPStubs stubRequestsPassingTest:^BOOL(NSURLRequest *request) {
+        return [location isEqualToString:request.URL.absoluteString];
+    } withStubResponse:^OHHTTPStubsResponse *(NSURLRequest *request) {
+        [requestedExpectation fulfill];
+        return [OHHTTPStubsResponse responseWithData:[body dataUsingEncoding:NSUTF8StringEncoding]
+                                          statusCode:statusCode
+                                             headers:nil];
+    }];
+
+    [self.provider startDiscovery];
+
+    [self waitForExpectationsWithTimeout:kDefaultAsyncTestTimeout
+                                 handler:^(NSError *error) {
+                                     XCTAssertNil(error, @"Test timeout");
+                                 }];
+
+    // Let the response be handled
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    [self.provider stopDiscovery];
+    OCMVerifyAll(delegateMock);
+}
+
+/// Makes the mocked search socket answer every search with a response for the
+/// given device.
+- (void)stubSearchSocket:(id)searchSocketMock
+     withResponseForType:(NSString *)serviceType
+                location:(NSString *)location
+                    UUID:(NSString *)UUID {
+    OCMStub([searchSocketMock sendData:[OCMArg isNotNil]
+                             toAddress:kSSDPMulticastIPAddress
+                               andPort:kSSDPMulticastTCPPort]).andDo((^(NSInvocation *invocation) {
+        NSString *searchResponse = [NSString stringWithFormat:
+                                    @"HTTP/1.1 200 OK\r\n"
+                                    @"CACHE-CONTROL: max-age=1800\r\n"
+                                    @"LOCATION: %@\r\n"
+                                    @"ST: %@\r\n"
+                                    @"USN: uuid:%@::%@\r\n"
+                                    @"\r\n",
+                                    location, serviceType, UUID, serviceType];
+
+        [self.provider socket:searchSocketMock
+               didReceiveData:[searchResponse dataUsingEncoding:NSUTF8StringEncoding]
+                  fromAddress:@"127.0.1.2"];
+    }));
+}
+
+/// Returns a fresh cache entry holding `ssdp_device_description.xml`.
+- (SSDPDescriptionCacheEntry *)descriptionCacheEntryForLocation:(NSString *)location {
+    NSData *data = [NSData dataWithContentsOfFile:OHPathForFileInBundle(@"ssdp_device_description.xml", nil)];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:location]
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:nil];
+
+    return [[SSDPDescriptionCacheEntry alloc] initWithLocation:location
+                                                      response:response
+                                                          data:data];
+}
+
 @end
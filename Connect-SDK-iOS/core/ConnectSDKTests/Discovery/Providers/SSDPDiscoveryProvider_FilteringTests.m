@@ -21,6 +21,7 @@
 #import <OHHTTPStubs/OHHTTPStubs.h>
 
 #import "SSDPDiscoveryProvider_Private.h"
+#import "SSDPDescriptionCache.h"
 #import "SSDPSocketListener.h"
 
 #import "DIALService.h"
@@ -195,6 +196,7 @@ static const NSUInteger kSSDPMulticastTCPPort = 1900;
       usingDiscoveryProviders:(NSArray *)discoveryProviders {
     // Arrange
     SSDPDiscoveryProvider *provider = [SSDPDiscoveryProvider new];
+    provider.descriptionCache = [[SSDPDescriptionCache alloc] initWithPath:nil];
     [discoveryProviders enumerateObjectsUsingBlock:^(Class class, NSUInteger idx, BOOL *stop) {
         [provider addDeviceFilter:[class discoveryParameters]];
     }];
@@ -0,0 +1,167 @@
+//
+//  SSDPSearchPlannerTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPSearchPlanner.h"
+
+#import "DIALService.h"
+#import "DLNAService.h"
+#import "NetcastTVService.h"
+#import "RokuService.h"
+#import "WebOSTVService.h"
+
+static NSDictionary *filterFor(NSString *target, NSString *token) {
+    NSMutableDictionary *ssdp = [NSMutableDictionary dictionaryWithObject:target forKey:@"filter"];
+    if (token) {
+        ssdp[@"userAgentToken"] = token;
+    }
+    return @{@"ssdp": ssdp};
+}
+
+@interface SSDPSearchPlannerTests : XCTestCase
+
+@property (nonatomic, strong) SSDPSearchPlanner *planner;
+
+@end
+
+@implementation SSDPSearchPlannerTests
+
+#pragma mark - Setup
+
+- (void)setUp {
+    [super setUp];
+    self.planner = [SSDPSearchPlanner new];
+}
+
+- (void)tearDown {
+    self.planner = nil;
+    [super tearDown];
+}
+
+#pragma mark - Planning Tests
+
+- (void)testSingleFilterShouldBeSearchedForDirectly {
+    NSArray *searches = [self.planner searchesForFilters:@[filterFor(@"roku:ecp", nil)]];
+
+    XCTAssertEqualObjects(searches, @[[[SSDPSearch alloc] initWithTarget:@"roku:ecp" userAgentTokens:nil]]);
+}
+
+- (void)testFiltersWithSameTargetShouldShareOneSearch {
+    NSArray *filters = @[filterFor(@"urn:schemas-upnp-org:device:MediaRenderer:1", nil),
+                         filterFor(@"urn:schemas-upnp-org:device:MediaRenderer:1", @"UDAP/2.0")];
+    NSArray *searches = [self.planner searchesForFilters:filters];
+
+    XCTAssertEqual(searches.count, 1u);
+    XCTAssertEqualObjects([searches.firstObject target], @"urn:schemas-upnp-org:device:MediaRenderer:1");
+    XCTAssertEqualObjects([searches.firstObject userAgentTokens], @[@"UDAP/2.0"],
+                          @"The merged search should keep every filter's user agent token");
+}
+
+- (void)testManyTargetsShouldBeMergedIntoSearchAll {
+    self.planner.maxTargets = 2;
+    NSArray *filters = @[filterFor(@"a:1", nil), filterFor(@"b:1", @"B/1.0"), filterFor(@"c:1", nil)];
+    NSArray *searches = [self.planner searchesForFilters:filters];
+
+    XCTAssertEqualObjects(searches, @[[[SSDPSearch alloc] initWithTarget:kSSDPSearchTargetAll
+                                                         userAgentTokens:@[@"B/1.0"]]]);
+}
+
+- (void)testServicesSharingATargetShouldShareOneSearch {
+    // The provider set used by the SSDP filtering tests
+    NSArray *filters = @[[NetcastTVService discoveryParameters], [DLNAService discoveryParameters]];
+    NSArray *searches = [self.planner searchesForFilters:filters];
+
+    XCTAssertEqual(searches.count, 1u);
+    XCTAssertEqualObjects([searches.firstObject target], @"urn:schemas-upnp-org:device:MediaRenderer:1");
+}
+
+- (void)testBuiltInServicesShouldNotSearchAllByDefault {
+    NSArray *searches = [self.planner searchesForFilters:[self builtInServiceFilters]];
+
+    XCTAssertEqual(searches.count, 4u, @"Five services should need one search per distinct target");
+    for (SSDPSearch *search in searches) {
+        XCTAssertNotEqualObjects(search.target, kSSDPSearchTargetAll);
+    }
+}
+
+- (void)testBuiltInServicesShouldNeedOneSearchWhenLimited {
+    self.planner.maxTargets = 3;
+    NSArray *searches = [self.planner searchesForFilters:[self builtInServiceFilters]];
+
+    XCTAssertEqual(searches.count, 1u);
+    XCTAssertEqualObjects([searches.firstObject target], kSSDPSearchTargetAll);
+}
+
+#pragma mark - Scheduling Tests
+
+- (void)testRepeatsShouldBeSpreadOverHalfTheMXWindow {
+    self.planner.mx = 4;
+    self.planner.transmissions = 3;
+
+    for (NSUInteger attempt = 0; attempt < 20; ++attempt) {
+        NSArray *delays = [self.planner sendDelaysForSearchAtIndex:0];
+
+        XCTAssertEqual(delays.count, 3u);
+        XCTAssertEqualObjects(delays[0], @0, @"The first packet should go out straight away");
+
+        for (NSUInteger i = 1; i < delays.count; ++i) {
+            XCTAssertGreaterThan([delays[i] doubleValue], [delays[i - 1] doubleValue]);
+            XCTAssertLessThan([delays[i] doubleValue], 2.0 + 0.26);
+        }
+    }
+}
+
+- (void)testSearchesInOneRoundShouldBeStaggered {
+    NSArray *first = [self.planner sendDelaysForSearchAtIndex:0];
+    NSArray *second = [self.planner sendDelaysForSearchAtIndex:1];
+
+    XCTAssertGreaterThan([second[0] doubleValue], [first[0] doubleValue]);
+}
+
+#pragma mark - Statistics Tests
+
+- (void)testStatisticsShouldCountPacketsAndResponses {
+    [self.planner recordPacketSent];
+    [self.planner recordPacketSent];
+    [self.planner recordResponseMatchingFilter:YES];
+    [self.planner recordResponseMatchingFilter:NO];
+    [self.planner recordResponseMatchingFilter:NO];
+
+    XCTAssertEqual(self.planner.packetsSent, 2u);
+    XCTAssertEqual(self.planner.responsesReceived, 3u);
+    XCTAssertEqual(self.planner.matchingResponsesReceived, 1u);
+
+    [self.planner resetStatistics];
+    XCTAssertEqual(self.planner.packetsSent, 0u);
+    XCTAssertEqual(self.planner.responsesReceived, 0u);
+}
+
+#pragma mark - Helpers
+
+- (NSArray *)builtInServiceFilters {
+    NSArray *services = @[[DIALService class], [DLNAService class], [NetcastTVService class],
+                          [RokuService class], [WebOSTVService class]];
+    NSMutableArray *filters = [NSMutableArray array];
+    for (Class service in services) {
+        [filters addObject:[service discoveryParameters]];
+    }
+    return filters;
+}
+
+@end
@@ -0,0 +1,143 @@
+//
+//  CapabilitySetTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CapabilitySet.h"
+#import "ConnectableDevice_Private.h"
+#import "DeviceService.h"
+
+@interface CapabilitySetTests : XCTestCase
+
+@end
+
+@implementation CapabilitySetTests
+
+#pragma mark - CapabilitySet Tests
+
+- (void)testSetShouldKeepCapabilitiesOnce {
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:@[@"Test.One", @"Test.Two", @"Test.One"]];
+    XCTAssertEqualObjects([NSSet setWithArray:set.capabilities],
+                          ([NSSet setWithObjects:@"Test.One", @"Test.Two", nil]));
+    XCTAssertEqual(set.capabilities.count, 2u);
+}
+
+- (void)testContainsAndIntersects {
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:@[@"Test.A", @"Test.B"]];
+    CapabilitySet *subset = [CapabilitySet setWithCapabilities:@[@"Test.B"]];
+    CapabilitySet *other = [CapabilitySet setWithCapabilities:@[@"Test.B", @"Test.C"]];
+
+    XCTAssertTrue([set containsSet:subset]);
+    XCTAssertTrue([set containsSet:[CapabilitySet emptySet]]);
+    XCTAssertFalse([set containsSet:other]);
+    XCTAssertTrue([set intersectsSet:other]);
+    XCTAssertFalse([subset intersectsSet:[CapabilitySet setWithCapabilities:@[@"Test.C"]]]);
+}
+
+- (void)testAddingAndSubtractingSets {
+    CapabilitySet *first = [CapabilitySet setWithCapabilities:@[@"Test.A", @"Test.B"]];
+    CapabilitySet *second = [CapabilitySet setWithCapabilities:@[@"Test.B", @"Test.C"]];
+
+    XCTAssertEqualObjects([first setByAddingSet:second],
+                          ([CapabilitySet setWithCapabilities:@[@"Test.A", @"Test.B", @"Test.C"]]));
+    XCTAssertEqualObjects([first setBySubtractingSet:second].capabilities, @[@"Test.A"]);
+    XCTAssertEqualObjects([first setBySubtractingSet:first], [CapabilitySet emptySet]);
+}
+
+- (void)testSetsShouldSpanSeveralWords {
+    NSMutableArray *capabilities = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 200; ++i)
+        [capabilities addObject:[NSString stringWithFormat:@"Test.Many.%lu", (unsigned long)i]];
+
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:capabilities];
+    CapabilitySet *last = [CapabilitySet setWithCapabilities:@[capabilities.lastObject]];
+
+    XCTAssertEqual(set.capabilities.count, 200u);
+    XCTAssertTrue([set containsSet:last]);
+    XCTAssertFalse([last containsSet:set]);
+}
+
+#pragma mark - CapabilityRequirement Tests
+
+- (void)testRequirementShouldNeedEveryCapability {
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:@[@"Test.Play", @"Test.Pause"]];
+
+    XCTAssertTrue([[CapabilityRequirement requirementWithCapabilities:@[@"Test.Play"]] isSatisfiedBySet:set]);
+    XCTAssertFalse([[CapabilityRequirement requirementWithCapabilities:@[@"Test.Play", @"Test.Stop"]] isSatisfiedBySet:set]);
+    XCTAssertTrue([[CapabilityRequirement requirementWithCapabilities:@[]] isSatisfiedBySet:set],
+                  @"an empty requirement should be satisfied, like hasCapabilities:");
+}
+
+- (void)testPartialRequirementShouldNeedOneCapability {
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:@[@"Test.Play"]];
+
+    XCTAssertTrue([[CapabilityRequirement requirementWithCapabilities:@[@"Test.Stop", @"Test.Play"]] isPartlySatisfiedBySet:set]);
+    XCTAssertFalse([[CapabilityRequirement requirementWithCapabilities:@[@"Test.Stop"]] isPartlySatisfiedBySet:set]);
+    XCTAssertFalse([[CapabilityRequirement requirementWithCapabilities:@[]] isPartlySatisfiedBySet:set]);
+}
+
+- (void)testWildcardShouldMatchCapabilitiesContainingTerm {
+    CapabilityRequirement *requirement = [CapabilityRequirement requirementWithCapabilities:@[@"WildcardTest.Control.Any"]];
+
+    XCTAssertFalse([requirement isSatisfiedBySet:[CapabilitySet setWithCapabilities:@[@"WildcardTest.Player"]]]);
+
+    // The names are first seen after the requirement was created
+    CapabilitySet *set = [CapabilitySet setWithCapabilities:@[@"WildcardTest.Control.Rewind"]];
+    XCTAssertTrue([requirement isSatisfiedBySet:set]);
+    XCTAssertTrue([requirement isPartlySatisfiedBySet:set]);
+}
+
+- (void)testSharedRequirementShouldBeReusedForEqualLists {
+    NSArray *capabilities = @[@"SharedTest.Play", @"SharedTest.Control.Any"];
+    CapabilityRequirement *requirement = [CapabilityRequirement sharedRequirementWithCapabilities:capabilities];
+
+    XCTAssertEqual([CapabilityRequirement sharedRequirementWithCapabilities:[capabilities mutableCopy]], requirement);
+    XCTAssertNotEqual([CapabilityRequirement sharedRequirementWithCapabilities:@[@"SharedTest.Play"]], requirement);
+    XCTAssertEqualObjects(requirement.capabilities, capabilities);
+}
+
+#pragma mark - ConnectableDevice Tests
+
+- (void)testDeviceShouldSeeServiceCapabilityChanges {
+    ServiceDescription *description = [ServiceDescription descriptionWithAddress:@"10.0.0.2" UUID:@"capability-test"];
+    description.serviceId = @"CapabilityTestService";
+
+    // Keep the notifications away from the shared DiscoveryManager
+    __attribute__((objc_precise_lifetime)) id serviceDelegate = OCMProtocolMock(@protocol(DeviceServiceDelegate));
+    DeviceService *service = [DeviceService new];
+    service.serviceDescription = description;
+    service.delegate = serviceDelegate;
+    [service setCapabilities:@[@"DeviceTest.Play"]];
+
+    ConnectableDevice *device = [ConnectableDevice connectableDeviceWithDescription:description];
+    XCTAssertFalse([device hasCapability:@"DeviceTest.Play"]);
+
+    [device addService:service];
+    XCTAssertTrue([device hasCapability:@"DeviceTest.Play"]);
+    XCTAssertTrue([device hasCapability:@"DeviceTest.Any"]);
+
+    [service addCapability:@"DeviceTest.Pause"];
+    XCTAssertTrue([device hasCapabilities:@[@"DeviceTest.Play", @"DeviceTest.Pause"]],
+                  @"the device should notice a service's capabilities changing");
+
+    [device removeServiceWithId:@"CapabilityTestService"];
+    XCTAssertFalse([device hasAnyCapability:@[@"DeviceTest.Play", @"DeviceTest.Pause"]]);
+    XCTAssertEqualObjects(device.capabilities, @[]);
+}
+
+@end
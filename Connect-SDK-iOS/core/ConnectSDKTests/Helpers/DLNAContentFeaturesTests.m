@@ -0,0 +1,51 @@
+//
+//  DLNAContentFeaturesTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DLNAContentFeatures.h"
+
+@interface DLNAContentFeaturesTests : XCTestCase
+
+@end
+
+@implementation DLNAContentFeaturesTests
+
+- (void)testVideoShouldBeSeekableAndStreamedWithoutProfile {
+    XCTAssertEqualObjects(DLNAContentFeatures(@"video/mp4"),
+                          @"DLNA.ORG_OP=01;DLNA.ORG_CI=0;DLNA.ORG_FLAGS=01700000000000000000000000000000");
+    XCTAssertEqualObjects(DLNATransferMode(@"video/mp4"), @"Streaming");
+}
+
+- (void)testMP3ShouldHaveItsProfile {
+    XCTAssertTrue([DLNAContentFeatures(@"audio/mpeg") hasPrefix:@"DLNA.ORG_PN=MP3;DLNA.ORG_OP=01;"]);
+    XCTAssertEqual([DLNAContentFeatures(@"audio/mp4") rangeOfString:@"DLNA.ORG_PN"].location, (NSUInteger)NSNotFound);
+}
+
+- (void)testImageShouldBeInteractive {
+    XCTAssertEqualObjects(DLNAContentFeatures(@"image/jpeg"),
+                          @"DLNA.ORG_CI=0;DLNA.ORG_FLAGS=00D00000000000000000000000000000");
+    XCTAssertEqualObjects(DLNATransferMode(@"image/jpeg"), @"Interactive");
+}
+
+- (void)testProtocolInfoShouldIncludeMimeTypeAndFeatures {
+    XCTAssertEqualObjects(DLNAProtocolInfo(@"video/mp4"),
+                          @"http-get:*:video/mp4:DLNA.ORG_OP=01;DLNA.ORG_CI=0;DLNA.ORG_FLAGS=01700000000000000000000000000000");
+}
+
+@end
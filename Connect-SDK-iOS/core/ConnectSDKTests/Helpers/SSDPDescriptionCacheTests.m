@@ -0,0 +1,143 @@
+//
+//  SSDPDescriptionCacheTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPDescriptionCache.h"
+
+static NSString *const kUUID = @"f21e800a-1000-ab08-8e5a-76f4fcb5e772";
+static NSString *const kLocation = @"http://192.168.1.20:1719/description.xml";
+
+@interface SSDPDescriptionCacheTests : XCTestCase
+
+@property (nonatomic, strong) SSDPDescriptionCache *cache;
+
+@end
+
+@implementation SSDPDescriptionCacheTests
+
+#pragma mark - Setup
+
+- (void)setUp {
+    [super setUp];
+    self.cache = [[SSDPDescriptionCache alloc] initWithPath:nil];
+}
+
+- (void)tearDown {
+    self.cache = nil;
+    [super tearDown];
+}
+
+#pragma mark - Lookup Tests
+
+- (void)testEntryShouldBeFoundForSameLocationAndConfiguration {
+    [self.cache setEntry:[self entryWithBootId:@"1" configId:@"7"] forUUID:kUUID];
+
+    XCTAssertNotNil([self.cache entryForUUID:kUUID location:kLocation configId:@"7"]);
+    XCTAssertNotNil([self.cache entryForUUID:kUUID location:kLocation configId:nil],
+                    @"A device that doesn't send CONFIGID should still use the entry");
+}
+
+- (void)testEntryShouldNotBeFoundForDifferentLocation {
+    [self.cache setEntry:[self entryWithBootId:nil configId:nil] forUUID:kUUID];
+
+    XCTAssertNil([self.cache entryForUUID:kUUID location:@"http://192.168.1.21:1719/description.xml" configId:nil]);
+}
+
+- (void)testEntryShouldNotBeFoundForDifferentConfiguration {
+    [self.cache setEntry:[self entryWithBootId:nil configId:@"7"] forUUID:kUUID];
+
+    XCTAssertNil([self.cache entryForUUID:kUUID location:kLocation configId:@"8"]);
+}
+
+- (void)testEntryShouldNeedRevalidationAfterReboot {
+    SSDPDescriptionCacheEntry *entry = [self entryWithBootId:@"1" configId:nil];
+
+    XCTAssertFalse([self.cache entryNeedsRevalidation:entry bootId:@"1"]);
+    XCTAssertFalse([self.cache entryNeedsRevalidation:entry bootId:nil]);
+    XCTAssertTrue([self.cache entryNeedsRevalidation:entry bootId:@"2"]);
+}
+
+- (void)testEntryShouldNeedRevalidationWhenExpired {
+    SSDPDescriptionCacheEntry *entry = [self entryWithBootId:nil configId:nil];
+    entry.validated = [[NSDate date] timeIntervalSince1970] - self.cache.maxAge - 1;
+
+    XCTAssertTrue([self.cache entryNeedsRevalidation:entry bootId:nil]);
+}
+
+- (void)testOldestEntryShouldBeDroppedOverCapacity {
+    self.cache.capacity = 2;
+
+    for (NSUInteger i = 0; i < 3; ++i) {
+        SSDPDescriptionCacheEntry *entry = [self entryWithBootId:nil configId:nil];
+        entry.validated = 1000 + i;
+        [self.cache setEntry:entry forUUID:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+    }
+
+    XCTAssertNil([self.cache entryForUUID:@"0" location:kLocation configId:nil]);
+    XCTAssertNotNil([self.cache entryForUUID:@"1" location:kLocation configId:nil]);
+    XCTAssertNotNil([self.cache entryForUUID:@"2" location:kLocation configId:nil]);
+}
+
+#pragma mark - Entry Tests
+
+- (void)testEntryShouldReadValidatorsFromResponse {
+    SSDPDescriptionCacheEntry *entry = [self entryWithBootId:nil configId:nil];
+
+    XCTAssertEqualObjects(entry.eTag, @"\"abc\"");
+    XCTAssertEqualObjects(entry.lastModified, @"Thu, 01 Jan 2026 00:00:00 GMT");
+    XCTAssertEqualObjects(entry.locationXML, @"<root/>");
+    XCTAssertEqualObjects(entry.commandURL.absoluteString, kLocation);
+}
+
+- (void)testEntryShouldSurviveJSONRoundTrip {
+    SSDPDescriptionCacheEntry *entry = [self entryWithBootId:@"1" configId:@"7"];
+    [entry setDescription:@{@"friendlyName": @"TV"} forType:@"urn:dial-multiscreen-org:service:dial:1"];
+
+    SSDPDescriptionCacheEntry *restored = [[SSDPDescriptionCacheEntry alloc] initWithJSONObject:[entry toJSONObject]];
+
+    XCTAssertEqualObjects(restored.location, entry.location);
+    XCTAssertEqualObjects(restored.bootId, @"1");
+    XCTAssertEqualObjects(restored.configId, @"7");
+    XCTAssertEqualObjects(restored.eTag, entry.eTag);
+    XCTAssertEqualObjects(restored.lastModified, entry.lastModified);
+    XCTAssertEqualObjects(restored.locationXML, entry.locationXML);
+    XCTAssertEqualObjects(restored.commandURL, entry.commandURL);
+    XCTAssertEqualObjects(restored.responseHeaders, entry.responseHeaders);
+    XCTAssertEqual(restored.validated, entry.validated);
+    XCTAssertEqualObjects([restored descriptionForType:@"urn:dial-multiscreen-org:service:dial:1"], @{@"friendlyName": @"TV"});
+}
+
+#pragma mark - Helpers
+
+- (SSDPDescriptionCacheEntry *)entryWithBootId:(NSString *)bootId configId:(NSString *)configId {
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kLocation]
+                                                              statusCode:200
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{@"Etag": @"\"abc\"",
+                                                                           @"Last-Modified": @"Thu, 01 Jan 2026 00:00:00 GMT"}];
+    SSDPDescriptionCacheEntry *entry = [[SSDPDescriptionCacheEntry alloc] initWithLocation:kLocation
+                                                                                  response:response
+                                                                                      data:[@"<root/>" dataUsingEncoding:NSUTF8StringEncoding]];
+    entry.bootId = bootId;
+    entry.configId = configId;
+
+    return entry;
+}
+
+@end
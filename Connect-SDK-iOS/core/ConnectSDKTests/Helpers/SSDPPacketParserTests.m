@@ -0,0 +1,257 @@
+//
+//  SSDPPacketParserTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPPacketParser.h"
+
+/// Number of times the corpus is replayed in each performance test.
+static const NSUInteger kCorpusReplays = 1000;
+
+static NSData *packetData(NSString *packet) {
+    return [packet dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+/// Tests for the SSDP datagram parser. The performance tests replay a corpus
+/// of captured packets through the parser and through the CFHTTPMessage and
+/// NSRegularExpression path it replaced.
+@interface SSDPPacketParserTests : XCTestCase
+
+@end
+
+@implementation SSDPPacketParserTests
+
+#pragma mark - Parsing Tests
+
+- (void)testShouldParseSearchResponse {
+    NSData *data = packetData(@"HTTP/1.1 200 OK\r\n"
+                              @"CACHE-CONTROL: max-age=1800\r\n"
+                              @"LOCATION: http://192.168.1.20:1719/description.xml\r\n"
+                              @"ST: urn:schemas-upnp-org:device:MediaRenderer:1\r\n"
+                              @"USN: uuid:3f0a1c7e-33b4::urn:schemas-upnp-org:device:MediaRenderer:1\r\n"
+                              @"\r\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(packet.kind, SSDPPacketKindResponse);
+    XCTAssertEqual(packet.statusCode, 200);
+    XCTAssertTrue(SSDPPacketIsAnnouncement(&packet));
+    XCTAssertFalse(SSDPPacketIsByeBye(&packet));
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(SSDPPacketType(&packet)), @"urn:schemas-upnp-org:device:MediaRenderer:1");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.location), @"http://192.168.1.20:1719/description.xml");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.uuid), @"3f0a1c7e-33b4");
+}
+
+- (void)testShouldParseByeByeNotification {
+    NSData *data = packetData(@"NOTIFY * HTTP/1.1\r\n"
+                              @"HOST: 239.255.255.250:1900\r\n"
+                              @"NT: roku:ecp\r\n"
+                              @"NTS: ssdp:byebye\r\n"
+                              @"USN: uuid:roku:ecp:YN00H5555555\r\n"
+                              @"\r\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(packet.kind, SSDPPacketKindNotify);
+    XCTAssertTrue(SSDPPacketIsAnnouncement(&packet));
+    XCTAssertTrue(SSDPPacketIsByeBye(&packet));
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(SSDPPacketType(&packet)), @"roku:ecp");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.uuid), @"roku:ecp:YN00H5555555",
+                          @"A USN without :: should use everything after uuid:");
+}
+
+- (void)testShouldMatchHeaderNamesCaseInsensitivelyAndTrimValues {
+    NSData *data = packetData(@"HTTP/1.1 200 OK\n"
+                              @"Location:\thttp://192.168.1.31:8060/  \n"
+                              @"st:roku:ecp\n"
+                              @"Usn:  uuid:abc::roku:ecp\n"
+                              @"\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.location), @"http://192.168.1.31:8060/");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.st), @"roku:ecp");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.uuid), @"abc");
+}
+
+- (void)testShouldParseUPnPBootAndConfigIds {
+    NSData *data = packetData(@"NOTIFY * HTTP/1.1\r\n"
+                              @"NT: upnp:rootdevice\r\n"
+                              @"NTS: ssdp:alive\r\n"
+                              @"USN: uuid:abc::upnp:rootdevice\r\n"
+                              @"BOOTID.UPNP.ORG: 1761\r\n"
+                              @"configid.upnp.org: 42\r\n"
+                              @"\r\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.bootId), @"1761");
+    XCTAssertEqualObjects(SSDPHeaderValueCopyString(packet.configId), @"42");
+}
+
+- (void)testShouldReadMaxAgeFromCacheControl {
+    SSDPPacket packet;
+    NSData *data = packetData(@"HTTP/1.1 200 OK\r\n"
+                              @"Cache-Control: no-cache=\"Ext\", max-age = 1800\r\n"
+                              @"\r\n");
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(SSDPPacketMaxAge(&packet), 1800);
+
+    data = packetData(@"HTTP/1.1 200 OK\r\n\r\n");
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(SSDPPacketMaxAge(&packet), -1, @"A missing CACHE-CONTROL should have no max-age");
+}
+
+- (void)testSearchRequestShouldNotBeAnAnnouncement {
+    NSData *data = packetData(@"M-SEARCH * HTTP/1.1\r\n"
+                              @"HOST: 239.255.255.250:1900\r\n"
+                              @"MAN: \"ssdp:discover\"\r\n"
+                              @"ST: ssdp:all\r\n"
+                              @"\r\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(packet.kind, SSDPPacketKindSearch);
+    XCTAssertFalse(SSDPPacketIsAnnouncement(&packet));
+}
+
+- (void)testErrorResponseShouldNotBeAnAnnouncement {
+    NSData *data = packetData(@"HTTP/1.1 404 Not Found\r\n\r\n");
+    SSDPPacket packet;
+
+    XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertEqual(packet.statusCode, 404);
+    XCTAssertFalse(SSDPPacketIsAnnouncement(&packet));
+}
+
+- (void)testIncompleteHeaderShouldBeRejected {
+    NSData *data = packetData(@"HTTP/1.1 200 OK\r\n"
+                              @"ST: roku:ecp\r\n"
+                              @"USN: uuid:abc");
+    SSDPPacket packet;
+
+    XCTAssertFalse(SSDPPacketParse(data.bytes, data.length, &packet));
+}
+
+- (void)testNonSSDPDataShouldBeRejected {
+    NSData *data = packetData(@"GET / HTTP/1.1\r\n\r\n");
+    SSDPPacket packet;
+
+    XCTAssertFalse(SSDPPacketParse(data.bytes, data.length, &packet));
+    XCTAssertFalse(SSDPPacketParse(NULL, 0, &packet));
+}
+
+- (void)testCorpusShouldParse {
+    NSArray *corpus = [self packetCorpus];
+    XCTAssertGreaterThan(corpus.count, 0u);
+
+    for (NSData *data in corpus) {
+        SSDPPacket packet;
+        XCTAssertTrue(SSDPPacketParse(data.bytes, data.length, &packet),
+                      @"Could not parse %@", [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]);
+    }
+}
+
+#pragma mark - Performance Tests
+
+- (void)testParserPerformance {
+    NSArray *corpus = [self packetCorpus];
+    const char *filter = "urn:schemas-upnp-org:device:MediaRenderer:1";
+    const size_t filterLength = strlen(filter);
+
+    [self measureBlock:^{
+        NSUInteger matches = 0;
+
+        for (NSUInteger i = 0; i < kCorpusReplays; ++i) {
+            for (NSData *data in corpus) {
+                SSDPPacket packet;
+                if (SSDPPacketParse(data.bytes, data.length, &packet) &&
+                    SSDPPacketIsAnnouncement(&packet) &&
+                    SSDPHeaderValueEqualsBytes(SSDPPacketType(&packet), filter, filterLength) &&
+                    packet.uuid.length > 0) {
+                    ++matches;
+                }
+            }
+        }
+
+        XCTAssertGreaterThan(matches, 0u);
+    }];
+}
+
+/// The per-packet work SSDPDiscoveryProvider did before the parser existed.
+- (void)testLegacyCFHTTPMessagePerformance {
+    NSArray *corpus = [self packetCorpus];
+    NSString *filter = @"urn:schemas-upnp-org:device:MediaRenderer:1";
+
+    [self measureBlock:^{
+        NSUInteger matches = 0;
+
+        for (NSUInteger i = 0; i < kCorpusReplays; ++i) {
+            for (NSData *data in corpus) {
+                @autoreleasepool {
+                    CFHTTPMessageRef message = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, TRUE);
+                    CFHTTPMessageAppendBytes(message, data.bytes, data.length);
+
+                    if (CFHTTPMessageIsHeaderComplete(message)) {
+                        NSString *method = CFBridgingRelease(CFHTTPMessageCopyRequestMethod(message));
+                        NSInteger code = CFHTTPMessageGetResponseStatusCode(message);
+                        NSDictionary *headers = CFBridgingRelease(CFHTTPMessageCopyAllHeaderFields(message));
+                        NSString *type = [method isEqualToString:@"NOTIFY"] ? headers[@"NT"] : headers[@"ST"];
+                        NSString *usn = headers[@"USN"];
+
+                        if (code == 200 && ![method isEqualToString:@"M-SEARCH"] &&
+                            [type isEqualToString:filter] && usn.length > 0) {
+                            NSRegularExpression *reg = [[NSRegularExpression alloc] initWithPattern:@"(?:uuid:).*(?:::)" options:0 error:nil];
+                            if ([reg firstMatchInString:usn options:0 range:NSMakeRange(0, usn.length)]) {
+                                ++matches;
+                            }
+                        }
+                    }
+
+                    CFRelease(message);
+                }
+            }
+        }
+
+        XCTAssertGreaterThan(matches, 0u);
+    }];
+}
+
+#pragma mark - Helpers
+
+/// Returns the captured packets as CRLF-terminated datagrams.
+- (NSArray *)packetCorpus {
+    NSString *path = [[NSBundle bundleForClass:[self class]] pathForResource:@"ssdp_packet_corpus"
+                                                                      ofType:@"txt"];
+    NSString *contents = [NSString stringWithContentsOfFile:path
+                                                   encoding:NSUTF8StringEncoding
+                                                      error:nil];
+    NSMutableArray *packets = [NSMutableArray array];
+
+    for (NSString *packet in [contents componentsSeparatedByString:@"%%\n"]) {
+        if (packet.length > 0) {
+            NSString *crlf = [packet stringByReplacingOccurrencesOfString:@"\n" withString:@"\r\n"];
+            [packets addObject:packetData(crlf)];
+        }
+    }
+
+    return packets;
+}
+
+@end
@@ -0,0 +1,126 @@
+//
+//  SSDPSocketListenerTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+
+#import <arpa/inet.h>
+
+#import "SSDPSocketListener.h"
+
+static const NSInteger kTestPort = 51900;
+
+/// Tests that the listener drains every waiting datagram in one wakeup.
+@interface SSDPSocketListenerTests : XCTestCase <SocketListenerDelegate>
+
+@property (nonatomic, strong) SSDPSocketListener *listener;
+@property (nonatomic, strong) dispatch_queue_t workQueue;
+@property (nonatomic, strong) NSMutableArray *batches;
+@property (nonatomic, strong) XCTestExpectation *batchExpectation;
+
+@end
+
+@implementation SSDPSocketListenerTests
+
+#pragma mark - Setup
+
+- (void)setUp {
+    [super setUp];
+
+    self.batches = [NSMutableArray array];
+    self.workQueue = dispatch_queue_create("SSDPSocketListenerTests", DISPATCH_QUEUE_SERIAL);
+
+    self.listener = [[SSDPSocketListener alloc] initWithAddress:@"0.0.0.0" andPort:kTestPort];
+    self.listener.workQueue = self.workQueue;
+    self.listener.delegate = self;
+}
+
+- (void)tearDown {
+    [self.listener close];
+    self.listener = nil;
+    [super tearDown];
+}
+
+#pragma mark - Receive Tests
+
+- (void)testPendingDatagramsShouldArriveAsOneBatch {
+    // Hold the work queue so every datagram is waiting when the listener wakes up
+    dispatch_suspend(self.workQueue);
+    [self.listener open];
+
+    for (NSUInteger i = 0; i < 5; ++i) {
+        [self sendString:[NSString stringWithFormat:@"packet %lu", (unsigned long)i]];
+    }
+
+    self.batchExpectation = [self expectationWithDescription:@"Datagrams are delivered"];
+    dispatch_resume(self.workQueue);
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    XCTAssertEqual(self.batches.count, 1u, @"All waiting datagrams should be read in one wakeup");
+
+    NSArray *datagrams = self.batches.firstObject;
+    XCTAssertEqual(datagrams.count, 5u);
+
+    [datagrams enumerateObjectsUsingBlock:^(SSDPDatagram *datagram, NSUInteger idx, BOOL *stop) {
+        NSString *expected = [NSString stringWithFormat:@"packet %lu", (unsigned long)idx];
+        XCTAssertEqualObjects([[NSString alloc] initWithData:datagram.data encoding:NSUTF8StringEncoding], expected,
+                              @"Datagrams should be delivered in arrival order");
+        XCTAssertEqualObjects(datagram.address, @"127.0.0.1");
+    }];
+}
+
+- (void)testDatagramShouldOutliveTheBatch {
+    [self.listener open];
+
+    self.batchExpectation = [self expectationWithDescription:@"Datagram is delivered"];
+    [self sendString:@"kept"];
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+
+    SSDPDatagram *datagram = [self.batches.firstObject firstObject];
+    [self.listener close];
+    self.listener = nil;
+
+    XCTAssertEqualObjects([[NSString alloc] initWithData:datagram.data encoding:NSUTF8StringEncoding], @"kept",
+                          @"Received data should stay valid after the listener is gone");
+}
+
+#pragma mark - SocketListenerDelegate
+
+- (void)socket:(SSDPSocketListener *)aSocket didReceiveDatagrams:(NSArray *)datagrams {
+    [self.batches addObject:datagrams];
+    [self.batchExpectation fulfill];
+    self.batchExpectation = nil;
+}
+
+#pragma mark - Helpers
+
+- (void)sendString:(NSString *)string {
+    int sender = socket(PF_INET, SOCK_DGRAM, 0);
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(kTestPort);
+    inet_aton("127.0.0.1", &address.sin_addr);
+
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    sendto(sender, data.bytes, data.length, 0, (struct sockaddr *)&address, sizeof(address));
+    close(sender);
+}
+
+@end
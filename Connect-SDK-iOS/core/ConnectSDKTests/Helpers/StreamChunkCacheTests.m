@@ -0,0 +1,120 @@
+//
+//  StreamChunkCacheTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "StreamChunkCache.h"
+
+static const NSUInteger kChunkSize = 1024;
+
+static NSData *chunkData(uint8_t fill, NSUInteger length) {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    memset(data.mutableBytes, fill, length);
+    return data;
+}
+
+@interface StreamChunkCacheTests : XCTestCase
+
+@property (nonatomic, strong) NSString *directory;
+@property (nonatomic, strong) StreamChunkCache *cache;
+
+@end
+
+@implementation StreamChunkCacheTests
+
+- (void)setUp {
+    [super setUp];
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.cache = [[StreamChunkCache alloc] initWithDirectory:self.directory chunkSize:kChunkSize];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:nil];
+    self.cache = nil;
+    [super tearDown];
+}
+
+- (void)testStoredChunkShouldBeReadBack {
+    NSData *chunk = chunkData(7, kChunkSize);
+    [self.cache storeChunk:chunk atIndex:3 forKey:@"abc"];
+
+    XCTAssertTrue([self.cache hasChunkAtIndex:3 forKey:@"abc"]);
+    XCTAssertEqualObjects([self.cache chunkAtIndex:3 forKey:@"abc"], chunk);
+    XCTAssertEqual(self.cache.size, (unsigned long long)kChunkSize);
+}
+
+- (void)testMissingChunkShouldBeNil {
+    [self.cache storeChunk:chunkData(7, kChunkSize) atIndex:0 forKey:@"abc"];
+
+    XCTAssertFalse([self.cache hasChunkAtIndex:1 forKey:@"abc"]);
+    XCTAssertNil([self.cache chunkAtIndex:1 forKey:@"abc"]);
+    XCTAssertNil([self.cache chunkAtIndex:0 forKey:@"def"], @"Chunks should be kept apart by key");
+}
+
+- (void)testChunksShouldBeKeptAcrossInstances {
+    [self.cache storeChunk:chunkData(1, kChunkSize) atIndex:0 forKey:@"abc"];
+    [self.cache storeChunk:chunkData(2, 100) atIndex:1 forKey:@"abc"];
+
+    StreamChunkCache *reopened = [[StreamChunkCache alloc] initWithDirectory:self.directory chunkSize:kChunkSize];
+
+    XCTAssertEqual(reopened.size, (unsigned long long)kChunkSize + 100);
+    XCTAssertEqualObjects([reopened chunkAtIndex:1 forKey:@"abc"], chunkData(2, 100));
+}
+
+- (void)testStreamLengthShouldBeKeptAcrossInstances {
+    XCTAssertEqual([self.cache lengthForKey:@"abc"], -1);
+
+    [self.cache storeChunk:chunkData(1, kChunkSize) atIndex:0 forKey:@"abc"];
+    [self.cache setLength:4096 contentType:@"video/mp4" forKey:@"abc"];
+
+    StreamChunkCache *reopened = [[StreamChunkCache alloc] initWithDirectory:self.directory chunkSize:kChunkSize];
+
+    XCTAssertEqual([reopened lengthForKey:@"abc"], 4096);
+    XCTAssertEqualObjects([reopened contentTypeForKey:@"abc"], @"video/mp4");
+    XCTAssertEqual(reopened.size, (unsigned long long)kChunkSize, @"The stream info shouldn't count as a chunk");
+}
+
+- (void)testLeastRecentlyUsedChunkShouldBeEvictedFirst {
+    self.cache.capacity = 2 * kChunkSize;
+
+    [self.cache storeChunk:chunkData(0, kChunkSize) atIndex:0 forKey:@"abc"];
+    [self.cache storeChunk:chunkData(1, kChunkSize) atIndex:1 forKey:@"abc"];
+
+    // Reading chunk 0 makes chunk 1 the oldest
+    XCTAssertNotNil([self.cache chunkAtIndex:0 forKey:@"abc"]);
+    [self.cache storeChunk:chunkData(2, kChunkSize) atIndex:2 forKey:@"abc"];
+
+    XCTAssertTrue([self.cache hasChunkAtIndex:0 forKey:@"abc"]);
+    XCTAssertFalse([self.cache hasChunkAtIndex:1 forKey:@"abc"]);
+    XCTAssertTrue([self.cache hasChunkAtIndex:2 forKey:@"abc"]);
+    XCTAssertEqual(self.cache.size, (unsigned long long)(2 * kChunkSize));
+
+    NSString *evicted = [[self.directory stringByAppendingPathComponent:@"abc"] stringByAppendingPathComponent:@"1"];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:evicted]);
+}
+
+- (void)testRemoveAllChunksShouldEmptyTheCache {
+    [self.cache storeChunk:chunkData(0, kChunkSize) atIndex:0 forKey:@"abc"];
+    [self.cache removeAllChunks];
+
+    XCTAssertEqual(self.cache.size, 0u);
+    XCTAssertFalse([self.cache hasChunkAtIndex:0 forKey:@"abc"]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:self.directory]);
+}
+
+@end
@@ -0,0 +1,358 @@
+//
+//  StreamProxyTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <OHHTTPStubs/OHHTTPStubs.h>
+#import "StreamProxy_Private.h"
+
+static const NSUInteger kChunkSize = 1024;
+static const NSUInteger kStreamLength = 10 * kChunkSize + 300;
+static const NSUInteger kTestPort = 49392;
+static NSString *const kUpstreamHost = @"upstream.example.com";
+
+/// Timeout for requests through the proxy, which go through loopback and
+/// the stubbed upstream.
+static const NSTimeInterval kProxyTimeout = 5.0;
+
+/// Tests for @c StreamProxy against a stubbed upstream that honours single
+/// byte ranges and records every range it's asked for, and for the local files
+/// it serves.
+@interface StreamProxyTests : XCTestCase
+
+@property (nonatomic, strong) NSString *directory;
+@property (nonatomic, strong) StreamProxy *proxy;
+@property (nonatomic, strong) NSData *stream;
+@property (nonatomic, strong) NSMutableArray *upstreamRanges;
+
+@end
+
+@implementation StreamProxyTests
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableData *stream = [NSMutableData dataWithLength:kStreamLength];
+    uint8_t *bytes = stream.mutableBytes;
+    for (NSUInteger i = 0; i < kStreamLength; ++i) {
+        bytes[i] = (uint8_t)(i * 31 + i / 251);
+    }
+    self.stream = stream;
+    self.upstreamRanges = [NSMutableArray array];
+
+    __weak StreamProxyTests *weakSelf = self;
+    [OHHTTPStubs stubRequestsPassingTest:^BOOL(NSURLRequest *request) {
+        return [request.URL.host isEqualToString:kUpstreamHost];
+    }
+                        withStubResponse:^OHHTTPStubsResponse *(NSURLRequest *request) {
+                            return [weakSelf upstreamResponseForRequest:request];
+                        }];
+
+    self.directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    StreamChunkCache *cache = [[StreamChunkCache alloc] initWithDirectory:self.directory chunkSize:kChunkSize];
+    self.proxy = [[StreamProxy alloc] initWithPort:kTestPort cache:cache];
+    self.proxy.readAheadChunks = 2;
+    XCTAssertTrue([self.proxy start]);
+}
+
+- (void)tearDown {
+    [self.proxy stop];
+    self.proxy = nil;
+    [OHHTTPStubs removeAllStubs];
+    [[NSFileManager defaultManager] removeItemAtPath:self.directory error:nil];
+    [super tearDown];
+}
+
+#pragma mark - Response Tests
+
+- (void)testRangeShouldBeServedFromUpstream {
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadStream:@"video" range:@"bytes=1500-2999" response:&response];
+
+    XCTAssertEqual(response.statusCode, 206);
+    XCTAssertEqualObjects(response.allHeaderFields[@"Content-Range"], @"bytes 1500-2999/10540");
+    XCTAssertEqualObjects(response.allHeaderFields[@"Accept-Ranges"], @"bytes");
+    XCTAssertEqualObjects(body, [self.stream subdataWithRange:NSMakeRange(1500, 1500)]);
+}
+
+- (void)testWholeStreamShouldBeServedWithoutRange {
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadStream:@"video" range:nil response:&response];
+
+    XCTAssertEqual(response.statusCode, 200);
+    XCTAssertEqualObjects(response.MIMEType, @"video/mp4");
+    XCTAssertEqualObjects(body, self.stream);
+}
+
+- (void)testSuffixRangeShouldIncludeTheShortLastChunk {
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadStream:@"video" range:@"bytes=-500" response:&response];
+
+    XCTAssertEqual(response.statusCode, 206);
+    XCTAssertEqualObjects(body, [self.stream subdataWithRange:NSMakeRange(kStreamLength - 500, 500)]);
+}
+
+- (void)testUnsatisfiableRangeShouldReturn416 {
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadStream:@"video" range:@"bytes=20000-" response:&response];
+
+    XCTAssertEqual(response.statusCode, 416);
+    XCTAssertEqualObjects(response.allHeaderFields[@"Content-Range"], @"bytes */10540");
+    XCTAssertEqual(body.length, 0u);
+}
+
+- (void)testUnknownStreamShouldReturn404 {
+    NSURL *url = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%lu/stream/0123abcd", (unsigned long)kTestPort]];
+    NSHTTPURLResponse *response;
+
+    [self download:[NSURLRequest requestWithURL:url] response:&response];
+
+    XCTAssertEqual(response.statusCode, 404);
+}
+
+- (void)testProxyPathShouldNotContainTheUpstreamQuery {
+    NSString *path = [self.proxy pathForURL:[self upstreamURLForStream:@"video"]];
+
+    XCTAssertTrue([path hasPrefix:@"/stream/"]);
+    XCTAssertEqual([path rangeOfString:@"secret"].location, (NSUInteger)NSNotFound);
+    XCTAssertEqualObjects([self.proxy pathForURL:[self upstreamURLForStream:@"video"]], path,
+                          @"The same upstream URL should always get the same path");
+}
+
+- (void)testStreamShouldHaveDLNAHeaders {
+    NSHTTPURLResponse *response;
+    [self downloadStream:@"video" range:@"bytes=0-99" response:&response];
+
+    XCTAssertEqualObjects(response.allHeaderFields[@"contentFeatures.dlna.org"],
+                          @"DLNA.ORG_OP=01;DLNA.ORG_CI=0;DLNA.ORG_FLAGS=01700000000000000000000000000000");
+    XCTAssertEqualObjects(response.allHeaderFields[@"transferMode.dlna.org"], @"Streaming");
+}
+
+#pragma mark - Local File Tests
+
+- (void)testLocalFileRangeShouldBeServedWithDLNAHeaders {
+    NSString *path = [self writeLocalFile];
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadFileAtPath:[self.proxy pathForFileAtPath:path] range:@"bytes=1000-1999" response:&response];
+
+    XCTAssertEqual(response.statusCode, 206);
+    XCTAssertEqualObjects(response.MIMEType, @"video/mp4");
+    XCTAssertEqualObjects(response.allHeaderFields[@"Accept-Ranges"], @"bytes");
+    XCTAssertEqualObjects(response.allHeaderFields[@"contentFeatures.dlna.org"],
+                          @"DLNA.ORG_OP=01;DLNA.ORG_CI=0;DLNA.ORG_FLAGS=01700000000000000000000000000000");
+    XCTAssertEqualObjects(response.allHeaderFields[@"transferMode.dlna.org"], @"Streaming");
+    XCTAssertEqualObjects(body, [self.stream subdataWithRange:NSMakeRange(1000, 1000)]);
+    XCTAssertEqual([self upstreamRanges].count, 0u, @"Local files should never go upstream");
+}
+
+- (void)testEverySessionShouldGetItsOwnToken {
+    NSString *path = [self writeLocalFile];
+    NSString *first = [self.proxy pathForFileAtPath:path];
+    NSString *second = [self.proxy pathForFileAtPath:path];
+
+    XCTAssertNotEqualObjects(first, second);
+    XCTAssertTrue([first hasSuffix:@"/Downloaded%20Video.mp4"], @"The file name should be kept for renderers that sniff the extension");
+}
+
+- (void)testRevokedFileShouldReturn404 {
+    NSString *filePath = [self.proxy pathForFileAtPath:[self writeLocalFile]];
+    [self.proxy revokeFileURLs];
+
+    NSHTTPURLResponse *response;
+    [self downloadFileAtPath:filePath range:nil response:&response];
+
+    XCTAssertEqual(response.statusCode, 404);
+}
+
+- (void)testGuessedTokenShouldReturn404 {
+    [self.proxy pathForFileAtPath:[self writeLocalFile]];
+
+    NSHTTPURLResponse *response;
+    [self downloadFileAtPath:@"/file/00000000000000000000000000000000/Downloaded%20Video.mp4" range:nil response:&response];
+
+    XCTAssertEqual(response.statusCode, 404);
+}
+
+#pragma mark - Fetching Tests
+
+- (void)testMissingChunksShouldBeFetchedWithOneRequest {
+    [self downloadStream:@"video" range:@"bytes=0-99" response:NULL];
+
+    // Chunk 0 plus two chunks of read-ahead
+    XCTAssertEqualObjects([self upstreamRanges].firstObject, @"bytes=0-3071");
+}
+
+- (void)testSeekIntoFetchedRegionShouldBeServedFromCache {
+    [self downloadStream:@"video" range:@"bytes=0-2047" response:NULL];
+    [self waitForUpstreamToSettle];
+    NSUInteger fetches = [self upstreamRanges].count;
+
+    NSData *body = [self downloadStream:@"video" range:@"bytes=100-1999" response:NULL];
+
+    XCTAssertEqualObjects(body, [self.stream subdataWithRange:NSMakeRange(100, 1900)]);
+    XCTAssertEqual([self upstreamRanges].count, fetches, @"Nothing should be fetched again");
+}
+
+- (void)testCachedStreamShouldBeServedAfterRelaunchWithoutUpstream {
+    [self downloadStream:@"video" range:@"bytes=0-99" response:NULL];
+    [self waitForUpstreamToSettle];
+    NSUInteger fetches = [self upstreamRanges].count;
+
+    // A new proxy over the same cache directory, as after a relaunch
+    [self.proxy stop];
+    StreamChunkCache *cache = [[StreamChunkCache alloc] initWithDirectory:self.directory chunkSize:kChunkSize];
+    self.proxy = [[StreamProxy alloc] initWithPort:kTestPort cache:cache];
+    XCTAssertTrue([self.proxy start]);
+
+    NSHTTPURLResponse *response;
+    NSData *body = [self downloadStream:@"video" range:@"bytes=100-199" response:&response];
+
+    XCTAssertEqual(response.statusCode, 206);
+    XCTAssertEqualObjects(response.allHeaderFields[@"Content-Range"], @"bytes 100-199/10540");
+    XCTAssertEqualObjects(response.MIMEType, @"video/mp4");
+    XCTAssertEqualObjects(body, [self.stream subdataWithRange:NSMakeRange(100, 100)]);
+    XCTAssertEqual([self upstreamRanges].count, fetches, @"Nothing should be fetched again");
+}
+
+- (void)testRenderersShouldShareOneUpstreamFetch {
+    NSURL *url = [self proxyURLForStream:@"video"];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    [request setValue:@"bytes=0-99" forHTTPHeaderField:@"Range"];
+
+    XCTestExpectation *first = [self expectationWithDescription:@"First renderer got its range"];
+    XCTestExpectation *second = [self expectationWithDescription:@"Second renderer got its range"];
+
+    for (XCTestExpectation *expectation in @[first, second]) {
+        [[[NSURLSession sharedSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            XCTAssertEqualObjects(data, [self.stream subdataWithRange:NSMakeRange(0, 100)]);
+            [expectation fulfill];
+        }] resume];
+    }
+
+    [self waitForExpectationsWithTimeout:kProxyTimeout handler:nil];
+
+    NSPredicate *fromStart = [NSPredicate predicateWithFormat:@"SELF BEGINSWITH 'bytes=0-'"];
+    XCTAssertEqual([[self upstreamRanges] filteredArrayUsingPredicate:fromStart].count, 1u);
+}
+
+- (void)testPlaybackShouldReadAhead {
+    [self downloadStream:@"video" range:@"bytes=2048-2147" response:NULL];
+    [self waitForUpstreamToSettle];
+
+    for (NSUInteger index = 2; index <= 4; ++index) {
+        XCTAssertTrue([self.proxy.cache hasChunkAtIndex:index forKey:[self keyForStream:@"video"]]);
+    }
+}
+
+#pragma mark - Helpers
+
+- (NSURL *)upstreamURLForStream:(NSString *)name {
+    return [NSURL URLWithString:[NSString stringWithFormat:@"https://%@/files/%@/stream?oauth_token=secret", kUpstreamHost, name]];
+}
+
+- (NSURL *)proxyURLForStream:(NSString *)name {
+    NSString *path = [self.proxy pathForURL:[self upstreamURLForStream:name]];
+    return [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%lu%@", (unsigned long)kTestPort, path]];
+}
+
+- (NSString *)keyForStream:(NSString *)name {
+    return [[self.proxy pathForURL:[self upstreamURLForStream:name]] lastPathComponent];
+}
+
+- (NSArray *)upstreamRanges {
+    @synchronized (self.upstreamRanges) {
+        return [self.upstreamRanges copy];
+    }
+}
+
+/// Gives read-ahead fetches started by the last response time to finish.
+- (void)waitForUpstreamToSettle {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+}
+
+/// Writes the test stream to a local file and returns its path.
+- (NSString *)writeLocalFile {
+    [[NSFileManager defaultManager] createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+    NSString *path = [self.directory stringByAppendingPathComponent:@"Downloaded Video.mp4"];
+    [self.stream writeToFile:path atomically:YES];
+    return path;
+}
+
+- (NSData *)downloadFileAtPath:(NSString *)filePath range:(NSString *)range response:(NSHTTPURLResponse **)response {
+    NSURL *url = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%lu%@", (unsigned long)kTestPort, filePath]];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    [request setValue:range forHTTPHeaderField:@"Range"];
+    return [self download:request response:response];
+}
+
+- (NSData *)downloadStream:(NSString *)name range:(NSString *)range response:(NSHTTPURLResponse **)response {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[self proxyURLForStream:name]];
+    [request setValue:range forHTTPHeaderField:@"Range"];
+    return [self download:request response:response];
+}
+
+- (NSData *)download:(NSURLRequest *)request response:(NSHTTPURLResponse **)response {
+    XCTestExpectation *downloaded = [self expectationWithDescription:@"Downloaded through the proxy"];
+    __block NSData *body;
+    __block NSHTTPURLResponse *httpResponse;
+
+    [[[NSURLSession sharedSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *urlResponse, NSError *error) {
+        XCTAssertNil(error);
+        body = data;
+        httpResponse = (NSHTTPURLResponse *)urlResponse;
+        [downloaded fulfill];
+    }] resume];
+
+    [self waitForExpectationsWithTimeout:kProxyTimeout handler:nil];
+
+    if (response) {
+        *response = httpResponse;
+    }
+    return body;
+}
+
+/// Answers like put.io: 206 for a satisfiable range, 416 otherwise. Responses
+/// are delayed a little so concurrent renderers overlap.
+- (OHHTTPStubsResponse *)upstreamResponseForRequest:(NSURLRequest *)request {
+    NSString *range = [request valueForHTTPHeaderField:@"Range"];
+    @synchronized (self.upstreamRanges) {
+        [self.upstreamRanges addObject:range ?: @""];
+    }
+
+    NSScanner *scanner = [NSScanner scannerWithString:range ?: @""];
+    unsigned long long first = 0, last = kStreamLength - 1;
+    [scanner scanString:@"bytes=" intoString:NULL];
+    [scanner scanUnsignedLongLong:&first];
+    [scanner scanString:@"-" intoString:NULL];
+    [scanner scanUnsignedLongLong:&last];
+
+    if (first >= kStreamLength) {
+        return [OHHTTPStubsResponse responseWithData:[NSData data]
+                                          statusCode:416
+                                             headers:@{@"Content-Range": @"bytes */10540"}];
+    }
+
+    last = MIN(last, kStreamLength - 1);
+    NSData *data = [self.stream subdataWithRange:NSMakeRange((NSUInteger)first, (NSUInteger)(last - first + 1))];
+    NSDictionary *headers = @{@"Content-Type": @"video/mp4",
+                              @"Content-Range": [NSString stringWithFormat:@"bytes %llu-%llu/%lu", first, last, (unsigned long)kStreamLength]};
+
+    return [[OHHTTPStubsResponse responseWithData:data statusCode:206 headers:headers] requestTime:0.05 responseTime:0];
+}
+
+@end
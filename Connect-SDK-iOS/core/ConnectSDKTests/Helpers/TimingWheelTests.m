@@ -0,0 +1,190 @@
+//
+//  TimingWheelTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TimingWheel_Private.h"
+
+@interface TimingWheelTests : XCTestCase
+
+@property (nonatomic, strong) TimingWheel *wheel;
+@property (nonatomic) NSTimeInterval now;
+
+@end
+
+@implementation TimingWheelTests
+
+#pragma mark - Setup
+
+- (void)setUp {
+    [super setUp];
+
+    self.now = 1000;
+    self.wheel = [[TimingWheel alloc] initWithTickInterval:1 queue:dispatch_get_main_queue()];
+
+    __weak typeof(self) weakSelf = self;
+    self.wheel.timeSource = ^{ return weakSelf.now; };
+}
+
+- (void)tearDown {
+    self.wheel = nil;
+    [super tearDown];
+}
+
+#pragma mark - Scheduling Tests
+
+- (void)testTimerShouldFireAfterDelay {
+    __block NSUInteger fired = 0;
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:3 block:^{ ++fired; }];
+
+    [self advanceBy:2];
+    XCTAssertEqual(fired, 0u, @"The timer should not fire early");
+
+    [self advanceBy:1];
+    XCTAssertEqual(fired, 1u, @"The timer should fire once its delay has passed");
+
+    [self advanceBy:10];
+    XCTAssertEqual(fired, 1u, @"A one-off timer should only fire once");
+    XCTAssertEqual(self.wheel.count, 0u);
+}
+
+- (void)testTimersFarInTheFutureShouldFireOnTime {
+    NSArray *delays = @[@63, @64, @65, @200, @4095, @4096, @5000, @300000];
+    NSMutableDictionary *firedAt = [NSMutableDictionary dictionary];
+    NSTimeInterval start = self.now;
+
+    for (NSNumber *delay in delays) {
+        [self.wheel scheduleTimerForOwner:self name:delay.stringValue afterDelay:delay.doubleValue block:^{
+            firedAt[delay] = @(self.now - start);
+        }];
+    }
+
+    // One tick at a time, the way the dispatch timer drives it
+    for (NSUInteger i = 0; i < 300000; ++i) {
+        [self advanceBy:1];
+    }
+
+    for (NSNumber *delay in delays) {
+        XCTAssertEqualObjects(firedAt[delay], delay, @"The timer should fire on the tick it's due");
+    }
+}
+
+- (void)testReschedulingShouldReplaceTheTimer {
+    __block NSString *fired;
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:2 block:^{ fired = @"first"; }];
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:5 block:^{ fired = @"second"; }];
+
+    XCTAssertEqual(self.wheel.count, 1u);
+
+    [self advanceBy:2];
+    XCTAssertNil(fired, @"The replaced timer should not fire");
+
+    [self advanceBy:3];
+    XCTAssertEqualObjects(fired, @"second");
+}
+
+- (void)testCancelledTimerShouldNotFire {
+    __block BOOL fired = NO;
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:2 block:^{ fired = YES; }];
+
+    [self.wheel cancelTimerForOwner:self name:@"timer"];
+    [self advanceBy:5];
+
+    XCTAssertFalse(fired);
+    XCTAssertFalse([self.wheel hasTimerForOwner:self name:@"timer"]);
+}
+
+- (void)testCancellingAnOwnerShouldOnlyCancelItsTimers {
+    NSObject *otherOwner = [NSObject new];
+    __block NSUInteger fired = 0;
+
+    [self.wheel scheduleTimerForOwner:self name:@"a" afterDelay:1 block:^{ fired += 1; }];
+    [self.wheel scheduleTimerForOwner:self name:@"b" afterDelay:1 block:^{ fired += 10; }];
+    [self.wheel scheduleTimerForOwner:otherOwner name:@"a" afterDelay:1 block:^{ fired += 100; }];
+
+    [self.wheel cancelAllTimersForOwner:self];
+    [self advanceBy:1];
+
+    XCTAssertEqual(fired, 100u);
+}
+
+- (void)testRepeatingTimerShouldFireEveryInterval {
+    __block NSUInteger fired = 0;
+    [self.wheel scheduleRepeatingTimerForOwner:self name:@"timer" interval:10 block:^{ ++fired; }];
+
+    for (NSUInteger i = 0; i < 35; ++i) {
+        [self advanceBy:1];
+    }
+
+    XCTAssertEqual(fired, 3u);
+    XCTAssertTrue([self.wheel hasTimerForOwner:self name:@"timer"]);
+}
+
+- (void)testRepeatingTimerShouldFireOnceWhenCatchingUp {
+    __block NSUInteger fired = 0;
+    [self.wheel scheduleRepeatingTimerForOwner:self name:@"timer" interval:10 block:^{ ++fired; }];
+
+    // As if the app was suspended for five minutes
+    [self advanceBy:300];
+
+    XCTAssertEqual(fired, 1u);
+}
+
+- (void)testDelayShouldCountFromNowWhenTheWheelIsBehind {
+    __block NSUInteger fired = 0;
+    [self.wheel scheduleRepeatingTimerForOwner:self name:@"repeating" interval:100 block:^{}];
+
+    // The clock moves on before the wheel gets to tick
+    self.now += 50;
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:5 block:^{ ++fired; }];
+
+    [self advanceBy:1];
+    XCTAssertEqual(fired, 0u, @"The timer should not fire while the wheel catches up");
+
+    [self advanceBy:4];
+    XCTAssertEqual(fired, 1u, @"The timer should fire once its delay has passed");
+}
+
+- (void)testTimerShouldBeAbleToRescheduleItself {
+    __block NSUInteger fired = 0;
+    __weak typeof(self) weakSelf = self;
+    __block dispatch_block_t block;
+
+    block = ^{
+        if (++fired < 3) {
+            [weakSelf.wheel scheduleTimerForOwner:weakSelf name:@"timer" afterDelay:1 block:block];
+        }
+    };
+    [self.wheel scheduleTimerForOwner:self name:@"timer" afterDelay:1 block:block];
+
+    for (NSUInteger i = 0; i < 5; ++i) {
+        [self advanceBy:1];
+    }
+
+    XCTAssertEqual(fired, 3u);
+    block = nil;
+}
+
+#pragma mark - Helpers
+
+- (void)advanceBy:(NSTimeInterval)seconds {
+    self.now += seconds;
+    [self.wheel fireExpiredTimers];
+}
+
+@end
@@ -442,6 +442,18 @@ static NSString *const kDefaultAlbumArtURL = @"http://example.com/media.png";
            shouldContainPVSubtitleAttributes:NO];
 }
 
+- (void)testPlayVideoRequestShouldNotClaimMP3Profile {
+    MediaInfo *mediaInfo = [[MediaInfo alloc] initWithURL:[NSURL URLWithString:kDefaultURL]
+                                                 mimeType:@"video/mp4"];
+
+    [self checkPlayVideoWithSubtitles:mediaInfo
+            DIDLRequestShouldPassTest:^(NSDictionary *didl) {
+                NSDictionary *resource = [didl valueForKeyPath:@"item.res"];
+                XCTAssertEqualObjects(resource[@"protocolInfo"],
+                                      @"http-get:*:video/mp4:DLNA.ORG_OP=01;DLNA.ORG_CI=0;DLNA.ORG_FLAGS=01700000000000000000000000000000");
+            }];
+}
+
 - (void)testPlayVideoWithSubtitlesWithoutMimeTypeShouldSendDefaultMimeTypeProtocolInfo {
     [self checkPlayVideoRequestWithMediaInfo:[self mediaInfoWithSubtitleWithoutMimeType]
                                shouldContain:YES
@@ -0,0 +1,312 @@
+//
+//  GCDWebServerConnectionTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "GCDWebServer.h"
+#import "GCDWebServerDataRequest.h"
+#import "GCDWebServerDataResponse.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/// Number of requests sent by each load test run.
+static const NSUInteger kLoadTestRequests = 200;
+
+static NSString *const kGetRequest = @"GET /ping HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+/// Tests for persistent connections in @c GCDWebServerConnection. The server
+/// is driven through raw sockets so the tests control exactly which bytes go
+/// out on which connection.
+@interface GCDWebServerConnectionTests : XCTestCase
+
+@property (nonatomic, strong) GCDWebServer *server;
+
+@end
+
+@implementation GCDWebServerConnectionTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.server = [GCDWebServer new];
+    [self.server addDefaultHandlerForMethod:@"GET"
+                               requestClass:[GCDWebServerRequest class]
+                               processBlock:^GCDWebServerResponse *(GCDWebServerRequest *request) {
+                                   return [GCDWebServerDataResponse responseWithText:@"ok"];
+                               }];
+    [self.server addDefaultHandlerForMethod:@"POST"
+                               requestClass:[GCDWebServerDataRequest class]
+                               processBlock:^GCDWebServerResponse *(GCDWebServerRequest *request) {
+                                   return [GCDWebServerDataResponse responseWithText:((GCDWebServerDataRequest *)request).text];
+                               }];
+}
+
+- (void)tearDown {
+    if (self.server.running) {
+        [self.server stop];
+    }
+    self.server = nil;
+
+    [super tearDown];
+}
+
+#pragma mark - Keep-Alive Tests
+
+- (void)testPipelinedRequestsShouldBeAnsweredOnOneConnection {
+    [self startServerWithOptions:nil];
+    int socket = [self connect];
+
+    NSString *pipelined = [@[kGetRequest, kGetRequest, kGetRequest] componentsJoinedByString:@""];
+    [self send:pipelined on:socket];
+    NSArray *responses = [self readResponses:3 from:socket];
+
+    XCTAssertEqual(responses.count, 3u);
+    for (NSString *response in responses) {
+        XCTAssertTrue([response hasPrefix:@"HTTP/1.1 200"]);
+        XCTAssertTrue([response containsString:@"Connection: keep-alive"]);
+        XCTAssertTrue([response hasSuffix:@"\r\n\r\nok"]);
+    }
+
+    close(socket);
+}
+
+- (void)testRequestBodyShouldNotSwallowThePipelinedRequest {
+    [self startServerWithOptions:nil];
+    int socket = [self connect];
+
+    [self send:@"POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\nContent-Length: 5\r\n\r\nhello"
+               @"GET /ping HTTP/1.1\r\nHost: localhost\r\n\r\n"
+            on:socket];
+    NSArray *responses = [self readResponses:2 from:socket];
+
+    XCTAssertEqual(responses.count, 2u);
+    XCTAssertTrue([responses.firstObject hasSuffix:@"\r\n\r\nhello"]);
+    XCTAssertTrue([responses.lastObject hasSuffix:@"\r\n\r\nok"]);
+
+    close(socket);
+}
+
+- (void)testConnectionCloseShouldCloseAfterTheResponse {
+    [self startServerWithOptions:nil];
+    int socket = [self connect];
+
+    [self send:@"GET /ping HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n" on:socket];
+    NSArray *responses = [self readResponses:1 from:socket];
+
+    XCTAssertEqual(responses.count, 1u);
+    XCTAssertTrue([responses.firstObject containsString:@"Connection: Close"]);
+    XCTAssertTrue([self isClosed:socket]);
+
+    close(socket);
+}
+
+- (void)testHTTP10ShouldOnlyBeKeptAliveWhenAsked {
+    [self startServerWithOptions:nil];
+
+    int socket = [self connect];
+    [self send:@"GET /ping HTTP/1.0\r\n\r\n" on:socket];
+    XCTAssertTrue([[self readResponses:1 from:socket].firstObject containsString:@"Connection: Close"]);
+    XCTAssertTrue([self isClosed:socket]);
+    close(socket);
+
+    socket = [self connect];
+    [self send:@"GET /ping HTTP/1.0\r\nConnection: keep-alive\r\n\r\n" on:socket];
+    XCTAssertTrue([[self readResponses:1 from:socket].firstObject containsString:@"Connection: keep-alive"]);
+    close(socket);
+}
+
+- (void)testIdleConnectionShouldBeClosedAfterTheTimeout {
+    [self startServerWithOptions:@{GCDWebServerOption_ConnectionKeepAliveTimeout: @0.2}];
+    int socket = [self connect];
+
+    [self send:kGetRequest on:socket];
+    NSArray *responses = [self readResponses:1 from:socket];
+
+    XCTAssertTrue([responses.firstObject containsString:@"Keep-Alive: timeout=1"]);
+    XCTAssertTrue([self isClosed:socket], @"The server should close the idle connection");
+
+    close(socket);
+}
+
+- (void)testZeroTimeoutShouldDisableKeepAlive {
+    [self startServerWithOptions:@{GCDWebServerOption_ConnectionKeepAliveTimeout: @0}];
+    int socket = [self connect];
+
+    [self send:kGetRequest on:socket];
+
+    XCTAssertTrue([[self readResponses:1 from:socket].firstObject containsString:@"Connection: Close"]);
+    XCTAssertTrue([self isClosed:socket]);
+
+    close(socket);
+}
+
+- (void)testConnectionsPastTheLimitShouldNotBeKeptAlive {
+    [self startServerWithOptions:@{GCDWebServerOption_MaxKeepAliveConnections: @1}];
+    int first = [self connect];
+    [self send:kGetRequest on:first];
+    XCTAssertTrue([[self readResponses:1 from:first].firstObject containsString:@"Connection: keep-alive"]);
+
+    int second = [self connect];
+    [self send:kGetRequest on:second];
+    XCTAssertTrue([[self readResponses:1 from:second].firstObject containsString:@"Connection: Close"],
+                  @"The idle first connection should count towards the limit");
+    XCTAssertTrue([self isClosed:second]);
+
+    close(first);
+    close(second);
+}
+
+- (void)testStoppingShouldCloseIdleConnections {
+    [self startServerWithOptions:@{GCDWebServerOption_ConnectionKeepAliveTimeout: @60}];
+    int socket = [self connect];
+
+    [self send:kGetRequest on:socket];
+    XCTAssertEqual([self readResponses:1 from:socket].count, 1u);
+
+    [self.server stop];
+
+    XCTAssertTrue([self isClosed:socket]);
+    close(socket);
+}
+
+#pragma mark - Load Tests
+
+/// Sends the requests one after the other over a single connection.
+- (void)testKeepAliveLoad {
+    [self startServerWithOptions:nil];
+
+    [self measureRequestsPerSecond:^{
+        int socket = [self connect];
+
+        for (NSUInteger i = 0; i < kLoadTestRequests; ++i) {
+            [self send:kGetRequest on:socket];
+            [self readResponses:1 from:socket];
+        }
+
+        close(socket);
+    } label:@"keep-alive"];
+}
+
+/// Opens a new connection for each request, which is what every client got
+/// before connections were kept alive.
+- (void)testConnectionPerRequestLoad {
+    [self startServerWithOptions:@{GCDWebServerOption_ConnectionKeepAliveTimeout: @0}];
+
+    [self measureRequestsPerSecond:^{
+        for (NSUInteger i = 0; i < kLoadTestRequests; ++i) {
+            int socket = [self connect];
+            [self send:kGetRequest on:socket];
+            [self readResponses:1 from:socket];
+            close(socket);
+        }
+    } label:@"connection per request"];
+}
+
+#pragma mark - Helpers
+
+- (void)startServerWithOptions:(NSDictionary *)options {
+    NSMutableDictionary *allOptions = [@{GCDWebServerOption_Port: @0,
+                                         GCDWebServerOption_BindToLocalhost: @YES,
+                                         GCDWebServerOption_AutomaticallySuspendInBackground: @NO,
+                                         GCDWebServerOption_ConnectedStateCoalescingInterval: @0} mutableCopy];
+    [allOptions addEntriesFromDictionary:options];
+
+    NSError *error;
+    XCTAssertTrue([self.server startWithOptions:allOptions error:&error], @"%@", error);
+}
+
+- (int)connect {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    struct timeval timeout = {.tv_sec = 2, .tv_usec = 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    int noSigPipe = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+
+    struct sockaddr_in address = {0};
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = htons(self.server.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    XCTAssertEqual(connect(fd, (struct sockaddr *)&address, sizeof(address)), 0);
+    return fd;
+}
+
+- (void)send:(NSString *)string on:(int)socket {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual(send(socket, data.bytes, data.length, 0), (ssize_t)data.length);
+}
+
+/// Reads until @c count complete responses have arrived, the connection is
+/// closed or nothing arrives for two seconds. Responses are returned with
+/// their body.
+- (NSArray *)readResponses:(NSUInteger)count from:(int)socket {
+    NSMutableData *buffer = [NSMutableData data];
+    NSMutableArray *responses = [NSMutableArray array];
+    NSData *separator = [@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+
+    while (responses.count < count) {
+        NSRange end = [buffer rangeOfData:separator options:0 range:NSMakeRange(0, buffer.length)];
+        if (end.location != NSNotFound) {
+            NSUInteger headerLength = NSMaxRange(end);
+            NSString *header = [[NSString alloc] initWithData:[buffer subdataWithRange:NSMakeRange(0, headerLength)]
+                                                     encoding:NSUTF8StringEncoding];
+            NSUInteger bodyLength = 0;
+            NSRange lengthRange = [header rangeOfString:@"Content-Length: "];
+            if (lengthRange.location != NSNotFound) {
+                bodyLength = (NSUInteger)[[header substringFromIndex:NSMaxRange(lengthRange)] integerValue];
+            }
+
+            if (buffer.length >= headerLength + bodyLength) {
+                NSData *body = [buffer subdataWithRange:NSMakeRange(headerLength, bodyLength)];
+                [responses addObject:[header stringByAppendingString:[[NSString alloc] initWithData:body
+                                                                                           encoding:NSUTF8StringEncoding]]];
+                [buffer replaceBytesInRange:NSMakeRange(0, headerLength + bodyLength) withBytes:NULL length:0];
+                continue;
+            }
+        }
+
+        char bytes[4096];
+        ssize_t received = recv(socket, bytes, sizeof(bytes), 0);
+        if (received <= 0) {
+            break;
+        }
+        [buffer appendBytes:bytes length:received];
+    }
+
+    return responses;
+}
+
+/// Returns @c YES if the server closes the connection within two seconds.
+- (BOOL)isClosed:(int)socket {
+    char byte;
+    return recv(socket, &byte, 1, 0) == 0;
+}
+
+- (void)measureRequestsPerSecond:(void (^)(void))block label:(NSString *)label {
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        block();
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+        NSLog(@"%@: %.0f requests/s", label, kLoadTestRequests / elapsed);
+    }];
+}
+
+@end
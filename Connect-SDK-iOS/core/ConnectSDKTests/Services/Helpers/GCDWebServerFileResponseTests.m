@@ -0,0 +1,301 @@
+//
+//  GCDWebServerFileResponseTests.m
+//  ConnectSDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "GCDWebServer.h"
+#import "GCDWebServerFileResponse.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/// Size of the file served by the tests. It spans several mapped windows.
+static const NSUInteger kTestFileSize = 64 * 1024 * 1024;
+
+/// The read() loop @c GCDWebServerFileResponse used before it mapped files.
+/// It's the baseline for the throughput benchmark.
+@interface BufferedFileResponse : GCDWebServerResponse
+
+- (instancetype)initWithFile:(NSString *)path;
+
+@end
+
+@implementation BufferedFileResponse {
+    NSString *_path;
+    int _file;
+}
+
+- (instancetype)initWithFile:(NSString *)path {
+    if (self = [super init]) {
+        _path = path;
+        self.contentType = @"application/octet-stream";
+        self.contentLength = (NSUInteger)[[[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil] fileSize];
+    }
+    return self;
+}
+
+- (BOOL)open:(NSError **)error {
+    _file = open(_path.fileSystemRepresentation, O_RDONLY);
+    return _file > 0;
+}
+
+- (NSData *)readData:(NSError **)error {
+    NSMutableData *data = [[NSMutableData alloc] initWithLength:32 * 1024];
+    ssize_t result = read(_file, data.mutableBytes, data.length);
+    data.length = MAX(result, 0);
+    return data;
+}
+
+- (void)close {
+    close(_file);
+}
+
+@end
+
+
+/// Tests for @c GCDWebServerFileResponse, which sends files as memory-mapped
+/// windows and serves byte ranges. The benchmarks download a file over
+/// loopback with the mapped response and with the old buffered one.
+@interface GCDWebServerFileResponseTests : XCTestCase
+
+@property (nonatomic, strong) GCDWebServer *server;
+@property (nonatomic, strong) NSString *path;
+
+@end
+
+@implementation GCDWebServerFileResponseTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"GCDWebServerFileResponseTests.mp4"];
+    if (![[NSFileManager defaultManager] fileExistsAtPath:self.path]) {
+        NSMutableData *contents = [NSMutableData dataWithLength:kTestFileSize];
+        arc4random_buf(contents.mutableBytes, contents.length);
+        [contents writeToFile:self.path atomically:YES];
+    }
+
+    NSString *path = self.path;
+    self.server = [GCDWebServer new];
+    [self.server addHandlerForMethod:@"GET"
+                                path:@"/mapped"
+                        requestClass:[GCDWebServerRequest class]
+                        processBlock:^GCDWebServerResponse *(GCDWebServerRequest *request) {
+                            return [GCDWebServerFileResponse responseWithFile:path forRequest:request isAttachment:NO];
+                        }];
+    [self.server addHandlerForMethod:@"GET"
+                                path:@"/buffered"
+                        requestClass:[GCDWebServerRequest class]
+                        processBlock:^GCDWebServerResponse *(GCDWebServerRequest *request) {
+                            return [[BufferedFileResponse alloc] initWithFile:path];
+                        }];
+
+    NSError *error;
+    XCTAssertTrue([self.server startWithOptions:@{GCDWebServerOption_Port: @0,
+                                                  GCDWebServerOption_BindToLocalhost: @YES,
+                                                  GCDWebServerOption_AutomaticallySuspendInBackground: @NO}
+                                          error:&error], @"%@", error);
+}
+
+- (void)tearDown {
+    [self.server stop];
+    self.server = nil;
+
+    [super tearDown];
+}
+
+#pragma mark - Response Tests
+
+- (void)testWholeFileShouldBeSentIntact {
+    NSString *header;
+    NSData *body = [self download:@"/mapped" headers:nil responseHeader:&header];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 200"]);
+    XCTAssertEqual(body.length, kTestFileSize);
+    XCTAssertEqualObjects(body, [NSData dataWithContentsOfFile:self.path]);
+}
+
+- (void)testUnalignedRangeShouldBeSentIntact {
+    NSRange range = NSMakeRange(4097, 5 * 1024 * 1024);
+    NSString *header = [NSString stringWithFormat:@"Range: bytes=%lu-%lu",
+                        (unsigned long)range.location, (unsigned long)NSMaxRange(range) - 1];
+
+    NSData *body = [self download:@"/mapped" headers:header responseHeader:nil];
+
+    XCTAssertEqualObjects(body, [[NSData dataWithContentsOfFile:self.path] subdataWithRange:range],
+                          @"A range that starts inside a page and spans two windows should map correctly");
+}
+
+#pragma mark - Range Tests
+
+- (void)testRangeHeaderShouldParseEveryRange {
+    GCDWebServerRequest *request = [self requestWithRange:@"bytes=0-499, 1000-, -200"];
+
+    NSArray *expected = @[[NSValue valueWithRange:NSMakeRange(0, 500)],
+                          [NSValue valueWithRange:NSMakeRange(1000, NSUIntegerMax)],
+                          [NSValue valueWithRange:NSMakeRange(NSUIntegerMax, 200)]];
+    XCTAssertEqualObjects(request.byteRanges, expected);
+    XCTAssertFalse(request.hasByteRange, @"byteRange should only be set for a single range");
+}
+
+- (void)testMalformedRangeHeaderShouldBeIgnored {
+    XCTAssertNil([self requestWithRange:@"bytes=0-499,abc-"].byteRanges);
+    XCTAssertNil([self requestWithRange:@"bytes=500-100"].byteRanges);
+    XCTAssertNil([self requestWithRange:@"items=0-1"].byteRanges);
+    XCTAssertFalse([self requestWithRange:@"bytes=-0"].hasByteRange);
+}
+
+- (void)testSeveralRangesShouldBeSentAsMultipart {
+    NSString *header;
+    NSData *body = [self download:@"/mapped" headers:@"Range: bytes=0-9,-10" responseHeader:&header];
+    NSData *file = [NSData dataWithContentsOfFile:self.path];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 206"]);
+    NSRange boundaryRange = [header rangeOfString:@"Content-Type: multipart/byteranges; boundary="];
+    XCTAssertNotEqual(boundaryRange.location, NSNotFound);
+    NSString *boundary = [[header substringFromIndex:NSMaxRange(boundaryRange)] componentsSeparatedByString:@"\r\n"].firstObject;
+
+    NSMutableData *expected = [NSMutableData data];
+    NSString *(^part)(NSUInteger, NSUInteger) = ^(NSUInteger first, NSUInteger last) {
+        return [NSString stringWithFormat:@"Content-Type: video/mp4\r\nContent-Range: bytes %lu-%lu/%lu\r\n\r\n",
+                (unsigned long)first, (unsigned long)last, (unsigned long)kTestFileSize];
+    };
+    [expected appendData:[[NSString stringWithFormat:@"--%@\r\n%@", boundary, part(0, 9)] dataUsingEncoding:NSUTF8StringEncoding]];
+    [expected appendData:[file subdataWithRange:NSMakeRange(0, 10)]];
+    [expected appendData:[[NSString stringWithFormat:@"\r\n--%@\r\n%@", boundary, part(kTestFileSize - 10, kTestFileSize - 1)] dataUsingEncoding:NSUTF8StringEncoding]];
+    [expected appendData:[file subdataWithRange:NSMakeRange(kTestFileSize - 10, 10)]];
+    [expected appendData:[[NSString stringWithFormat:@"\r\n--%@--\r\n", boundary] dataUsingEncoding:NSUTF8StringEncoding]];
+
+    XCTAssertEqualObjects(body, expected);
+    XCTAssertTrue([header containsString:[NSString stringWithFormat:@"Content-Length: %lu", (unsigned long)expected.length]]);
+}
+
+- (void)testOverlappingRangesShouldBeCoalesced {
+    NSString *header;
+    NSData *body = [self download:@"/mapped" headers:@"Range: bytes=50-149, 0-99" responseHeader:&header];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 206"]);
+    XCTAssertTrue([header containsString:[NSString stringWithFormat:@"Content-Range: bytes 0-149/%lu", (unsigned long)kTestFileSize]]);
+    XCTAssertEqual(body.length, 150u);
+}
+
+- (void)testUnsatisfiableRangeShouldBeRejected {
+    NSString *header;
+    NSString *range = [NSString stringWithFormat:@"Range: bytes=%lu-", (unsigned long)kTestFileSize];
+    NSData *body = [self download:@"/mapped" headers:range responseHeader:&header];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 416"]);
+    XCTAssertTrue([header containsString:[NSString stringWithFormat:@"Content-Range: bytes */%lu", (unsigned long)kTestFileSize]]);
+    XCTAssertEqual(body.length, 0u);
+}
+
+- (void)testMatchingIfRangeShouldHonorTheRange {
+    NSString *eTag = [GCDWebServerFileResponse responseWithFile:self.path].eTag;
+    NSString *headers = [NSString stringWithFormat:@"Range: bytes=0-99\r\nIf-Range: %@", eTag];
+
+    NSString *header;
+    NSData *body = [self download:@"/mapped" headers:headers responseHeader:&header];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 206"]);
+    XCTAssertTrue([header containsString:[NSString stringWithFormat:@"ETag: %@", eTag]]);
+    XCTAssertEqual(body.length, 100u);
+}
+
+- (void)testStaleIfRangeShouldSendTheWholeFile {
+    NSString *header;
+    NSData *body = [self download:@"/mapped"
+                          headers:@"Range: bytes=0-99\r\nIf-Range: \"0-0-0\""
+                   responseHeader:&header];
+
+    XCTAssertTrue([header hasPrefix:@"HTTP/1.1 200"]);
+    XCTAssertEqual(body.length, kTestFileSize);
+}
+
+#pragma mark - Throughput Tests
+
+- (void)testMappedThroughput {
+    [self measureThroughputOf:@"/mapped"];
+}
+
+- (void)testBufferedThroughput {
+    [self measureThroughputOf:@"/buffered"];
+}
+
+#pragma mark - Helpers
+
+- (void)measureThroughputOf:(NSString *)path {
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        NSUInteger length = [self download:path headers:nil responseHeader:nil].length;
+        CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+
+        XCTAssertEqual(length, kTestFileSize);
+        NSLog(@"%@: %.0f MB/s", path, length / elapsed / (1024 * 1024));
+    }];
+}
+
+- (GCDWebServerRequest *)requestWithRange:(NSString *)range {
+    return [[GCDWebServerRequest alloc] initWithMethod:@"GET"
+                                                   url:[NSURL URLWithString:@"http://localhost/mapped"]
+                                               headers:@{@"Range": range}
+                                                  path:@"/mapped"
+                                                 query:nil];
+}
+
+/// Downloads @c path on a new connection and returns the response body. The
+/// status line and headers are returned in @c responseHeader.
+- (NSData *)download:(NSString *)path headers:(NSString *)headers responseHeader:(NSString **)responseHeader {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct timeval timeout = {.tv_sec = 5, .tv_usec = 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in address = {0};
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = htons(self.server.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    XCTAssertEqual(connect(fd, (struct sockaddr *)&address, sizeof(address)), 0);
+
+    NSString *request = [NSString stringWithFormat:@"GET %@ HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n%@\r\n",
+                         path, headers ? [headers stringByAppendingString:@"\r\n"] : @""];
+    NSData *requestData = [request dataUsingEncoding:NSUTF8StringEncoding];
+    send(fd, requestData.bytes, requestData.length, 0);
+
+    NSMutableData *response = [NSMutableData dataWithCapacity:kTestFileSize + 1024];
+    char buffer[64 * 1024];
+    ssize_t received;
+    while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        [response appendBytes:buffer length:received];
+    }
+    close(fd);
+
+    NSData *separator = [@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSRange end = [response rangeOfData:separator options:0 range:NSMakeRange(0, MIN(response.length, 4096u))];
+    if (end.location == NSNotFound) {
+        return nil;
+    }
+
+    if (responseHeader) {
+        *responseHeader = [[NSString alloc] initWithData:[response subdataWithRange:NSMakeRange(0, NSMaxRange(end))]
+                                                encoding:NSUTF8StringEncoding];
+    }
+
+    return [response subdataWithRange:NSMakeRange(NSMaxRange(end), response.length - NSMaxRange(end))];
+}
+
+@end
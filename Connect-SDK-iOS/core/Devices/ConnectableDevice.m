@@ -18,7 +18,8 @@
 //  limitations under the License.
 //
 
-#import "ConnectableDevice.h"
+#import "ConnectableDevice_Private.h"
+#import "CapabilitySet.h"
 #import "DLNAService.h"
 #import "MediaControl.h"
 #import "ExternalInputControl.h"
@@ -30,6 +31,9 @@
 @implementation ConnectableDevice
 {
     NSMutableDictionary *_services;
+
+    CapabilitySet *_capabilitySet;
+    NSUInteger _capabilityGeneration;
 }
 
 @synthesize serviceDescription = _consolidatedServiceDescription;
@@ -206,8 +210,6 @@
                 [service connect];
         }];
     }
-
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(disconnect) name:kConnectSDKWirelessSSIDChanged object:nil];
 }
 
 - (void) disconnect
@@ -218,8 +220,6 @@
             [service disconnect];
     }];
 
-    [[NSNotificationCenter defaultCenter] removeObserver:self name:kConnectSDKWirelessSSIDChanged object:nil];
-
     dispatch_on_main(^{ [self.delegate connectableDeviceDisconnected:self withError:nil]; });
 }
 
@@ -288,7 +288,7 @@
 {
     DeviceService *existingService = [_services objectForKey:service.serviceName];
 
-    NSArray *oldCapabilities = self.capabilities;
+    CapabilitySet *oldCapabilities = self.capabilitySet;
 
     if (existingService)
     {
@@ -329,7 +329,7 @@
     if (service == nil)
         return;
 
-    NSArray *oldCapabilities = self.capabilities;
+    CapabilitySet *oldCapabilities = self.capabilitySet;
 
     [service disconnect];
 
@@ -338,26 +338,18 @@
     [self updateCapabilitiesList:oldCapabilities];
 }
 
-- (void) updateCapabilitiesList:(NSArray *)oldCapabilities
+- (void) updateCapabilitiesList:(CapabilitySet *)oldCapabilities
 {
-    NSArray *newCapabilities = self.capabilities;
-
-    NSMutableArray *removedCapabilities = [NSMutableArray new];
-
-    [oldCapabilities enumerateObjectsUsingBlock:^(NSString *capability, NSUInteger idx, BOOL *stop) {
-        if (![newCapabilities containsObject:capability])
-            [removedCapabilities addObject:capability];
-    }];
+    CapabilitySet *newCapabilities;
 
-    NSMutableArray *addedCapabilities = [NSMutableArray new];
-
-    [newCapabilities enumerateObjectsUsingBlock:^(NSString *capability, NSUInteger idx, BOOL *stop) {
-        if (![oldCapabilities containsObject:capability])
-            [addedCapabilities addObject:capability];
-    }];
+    @synchronized (self)
+    {
+        [self updateCapabilitySet];
+        newCapabilities = _capabilitySet;
+    }
 
-    NSArray *added = [NSArray arrayWithArray:addedCapabilities];
-    NSArray *removed = [NSArray arrayWithArray:removedCapabilities];
+    NSArray *added = [newCapabilities setBySubtractingSet:oldCapabilities].capabilities;
+    NSArray *removed = [oldCapabilities setBySubtractingSet:newCapabilities].capabilities;
 
     if (self.delegate && [self.delegate respondsToSelector:@selector(connectableDevice:capabilitiesAdded:removed:)])
         dispatch_on_main(^{ [self.delegate connectableDevice:self capabilitiesAdded:added removed:removed]; });
@@ -484,68 +476,55 @@
 
 #pragma mark - Capabilities
 
-- (NSArray *) capabilities
+- (CapabilitySet *) capabilitySet
 {
-    NSMutableArray *caps = [NSMutableArray new];
-
-    [self.services enumerateObjectsUsingBlock:^(DeviceService *service, NSUInteger serviceIdx, BOOL *serviceStop)
+    @synchronized (self)
     {
-        [service.capabilities enumerateObjectsUsingBlock:^(NSString *capability, NSUInteger capabilityIdx, BOOL *capabilityStop)
-        {
-            if (![caps containsObject:capability])
-                [caps addObject:capability];
-        }];
-    }];
+        if (!_capabilitySet || _capabilityGeneration != CapabilityGeneration())
+            [self updateCapabilitySet];
 
-    return [NSArray arrayWithArray:caps];
+        return _capabilitySet;
+    }
 }
 
-- (BOOL) hasCapability:(NSString *)capability
+/// Must be called while synchronized on self.
+- (void) updateCapabilitySet
 {
-    __block BOOL hasCap = NO;
+    // Read the generation first so a change made while the services are being
+    // read leaves the set marked as stale
+    NSUInteger generation = CapabilityGeneration();
+    CapabilitySet *capabilitySet = [CapabilitySet emptySet];
 
-    [self.services enumerateObjectsUsingBlock:^(DeviceService *service, NSUInteger idx, BOOL *stop)
-    {
-        if ([service hasCapability:capability])
-        {
-            hasCap = YES;
-            *stop = YES;
-        }
-    }];
+    for (DeviceService *service in self.services)
+        capabilitySet = [capabilitySet setByAddingSet:[CapabilitySet setWithCapabilities:service.capabilities]];
 
-    return hasCap;
+    _capabilitySet = capabilitySet;
+    _capabilityGeneration = generation;
 }
 
-- (BOOL) hasCapabilities:(NSArray *)capabilities
+- (NSArray *) capabilities
 {
-    __block BOOL hasCaps = YES;
+    return self.capabilitySet.capabilities;
+}
 
-    [capabilities enumerateObjectsUsingBlock:^(NSString *capability, NSUInteger idx, BOOL *stop)
-    {
-        if (![self hasCapability:capability])
-        {
-            hasCaps = NO;
-            *stop = YES;
-        }
-    }];
+- (BOOL) hasCapability:(NSString *)capability
+{
+    if (!capability)
+        return NO;
 
-    return hasCaps;
+    return [self hasCapabilities:@[capability]];
 }
 
-- (BOOL) hasAnyCapability:(NSArray *)capabilities
+- (BOOL) hasCapabilities:(NSArray *)capabilities
 {
-    __block BOOL hasCap = NO;
-
-    [self.services enumerateObjectsUsingBlock:^(DeviceService *service, NSUInteger idx, BOOL *stop)
-    {
-        if ([service hasAnyCapability:capabilities])
-        {
-            hasCap = YES;
-            *stop = YES;
-        }
-    }];
+    CapabilityRequirement *requirement = [CapabilityRequirement sharedRequirementWithCapabilities:capabilities];
+    return [requirement isSatisfiedBySet:self.capabilitySet];
+}
 
-    return hasCap;
+- (BOOL) hasAnyCapability:(NSArray *)capabilities
+{
+    CapabilityRequirement *requirement = [CapabilityRequirement sharedRequirementWithCapabilities:capabilities];
+    return [requirement isPartlySatisfiedBySet:self.capabilitySet];
 }
 
 - (id<Launcher>) launcher
@@ -18,10 +18,14 @@
 //  limitations under the License.
 //
 
-#import "CapabilityFilter.h"
+#import "CapabilityFilter_Private.h"
+#import "CapabilitySet.h"
 
 
 @implementation CapabilityFilter
+{
+    CapabilityRequirement *_requirement;
+}
 
 - (instancetype) init
 {
@@ -46,11 +50,21 @@
 - (void)addCapability:(NSString *)capability
 {
     _capabilities = [_capabilities arrayByAddingObject:capability];
+    _requirement = nil;
 }
 
 - (void)addCapabilities:(NSArray *)capabilities
 {
     _capabilities = [_capabilities arrayByAddingObjectsFromArray:capabilities];
+    _requirement = nil;
+}
+
+- (CapabilityRequirement *)requirement
+{
+    if (!_requirement)
+        _requirement = [CapabilityRequirement requirementWithCapabilities:_capabilities];
+
+    return _requirement;
 }
 
 @end
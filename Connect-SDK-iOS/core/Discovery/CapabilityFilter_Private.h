@@ -0,0 +1,30 @@
+//
+//  CapabilityFilter_Private.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CapabilityFilter.h"
+
+@class CapabilityRequirement;
+
+@interface CapabilityFilter ()
+
+/// The filter's capabilities compiled for matching against a CapabilitySet.
+@property (nonatomic, readonly) CapabilityRequirement *requirement;
+
+@end
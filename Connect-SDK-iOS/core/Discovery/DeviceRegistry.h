@@ -0,0 +1,55 @@
+//
+//  DeviceRegistry.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ConnectableDevice;
+
+/// An immutable view of the registry at one point in time. Both dictionaries
+/// map device addresses to ConnectableDevice objects.
+@interface DeviceRegistrySnapshot : NSObject
+
+@property (nonatomic, readonly) NSDictionary *allDevices;
+
+/// The subset of @c allDevices that matches the capability filters.
+@property (nonatomic, readonly) NSDictionary *compatibleDevices;
+
+@end
+
+/// Copy-on-write store for the devices DiscoveryManager knows about.
+///
+/// Readers take the current snapshot, which is never mutated, so they don't
+/// wait for discovery callbacks. Writers are serialized; each update works on
+/// mutable copies and publishes them together as a new snapshot, so a reader
+/// never sees a device in @c compatibleDevices that isn't in @c allDevices.
+@interface DeviceRegistry : NSObject
+
+/// The most recently published snapshot.
+@property (atomic, strong, readonly) DeviceRegistrySnapshot *snapshot;
+
+/// Runs @c block with mutable copies of the current dictionaries and publishes
+/// them when it returns. Returns whatever the block returns. The block must
+/// not call back into the registry.
+- (id)update:(id (^)(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices))block;
+
+/// Publishes an empty snapshot and returns the one it replaced.
+- (DeviceRegistrySnapshot *)removeAllDevices;
+
+@end
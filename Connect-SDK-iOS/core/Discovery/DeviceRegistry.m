@@ -0,0 +1,102 @@
+//
+//  DeviceRegistry.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DeviceRegistry.h"
+
+@interface DeviceRegistrySnapshot ()
+
+- (instancetype)initWithAllDevices:(NSDictionary *)allDevices
+                 compatibleDevices:(NSDictionary *)compatibleDevices;
+
+@end
+
+@implementation DeviceRegistrySnapshot
+
+- (instancetype)initWithAllDevices:(NSDictionary *)allDevices
+                 compatibleDevices:(NSDictionary *)compatibleDevices
+{
+    self = [super init];
+
+    if (self)
+    {
+        _allDevices = [allDevices copy];
+        _compatibleDevices = [compatibleDevices copy];
+    }
+
+    return self;
+}
+
+@end
+
+@interface DeviceRegistry ()
+
+@property (atomic, strong, readwrite) DeviceRegistrySnapshot *snapshot;
+
+@end
+
+@implementation DeviceRegistry
+{
+    NSObject *_writeLock;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+
+    if (self)
+    {
+        _writeLock = [NSObject new];
+        _snapshot = [[DeviceRegistrySnapshot alloc] initWithAllDevices:@{}
+                                                     compatibleDevices:@{}];
+    }
+
+    return self;
+}
+
+- (id)update:(id (^)(NSMutableDictionary *, NSMutableDictionary *))block
+{
+    @synchronized (_writeLock)
+    {
+        DeviceRegistrySnapshot *current = self.snapshot;
+        NSMutableDictionary *allDevices = [current.allDevices mutableCopy];
+        NSMutableDictionary *compatibleDevices = [current.compatibleDevices mutableCopy];
+
+        id result = block(allDevices, compatibleDevices);
+
+        self.snapshot = [[DeviceRegistrySnapshot alloc] initWithAllDevices:allDevices
+                                                         compatibleDevices:compatibleDevices];
+
+        return result;
+    }
+}
+
+- (DeviceRegistrySnapshot *)removeAllDevices
+{
+    @synchronized (_writeLock)
+    {
+        DeviceRegistrySnapshot *previous = self.snapshot;
+        self.snapshot = [[DeviceRegistrySnapshot alloc] initWithAllDevices:@{}
+                                                         compatibleDevices:@{}];
+
+        return previous;
+    }
+}
+
+@end
@@ -171,6 +171,11 @@
  */
 @property (nonatomic, readonly) BOOL useDeviceStore;
 
+/*!
+ * Whether devices in the deviceStore are looked for directly when discovery starts. Devices that were last seen on the current Wi-Fi network are probed at their last known IP address while the normal multicast discovery begins, so they can appear without waiting for multicast responses. Defaults to NO.
+ */
+@property (nonatomic) BOOL fastStartEnabled;
+
 // @cond INTERNAL
 
 @property (nonatomic, readonly) NSDictionary *deviceClasses;
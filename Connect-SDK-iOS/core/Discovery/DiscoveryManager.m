@@ -28,16 +28,42 @@
 #import "DLNAService.h"
 #import "NetcastTVService.h"
 
-#import "ConnectableDevice.h"
+#import "ConnectableDevice_Private.h"
 #import "DefaultConnectableDeviceStore.h"
 #import "ServiceDescription.h"
 #import "ServiceConfig.h"
 #import "ServiceConfigDelegate.h"
-#import "CapabilityFilter.h"
+#import "CapabilityFilter_Private.h"
+#import "CapabilitySet.h"
+#import "DeviceRegistry.h"
 
 #import "AppStateChangeNotifier.h"
+#import "NetworkChangeNotifier.h"
+#import "NSMutableDictionary+NilSafe.h"
+#import "TimingWheel.h"
 
-#import <SystemConfiguration/CaptiveNetwork.h>
+/// Most stored devices probed when discovery starts in fast-start mode.
+static const NSUInteger kMaxFastStartDevices = 16;
+
+static NSString *const kNetworkChangeTimerName = @"networkChange";
+static NSString *const kPurgeTimerName = @"purge";
+
+/// How long the network has to stay quiet before the SSID is checked.
+static const NSTimeInterval kNetworkChangeSettleTime = 2;
+
+/// How long devices have to answer on a new network before they're dropped.
+/// This covers the MX of the first SSDP searches.
+static const NSTimeInterval kPurgeGracePeriod = 8;
+
+/// When a stored device was last detected or connected to.
+static double lastSeenTime(NSDictionary *storedDevice)
+{
+    id lastDetection = storedDevice[@"lastDetection"];
+    id lastConnected = storedDevice[@"lastConnected"];
+
+    return MAX([lastDetection isKindOfClass:[NSNumber class]] ? [lastDetection doubleValue] : 0,
+               [lastConnected isKindOfClass:[NSNumber class]] ? [lastConnected doubleValue] : 0);
+}
 
 @interface DiscoveryManager() <DiscoveryProviderDelegate, ServiceConfigDelegate>
 
@@ -45,15 +71,13 @@
 
 @implementation DiscoveryManager
 {
-    NSMutableDictionary *_allDevices;
-    NSMutableDictionary *_compatibleDevices;
+    DeviceRegistry *_registry;
 
     BOOL _shouldResumeSearch;
     BOOL _searching;
     
     DevicePicker *_currentPicker;
 
-    NSTimer *_ssidTimer;
     NSString *_currentSSID;
 }
 
@@ -99,12 +123,18 @@
 }
 
 - (instancetype)init {
-    return [self initWithAppStateChangeNotifier:nil];
+    return [self initWithAppStateChangeNotifier:nil networkChangeNotifier:nil];
 }
 
 #pragma mark - Private Init
 
 - (instancetype) initWithAppStateChangeNotifier:(nullable AppStateChangeNotifier *)stateNotifier
+{
+    return [self initWithAppStateChangeNotifier:stateNotifier networkChangeNotifier:nil];
+}
+
+- (instancetype) initWithAppStateChangeNotifier:(nullable AppStateChangeNotifier *)stateNotifier
+                          networkChangeNotifier:(nullable NetworkChangeNotifier *)networkNotifier
 {
     self = [super init];
     
@@ -117,8 +147,7 @@
         _discoveryProviders = [[NSMutableArray alloc] init];
         _deviceClasses = [[NSMutableDictionary alloc] init];
 
-        _allDevices = [[NSMutableDictionary alloc] init];
-        _compatibleDevices = [[NSMutableDictionary alloc] init];
+        _registry = [[DeviceRegistry alloc] init];
 
         _appStateChangeNotifier = stateNotifier ?: [AppStateChangeNotifier new];
         __weak typeof(self) wself = self;
@@ -131,12 +160,26 @@
             [sself resumeDiscovery];
         };
 
-        [self startSSIDTimer];
+        _timingWheel = [TimingWheel sharedWheel];
+        _networkChangeNotifier = networkNotifier ?: [NetworkChangeNotifier new];
+        _networkChangeNotifier.didChangeBlock = ^{
+            typeof(self) sself = wself;
+            [sself networkDidChange];
+        };
+
+        [self startNetworkMonitoring];
     }
     
     return self;
 }
 
+- (void) dealloc
+{
+    // Timers are keyed by owner, so don't leave any behind for a later object
+    [_networkChangeNotifier stopListening];
+    [_timingWheel cancelAllTimersForOwner:self];
+}
+
 #pragma mark - Setup & Registration
 
 - (void) registerDefaultServices
@@ -242,74 +285,106 @@
 
 #pragma mark - Wireless SSID Change Detection
 
-- (void) startSSIDTimer
+- (void) startNetworkMonitoring
 {
-    _ssidTimer = [NSTimer scheduledTimerWithTimeInterval:1 target:self selector:@selector(detectSSIDChange) userInfo:nil repeats:YES];
-    [_ssidTimer fire];
+    [self.networkChangeNotifier startListening];
+
+    // Changes made while we weren't listening, such as in the background,
+    // aren't reported
+    [self detectSSIDChange];
 }
 
-- (void) stopSSIDTimer
+- (void) stopNetworkMonitoring
 {
-    [_ssidTimer invalidate];
-    _ssidTimer = nil;
+    [self.networkChangeNotifier stopListening];
+    [self.timingWheel cancelTimerForOwner:self name:kNetworkChangeTimerName];
 }
 
-- (void) detectSSIDChange
+- (void) networkDidChange
 {
-    NSArray *interfaces = (__bridge_transfer id) CNCopySupportedInterfaces();
+    // Changes come in bursts while an interface comes up, so only look at the
+    // SSID once they have settled
+    __weak typeof(self) wself = self;
+    [self.timingWheel scheduleTimerForOwner:self
+                                       name:kNetworkChangeTimerName
+                                 afterDelay:kNetworkChangeSettleTime
+                                      block:^{ [wself detectSSIDChange]; }];
+}
 
-    __block NSString *ssidName;
+- (void) detectSSIDChange
+{
+    NSString *ssidName = [self.networkChangeNotifier currentSSID];
 
-    [interfaces enumerateObjectsUsingBlock:^(NSString *interface, NSUInteger idx, BOOL *stop)
+    if ([ssidName caseInsensitiveCompare:_currentSSID] != NSOrderedSame)
     {
-        if ([interface caseInsensitiveCompare:@"en0"] != NSOrderedSame)
-            return;
-
-        NSDictionary *info = (__bridge_transfer id) CNCopyCurrentNetworkInfo ((__bridge CFStringRef) interface);
+        BOOL changed = (_currentSSID != nil);
 
-        if (info && [info objectForKey:@"SSID"])
-        {
-            ssidName = [info objectForKey:@"SSID"];
-            *stop = YES;
-        }
-    }];
-
-    if (ssidName == nil)
-        ssidName = @"";
+        // Set first so that devices found again are recorded against the new
+        // network
+        _currentSSID = ssidName;
 
-    if ([ssidName caseInsensitiveCompare:_currentSSID] != NSOrderedSame)
-    {
-        if (_currentSSID != nil)
+        if (changed)
         {
             [self purgeDeviceList];
 
             [[NSNotificationCenter defaultCenter] postNotificationName:kConnectSDKWirelessSSIDChanged object:nil];
         }
-
-        _currentSSID = ssidName;
     }
 }
 
 - (void) purgeDeviceList
 {
-    [self.compatibleDevices enumerateKeysAndObjectsUsingBlock:^(id key, ConnectableDevice *device, BOOL *stop)
-    {
-        [device disconnect];
-        
-        if (self.delegate)
-            [self.delegate discoveryManager:self didLoseDevice:device];
+    NSTimeInterval purgeTime = [[NSDate date] timeIntervalSince1970];
+    NSArray *addresses = [_registry.snapshot.allDevices allKeys];
 
-        if (self.devicePicker)
-            [self.devicePicker discoveryManager:self didLoseDevice:device];
-    }];
-    
     [_discoveryProviders enumerateObjectsUsingBlock:^(DiscoveryProvider *provider, NSUInteger idx, BOOL *stop) {
         [provider stopDiscovery];
         [provider startDiscovery];
+        [provider probeAddresses:addresses];
     }];
 
-    _allDevices = [NSMutableDictionary new];
-    _compatibleDevices = [NSMutableDictionary new];
+    // Devices that can still be reached are found again and kept, without
+    // being lost and found by the delegate. The rest are dropped once they
+    // have had time to answer.
+    __weak typeof(self) wself = self;
+    [self.timingWheel scheduleTimerForOwner:self
+                                       name:kPurgeTimerName
+                                 afterDelay:kPurgeGracePeriod
+                                      block:^{ [wself removeDevicesNotDetectedSince:purgeTime]; }];
+}
+
+- (void) removeDevicesNotDetectedSince:(NSTimeInterval)time
+{
+    __block NSDictionary *lostDevices;
+
+    [_registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices)
+    {
+        NSMutableArray *lostAddresses = [NSMutableArray new];
+        NSMutableDictionary *lostCompatibleDevices = [NSMutableDictionary new];
+
+        [allDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
+        {
+            if (device.lastDetection >= time)
+                return;
+
+            [lostAddresses addObject:address];
+            [lostCompatibleDevices setNullableObject:compatibleDevices[address] forKey:address];
+        }];
+
+        [allDevices removeObjectsForKeys:lostAddresses];
+        [compatibleDevices removeObjectsForKeys:lostAddresses];
+        lostDevices = lostCompatibleDevices;
+
+        return nil;
+    }];
+
+    DLog(@"Dropped %lu devices that weren't found on the new network", (unsigned long)lostDevices.count);
+
+    [lostDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
+    {
+        [device disconnect];
+        [self handleDeviceLoss:device];
+    }];
 }
 
 #pragma mark - Capability Filtering
@@ -318,31 +393,36 @@
 {
     _capabilityFilters = capabilityFilters;
 
-    @synchronized (_compatibleDevices)
+    __block NSDictionary *lostDevices;
+
+    // Refilter and publish in one step so readers see either the old or the
+    // new compatible devices, never a mix
+    NSDictionary *foundDevices = [_registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices)
     {
-        [_compatibleDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
+        lostDevices = [compatibleDevices copy];
+        [compatibleDevices removeAllObjects];
+
+        [allDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
         {
-            if (self.delegate)
-                [self.delegate discoveryManager:self didLoseDevice:device];
+            if ([self deviceIsCompatible:device])
+                [compatibleDevices setObject:device forKey:address];
         }];
-    }
-
-    _compatibleDevices = [[NSMutableDictionary alloc] init];
 
-    NSArray *allDevices;
-
-    @synchronized (_allDevices) { allDevices = [_allDevices allValues]; }
+        return [compatibleDevices copy];
+    }];
 
-    [allDevices enumerateObjectsUsingBlock:^(ConnectableDevice *device, NSUInteger idx, BOOL *stop)
+    if (self.delegate)
     {
-        if ([self deviceIsCompatible:device])
+        [lostDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
         {
-            @synchronized (_compatibleDevices) { [_compatibleDevices setValue:device forKey:device.address]; }
+            [self.delegate discoveryManager:self didLoseDevice:device];
+        }];
 
-            if (self.delegate)
-                [self.delegate discoveryManager:self didFindDevice:device];
-        }
-    }];
+        [foundDevices enumerateKeysAndObjectsUsingBlock:^(NSString *address, ConnectableDevice *device, BOOL *stop)
+        {
+            [self.delegate discoveryManager:self didFindDevice:device];
+        }];
+    }
 }
 
 - (BOOL) descriptionIsNetcastTV:(ServiceDescription *)description
@@ -364,12 +444,12 @@
 
 - (NSDictionary *) allDevices
 {
-    return [NSDictionary dictionaryWithDictionary:_allDevices];
+    return _registry.snapshot.allDevices;
 }
 
 - (NSDictionary *)compatibleDevices
 {
-    return [NSDictionary dictionaryWithDictionary:_compatibleDevices];
+    return _registry.snapshot.compatibleDevices;
 }
 
 - (BOOL) deviceIsCompatible:(ConnectableDevice *)device
@@ -377,18 +457,15 @@
     if (!_capabilityFilters || _capabilityFilters.count == 0)
         return YES;
 
-    __block BOOL isCompatible = NO;
+    CapabilitySet *capabilitySet = device.capabilitySet;
 
-    [self.capabilityFilters enumerateObjectsUsingBlock:^(CapabilityFilter *filter, NSUInteger idx, BOOL *stop)
+    for (CapabilityFilter *filter in _capabilityFilters)
     {
-        if ([device hasCapabilities:filter.capabilities])
-        {
-            isCompatible = YES;
-            *stop = YES;
-        }
-    }];
+        if ([filter.requirement isSatisfiedBySet:capabilitySet])
+            return YES;
+    }
 
-    return isCompatible;
+    return NO;
 }
 
 - (void) handleDeviceAdd:(ConnectableDevice *)device
@@ -396,8 +473,12 @@
     if (![self deviceIsCompatible:device])
         return;
 
-    @synchronized (_compatibleDevices) { [_compatibleDevices setValue:device forKey:device.address]; }
+    [self setDevice:device compatible:YES];
+    [self notifyDeviceFound:device];
+}
 
+- (void) notifyDeviceFound:(ConnectableDevice *)device
+{
     if (self.delegate)
         [self.delegate discoveryManager:self didFindDevice:device];
 
@@ -409,29 +490,50 @@
 {
     [self.deviceStore updateDevice:device];
 
-    if ([self deviceIsCompatible:device])
+    BOOL isCompatible = [self deviceIsCompatible:device];
+    BOOL wasCompatible = [self setDevice:device compatible:isCompatible];
+
+    if (isCompatible && wasCompatible)
     {
-        @synchronized (_compatibleDevices) {
-            if ([_compatibleDevices objectForKey:device.address])
-            {
-                if (self.delegate)
-                    [self.delegate discoveryManager:self didUpdateDevice:device];
+        if (self.delegate)
+            [self.delegate discoveryManager:self didUpdateDevice:device];
 
-                if (_currentPicker)
-                    [_currentPicker discoveryManager:self didUpdateDevice:device];
-            } else
-            {
-                [self handleDeviceAdd:device];
-            }
-        }
+        if (_currentPicker)
+            [_currentPicker discoveryManager:self didUpdateDevice:device];
+    } else if (isCompatible)
+    {
+        [self notifyDeviceFound:device];
     } else
     {
-        @synchronized (_compatibleDevices) { [_compatibleDevices removeObjectForKey:device.address]; }
-
         [self handleDeviceLoss:device];
     }
 }
 
+/// Adds the device to or removes it from the compatible devices, and returns
+/// whether it was there before.
+- (BOOL) setDevice:(ConnectableDevice *)device compatible:(BOOL)compatible
+{
+    NSString *address = device.address;
+
+    if (!address)
+        return NO;
+
+    NSNumber *wasCompatible = [_registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices)
+    {
+        BOOL found = [compatibleDevices objectForKey:address] != nil;
+
+        // The device may have been removed since the caller looked it up
+        if (compatible && [allDevices.allValues indexOfObjectIdenticalTo:device] != NSNotFound)
+            [compatibleDevices setObject:device forKey:address];
+        else if (!compatible)
+            [compatibleDevices removeObjectForKey:address];
+
+        return @(found);
+    }];
+
+    return wasCompatible.boolValue;
+}
+
 - (void) handleDeviceLoss:(ConnectableDevice *)device
 {
     if (self.delegate)
@@ -459,6 +561,11 @@
         [self registerDefaultServices];
 
     _searching = YES;
+
+    // Probes go out before the providers start, so known devices can answer
+    // while the first multicast searches are still waiting out their MX
+    if (self.fastStartEnabled)
+        [self probeStoredDevices];
     
     [_discoveryProviders enumerateObjectsUsingBlock:^(DiscoveryProvider *service, NSUInteger idx, BOOL *stop) {
         [service startDiscovery];
@@ -484,10 +591,10 @@
     }
 }
 
-/// Pauses all discovery providers and the SSID change timer.
+/// Pauses all discovery providers and network change monitoring.
 - (void)pauseDiscovery {
     // moved from -hAppDidEnterBackground:
-    [self stopSSIDTimer];
+    [self stopNetworkMonitoring];
 
     if (_searching)
     {
@@ -498,10 +605,10 @@
     }
 }
 
-/// Resumes all discovery providers and the SSID change timer.
+/// Resumes all discovery providers and network change monitoring.
 - (void)resumeDiscovery {
     // moved from -hAppDidBecomeActive:
-    [self startSSIDTimer];
+    [self startNetworkMonitoring];
 
     if (_shouldResumeSearch)
     {
@@ -518,28 +625,47 @@
 {
     DLog(@"%@ (%@)", description.friendlyName, description.serviceId);
 
-    BOOL deviceIsNew = [_allDevices objectForKey:description.address] == nil;
-    ConnectableDevice *device;
+    NSString *address = description.address;
+    __block BOOL deviceIsNew = NO;
 
-    if (deviceIsNew)
-    {
-        if (self.useDeviceStore)
-        {
-            device = [self.deviceStore deviceForId:description.UUID];
+    // Known devices are found without touching the write path
+    ConnectableDevice *device = [_registry.snapshot.allDevices objectForKey:address];
 
-            if (device)
-                @synchronized (_allDevices) { [_allDevices setObject:device forKey:description.address]; }
-        }
-    } else
+    // Another device can take over the address, most often after moving to a
+    // different network, so the old one is lost rather than merged into
+    if (device && ![self device:device matchesServiceDescription:description])
     {
-        @synchronized (_allDevices) { device = [_allDevices objectForKey:description.address]; }
+        DLog(@"Device at address %@ has been replaced", address);
+
+        [self removeDevice:device forAddress:address];
+        [self handleDeviceLoss:device];
+
+        device = nil;
     }
 
     if (!device)
     {
-        device = [ConnectableDevice connectableDeviceWithDescription:description];
-        @synchronized (_allDevices) { [_allDevices setObject:device forKey:description.address]; }
-        deviceIsNew = YES;
+        device = [_registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices)
+        {
+            // Another provider may have added it since the snapshot was taken
+            ConnectableDevice *existingDevice = [allDevices objectForKey:address];
+
+            if (existingDevice)
+                return existingDevice;
+
+            ConnectableDevice *newDevice;
+
+            if (self.useDeviceStore)
+                newDevice = [self.deviceStore deviceForId:description.UUID];
+
+            if (!newDevice)
+                newDevice = [ConnectableDevice connectableDeviceWithDescription:description];
+
+            [allDevices setObject:newDevice forKey:address];
+            deviceIsNew = YES;
+
+            return newDevice;
+        }];
     }
 
     device.lastDetection = [[NSDate date] timeIntervalSince1970];
@@ -552,8 +678,7 @@
     {
         // we get here when a non-LG DLNA TV is found
 
-        [_allDevices removeObjectForKey:description.address];
-        device = nil;
+        [self removeDevice:device forAddress:address];
 
         return;
     }
@@ -568,10 +693,8 @@
 {
     DLog(@"%@ (%@)", description.friendlyName, description.serviceId);
     
-    ConnectableDevice *device;
+    ConnectableDevice *device = [_registry.snapshot.allDevices objectForKey:description.address];
 
-    @synchronized (_allDevices) { device = [_allDevices objectForKey:description.address]; }
-    
     if (device)
     {
         [device removeServiceWithId:description.serviceId];
@@ -583,8 +706,7 @@
         {
             DLog(@"Device at address %@ has been orphaned (has no services)", description.address);
 
-            @synchronized (_allDevices) { [_allDevices removeObjectForKey:description.address]; }
-            @synchronized (_compatibleDevices) { [_compatibleDevices removeObjectForKey:description.address]; }
+            [self removeDevice:device forAddress:description.address];
 
             [self handleDeviceLoss:device];
         } else
@@ -601,6 +723,35 @@
 
 #pragma mark - Helper methods
 
+/// Removes the device from both lists, unless another device has taken its
+/// address in the meantime.
+- (void) removeDevice:(ConnectableDevice *)device forAddress:(NSString *)address
+{
+    [_registry update:^id(NSMutableDictionary *allDevices, NSMutableDictionary *compatibleDevices)
+    {
+        if ([allDevices objectForKey:address] == device)
+        {
+            [allDevices removeObjectForKey:address];
+            [compatibleDevices removeObjectForKey:address];
+        }
+
+        return nil;
+    }];
+}
+
+/// Whether the description can belong to the device. A service of a type the
+/// device already has must have the same UUID.
+- (BOOL) device:(ConnectableDevice *)device matchesServiceDescription:(ServiceDescription *)description
+{
+    for (DeviceService *service in device.services)
+    {
+        if ([service.serviceDescription.serviceId isEqualToString:description.serviceId])
+            return [service.serviceDescription.UUID isEqualToString:description.UUID];
+    }
+
+    return YES;
+}
+
 - (void) addServiceDescription:(ServiceDescription *)description toDevice:(ConnectableDevice *)device
 {
     Class deviceServiceClass = [_deviceClasses objectForKey:description.serviceId];
@@ -676,25 +827,87 @@
 
 #pragma mark - Device Store
 
+- (void) probeStoredDevices
+{
+    NSArray *addresses = [self storedDeviceAddressesForSSID:[self.networkChangeNotifier currentSSID]];
+
+    if (addresses.count == 0)
+        return;
+
+    DLog(@"Probing %lu stored devices", (unsigned long)addresses.count);
+
+    [_discoveryProviders makeObjectsPerformSelector:@selector(probeAddresses:) withObject:addresses];
+}
+
+/// Returns the last known addresses of stored devices, most recently seen
+/// first. Devices last seen on a different network are left out; if either
+/// network is unknown the device is included.
+- (NSArray *) storedDeviceAddressesForSSID:(NSString *)ssid
+{
+    if (!self.useDeviceStore)
+        return nil;
+
+    NSMutableArray *devices = [NSMutableArray new];
+
+    [self.deviceStore.storedDevices enumerateKeysAndObjectsUsingBlock:^(id key, NSDictionary *device, BOOL *stop)
+    {
+        if (![device isKindOfClass:[NSDictionary class]])
+            return;
+
+        NSString *address = device[@"lastKnownIPAddress"];
+        NSString *lastSeenOnWifi = device[@"lastSeenOnWifi"];
+
+        if (![address isKindOfClass:[NSString class]] || address.length == 0)
+            return;
+
+        if (ssid.length > 0 && [lastSeenOnWifi isKindOfClass:[NSString class]] && lastSeenOnWifi.length > 0 &&
+            [lastSeenOnWifi caseInsensitiveCompare:ssid] != NSOrderedSame)
+            return;
+
+        [devices addObject:device];
+    }];
+
+    [devices sortUsingComparator:^NSComparisonResult(NSDictionary *device1, NSDictionary *device2)
+    {
+        double lastSeen1 = lastSeenTime(device1);
+        double lastSeen2 = lastSeenTime(device2);
+
+        if (lastSeen1 == lastSeen2)
+            return NSOrderedSame;
+
+        return lastSeen1 > lastSeen2 ? NSOrderedAscending : NSOrderedDescending;
+    }];
+
+    NSMutableOrderedSet *addresses = [NSMutableOrderedSet new];
+
+    for (NSDictionary *device in devices)
+    {
+        [addresses addObject:device[@"lastKnownIPAddress"]];
+
+        if (addresses.count == kMaxFastStartDevices)
+            break;
+    }
+
+    return addresses.array;
+}
+
 - (ConnectableDevice *) lookupMatchingDeviceForDeviceStore:(ServiceConfig *)serviceConfig
 {
     __block ConnectableDevice *foundDevice;
 
-    @synchronized (_allDevices) {
-        [_allDevices enumerateKeysAndObjectsUsingBlock:^(id key, ConnectableDevice *device, BOOL *deviceStop)
+    [_registry.snapshot.allDevices enumerateKeysAndObjectsUsingBlock:^(id key, ConnectableDevice *device, BOOL *deviceStop)
+    {
+        [device.services enumerateObjectsUsingBlock:^(DeviceService *service, NSUInteger serviceIdx, BOOL *serviceStop)
         {
-            [device.services enumerateObjectsUsingBlock:^(DeviceService *service, NSUInteger serviceIdx, BOOL *serviceStop)
+            if ([service.serviceConfig.UUID isEqualToString:serviceConfig.UUID])
             {
-                if ([service.serviceConfig.UUID isEqualToString:serviceConfig.UUID])
-                {
-                    foundDevice = device;
-
-                    *serviceStop = YES;
-                    *deviceStop = YES;
-                }
-            }];
+                foundDevice = device;
+
+                *serviceStop = YES;
+                *deviceStop = YES;
+            }
         }];
-    }
+    }];
 
     return foundDevice;
 }
@@ -22,6 +22,8 @@
 
 @class AppStateChangeNotifier;
 @class DiscoveryProvider;
+@class NetworkChangeNotifier;
+@class TimingWheel;
 
 NS_ASSUME_NONNULL_BEGIN
 @interface DiscoveryManager ()
@@ -29,11 +31,23 @@ NS_ASSUME_NONNULL_BEGIN
 /// An @c AppStateChangeNotifier that allows to track app state changes.
 @property (nonatomic, readonly) AppStateChangeNotifier *appStateChangeNotifier;
 
+/// A @c NetworkChangeNotifier that reports network configuration changes.
+@property (nonatomic, readonly) NetworkChangeNotifier *networkChangeNotifier;
+
+/// The wheel that runs the network change and purge timers. Defaults to the
+/// shared wheel.
+@property (nonatomic, strong) TimingWheel *timingWheel;
+
 
 /// Initializes the instance with the given @c AppStateChangeNotifier. Using
 /// @c nil parameter will create real object.
 - (instancetype)initWithAppStateChangeNotifier:(nullable AppStateChangeNotifier *)stateNotifier;
 
+/// Initializes the instance with the given notifiers. Using @c nil for either
+/// will create the real object.
+- (instancetype)initWithAppStateChangeNotifier:(nullable AppStateChangeNotifier *)stateNotifier
+                         networkChangeNotifier:(nullable NetworkChangeNotifier *)networkNotifier;
+
 /**
  * Registers a service with the given @c deviceClass and a @c DiscoveryProvider
  * created by the @c providerFactory.
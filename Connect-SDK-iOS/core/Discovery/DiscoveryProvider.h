@@ -82,4 +82,13 @@
  */
 - (void)resumeDiscovery;
 
+/**
+ * Looks for services at the given IP addresses directly, rather than waiting
+ * for them to answer a multicast search. DiscoveryManager uses this to find
+ * devices from the device store quickly. Does nothing by default.
+ *
+ * @param addresses IP addresses of devices that may still be on the network
+ */
+- (void)probeAddresses:(NSArray *)addresses;
+
 @end
@@ -37,4 +37,6 @@
     [self startDiscovery];
 }
 
+- (void)probeAddresses:(NSArray *)addresses { }
+
 @end
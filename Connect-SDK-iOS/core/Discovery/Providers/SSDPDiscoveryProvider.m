@@ -20,16 +20,28 @@
 
 #import <UIKit/UIKit.h>
 #import "SSDPDiscoveryProvider_Private.h"
+#import "SSDPPacketParser.h"
+#import "SSDPDescriptionCache.h"
+#import "SSDPSearchPlanner.h"
+#import "TimingWheel.h"
 #import "ServiceDescription.h"
 #import "CTXMLReader.h"
 #import "DeviceService.h"
 #import "CommonMacros.h"
+#import "NSMutableDictionary+NilSafe.h"
 
 #import <sys/utsname.h>
 
 #define kSSDP_multicast_address @"239.255.255.250"
 #define kSSDP_port 1900
 
+static NSString *const kSearchTimerName = @"search";
+static NSString *const kExpiryTimerPrefix = @"expire:";
+
+/// Unicast probes are sent a second time after this long, in case the first
+/// one was dropped.
+static const NSTimeInterval kProbeRetryDelay = 0.3;
+
 // credit: http://stackoverflow.com/a/1108927/2715
 NSString* machineName()
 {
@@ -44,10 +56,9 @@ NSString* machineName()
     NSString *_ssdpHostName;
 
     NSArray *_serviceFilters;
+    NSArray *_serviceFilterTypes;
     NSMutableDictionary *_foundServices;
 
-    NSTimer *_refreshTimer;
-
     NSMutableDictionary *_helloDevices;
     NSOperationQueue *_locationLoadQueue;
 }
@@ -71,9 +82,13 @@ static double searchAttemptsBeforeKill = 6.0;
 
         _foundServices = [[NSMutableDictionary alloc] init];
         _serviceFilters = [[NSMutableArray alloc] init];
+        _serviceFilterTypes = [[NSArray alloc] init];
         
         _locationLoadQueue = [[NSOperationQueue alloc] init];
         _locationLoadQueue.maxConcurrentOperationCount = 10;
+
+        _descriptionCache = [SSDPDescriptionCache sharedCache];
+        _searchPlanner = [SSDPSearchPlanner new];
         
         self.isRunning = NO;
     }
@@ -102,8 +117,7 @@ static double searchAttemptsBeforeKill = 6.0;
     if (_multicastSocket)
         [_multicastSocket close];
 
-    if (_refreshTimer)
-        [_refreshTimer invalidate];
+    [[TimingWheel sharedWheel] cancelAllTimersForOwner:self];
     
     _foundServices = [NSMutableDictionary new];
     _helloDevices = [NSMutableDictionary new];
@@ -113,16 +127,26 @@ static double searchAttemptsBeforeKill = 6.0;
     
     _searchSocket = nil;
     _multicastSocket = nil;
-    _refreshTimer = nil;
+}
+
+- (void) dealloc
+{
+    [[TimingWheel sharedWheel] cancelAllTimersForOwner:self];
 }
 
 - (void) start
 {
-    if (_refreshTimer == nil)
+    TimingWheel *wheel = [TimingWheel sharedWheel];
+
+    if (![wheel hasTimerForOwner:self name:kSearchTimerName])
     {
-        _refreshTimer = [NSTimer scheduledTimerWithTimeInterval:refreshTime target:self selector:@selector(sendSearchRequests:) userInfo:nil repeats:YES];
-        
-        [self sendSearchRequests:NO];
+        __weak typeof(self) weakSelf = self;
+        [wheel scheduleRepeatingTimerForOwner:self
+                                         name:kSearchTimerName
+                                     interval:refreshTime
+                                        block:^{ [weakSelf sendSearchRequests]; }];
+
+        [self sendSearchRequests];
     }
 }
 
@@ -137,6 +161,7 @@ static double searchAttemptsBeforeKill = 6.0;
     _assert_state(searchFilter != nil, @"The ssdp info for this device filter has no search filter parameter");
 
     _serviceFilters = [_serviceFilters arrayByAddingObject:parameters];
+    [self updateServiceFilterTypes];
 }
 
 - (void)removeDeviceFilter:(NSDictionary *)parameters
@@ -161,69 +186,88 @@ static double searchAttemptsBeforeKill = 6.0;
         NSMutableArray *mutableFilters = [NSMutableArray arrayWithArray:_serviceFilters];
         [mutableFilters removeObjectAtIndex:removalIndex];
         _serviceFilters = [NSArray arrayWithArray:mutableFilters];
+        [self updateServiceFilterTypes];
     }
 }
 
-#pragma mark - SSDP M-SEARCH Request
-
-- (void) sendSearchRequests:(BOOL)shouldKillInactiveDevices
+/// Keeps the UTF-8 bytes of every search filter so that incoming packets can
+/// be matched without creating strings.
+- (void)updateServiceFilterTypes
 {
-    [_serviceFilters enumerateObjectsUsingBlock:^(NSDictionary *info, NSUInteger idx, BOOL *stop) {
-        NSDictionary *ssdpInfo = [info objectForKey:@"ssdp"];
-        NSString *searchFilter = [ssdpInfo objectForKey:@"filter"];
-        NSString *userAgentToken = [ssdpInfo objectForKey:@"userAgentToken"];
-        
-        [self sendRequestForFilter:searchFilter userAgentToken:userAgentToken killInactiveDevices:shouldKillInactiveDevices];
-    }];
-}
+    NSMutableArray *types = [NSMutableArray arrayWithCapacity:_serviceFilters.count];
 
-- (void) sendRequestForFilter:(NSString *)filter userAgentToken:(NSString *)userAgentToken killInactiveDevices:(BOOL)shouldKillInactiveDevices
-{
-    if (shouldKillInactiveDevices)
+    for (NSDictionary *serviceFilter in _serviceFilters)
     {
-        BOOL refresh = NO;
-        NSMutableArray *killKeys = [NSMutableArray array];
-        
-        // 6 detection attempts, if still not present then kill it.
-        double killPoint = [[NSDate date] timeIntervalSince1970] - (refreshTime * searchAttemptsBeforeKill);
+        NSString *ssdpFilter = [[serviceFilter objectForKey:@"ssdp"] objectForKey:@"filter"];
+        NSData *type = [ssdpFilter dataUsingEncoding:NSUTF8StringEncoding];
 
-        @synchronized (_foundServices)
-        {
-            for (NSString *key in _foundServices)
-            {
-                ServiceDescription *service = (ServiceDescription *) [_foundServices objectForKey:key];
+        if (type && ![types containsObject:type])
+            [types addObject:type];
+    }
 
-                if (service.lastDetection < killPoint)
-                {
-                    [killKeys addObject:key];
-                    refresh = YES;
-                }
-            }
+    _serviceFilterTypes = [NSArray arrayWithArray:types];
+}
 
-            if (refresh)
-            {
-                [killKeys enumerateObjectsUsingBlock:^(id key, NSUInteger idx, BOOL *stop)
-                {
-                    ServiceDescription *service = [_foundServices objectForKey:key];
+#pragma mark - SSDP M-SEARCH Request
 
-                    [self notifyDelegateOfLostService:service];
+- (void) sendSearchRequests
+{
+    DLog(@"SSDP searches: %lu packets sent, %lu responses received, %lu matching",
+         (unsigned long) _searchPlanner.packetsSent,
+         (unsigned long) _searchPlanner.responsesReceived,
+         (unsigned long) _searchPlanner.matchingResponsesReceived);
 
-                    [_foundServices removeObjectForKey:key];
-                }];
-            }
+    NSArray *searches = [_searchPlanner searchesForFilters:_serviceFilters];
+
+    [searches enumerateObjectsUsingBlock:^(SSDPSearch *search, NSUInteger idx, BOOL *stop) {
+        NSData *message = [self messageForSearch:search toHost:nil];
+
+        for (NSNumber *delay in [_searchPlanner sendDelaysForSearchAtIndex:idx])
+        {
+            if (delay.doubleValue > 0)
+                [self performBlock:^{ [self sendSearchMessage:message]; } afterDelay:delay.doubleValue];
+            else
+                [self sendSearchMessage:message];
         }
-    }
-    
+    }];
+}
+
+/// Builds an M-SEARCH for the multicast group, or for a single device if
+/// @c host is given. Unicast searches have no MX, as devices answer them
+/// straight away.
+- (NSData *) messageForSearch:(SSDPSearch *)search toHost:(NSString *)host
+{
+    NSString *userAgentToken = search.userAgentTokens.count > 0 ? [search.userAgentTokens componentsJoinedByString:@" "] : nil;
+    NSString *hostName = host ? [NSString stringWithFormat:@"%@:%d", host, kSSDP_port] : _ssdpHostName;
+
     CFHTTPMessageRef theSearchRequest = CFHTTPMessageCreateRequest(NULL, CFSTR("M-SEARCH"),
                                                                    (__bridge  CFURLRef)[NSURL URLWithString: @"*"], kCFHTTPVersion1_1);
-    CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("HOST"), (__bridge  CFStringRef) _ssdpHostName);
+    CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("HOST"), (__bridge  CFStringRef) hostName);
     CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("MAN"), CFSTR("\"ssdp:discover\""));
-    CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("MX"), CFSTR("5"));
-    CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("ST"),  (__bridge  CFStringRef)filter);
+
+    if (!host)
+    {
+        NSString *mx = [NSString stringWithFormat:@"%lu", (unsigned long) _searchPlanner.mx];
+        CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("MX"), (__bridge CFStringRef)mx);
+    }
+
+    CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("ST"),  (__bridge  CFStringRef)search.target);
     CFHTTPMessageSetHeaderFieldValue(theSearchRequest, CFSTR("USER-AGENT"), (__bridge CFStringRef)[self userAgentForToken:userAgentToken]);
 
     NSData *message = CFBridgingRelease(CFHTTPMessageCopySerializedMessage(theSearchRequest));
-    
+
+    CFRelease(theSearchRequest);
+
+    return message;
+}
+
+- (void) sendSearchMessage:(NSData *)message
+{
+    [self sendSearchMessage:message toAddress:kSSDP_multicast_address];
+}
+
+- (void) sendSearchMessage:(NSData *)message toAddress:(NSString *)address
+{
     if (!_searchSocket)
     {
 		_searchSocket = [[SSDPSocketListener alloc] initWithAddress:kSSDP_multicast_address andPort:0];
@@ -238,171 +282,312 @@ static double searchAttemptsBeforeKill = 6.0;
         [_multicastSocket open];
     }
 
-    [_searchSocket sendData:message toAddress:kSSDP_multicast_address andPort:kSSDP_port];
-    [self performBlock:^{ [_searchSocket sendData:message toAddress:kSSDP_multicast_address andPort:kSSDP_port]; } afterDelay:1];
-    [self performBlock:^{ [_searchSocket sendData:message toAddress:kSSDP_multicast_address andPort:kSSDP_port]; } afterDelay:2];
-    
-    CFRelease(theSearchRequest);
+    [_searchSocket sendData:message toAddress:address andPort:kSSDP_port];
+    [_searchPlanner recordPacketSent];
+}
+
+#pragma mark - Unicast Probes
+
+- (void) probeAddresses:(NSArray *)addresses
+{
+    NSArray *searches = [_searchPlanner searchesForFilters:_serviceFilters];
+
+    for (NSString *address in addresses)
+    {
+        for (SSDPSearch *search in searches)
+        {
+            NSData *message = [self messageForSearch:search toHost:address];
+
+            [self sendSearchMessage:message toAddress:address];
+            [self performBlock:^{ [self sendSearchMessage:message toAddress:address]; } afterDelay:kProbeRetryDelay];
+        }
+    }
 }
 
 #pragma mark - M-SEARCH Response Processing
 
+//* Everything that arrived since the socket last woke up, in arrival order
+- (void)socket:(SSDPSocketListener *)aSocket didReceiveDatagrams:(NSArray *)datagrams
+{
+    for (SSDPDatagram *datagram in datagrams)
+        [self socket:aSocket didReceiveData:datagram.data fromAddress:datagram.address];
+}
+
 //* UDPSocket-delegate-method handle anew messages
 //* All messages from devices handling here
 - (void)socket:(SSDPSocketListener *)aSocket didReceiveData:(NSData *)aData fromAddress:(NSString *)anAddress
 {
-    // Try to create a HTTPMessage from received data.
-    
-	CFHTTPMessageRef theHTTPMessage = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, TRUE);
-	CFHTTPMessageAppendBytes(theHTTPMessage, aData.bytes, aData.length);
+    // The datagram is scanned in place, and anything we aren't searching for
+    // is dropped before a single object is created.
+    SSDPPacket packet;
 
     // We awaiting for receiving a complete header. If it not - just skip it.
-	if (CFHTTPMessageIsHeaderComplete(theHTTPMessage))
-	{
-        
-        // Receive some important data from the header
-		NSString *theRequestMethod = CFBridgingRelease (CFHTTPMessageCopyRequestMethod(theHTTPMessage));
-		NSInteger theCode = CFHTTPMessageGetResponseStatusCode(theHTTPMessage);
-		NSDictionary *theHeaderDictionary = CFBridgingRelease(CFHTTPMessageCopyAllHeaderFields(theHTTPMessage));
-        
-		BOOL isNotify = [theRequestMethod isEqualToString:@"NOTIFY"];
-		NSString *theType = (isNotify) ? theHeaderDictionary[@"NT"] : theHeaderDictionary[@"ST"];
-        
-        // There is 3 possible methods in SSDP:
-        // 1) M-SEARCH - for search requests - skip it
-        // 2) NOTIFY - for devices notification: advertisements ot bye-bye
-        // 3) * with CODE 200 - answer for M-SEARCH request
-        
-        // Obtain a unique service id ID - USN.
-        NSString *theUSSNKey = theHeaderDictionary[@"USN"];
-
-        if ((theCode == 200) &&
-            ![theRequestMethod isEqualToString:@"M-SEARCH"] &&
-            [self isSearchingForFilter:theType] &&
-            (theUSSNKey.length > 0))
+    if (!SSDPPacketParse(aData.bytes, aData.length, &packet))
+        return;
+
+    if (packet.kind == SSDPPacketKindResponse)
+        [_searchPlanner recordResponseMatchingFilter:[self isSearchingForType:packet.st]];
+
+    // There is 3 possible methods in SSDP:
+    // 1) M-SEARCH - for search requests - skip it
+    // 2) NOTIFY - for devices notification: advertisements ot bye-bye
+    // 3) * with CODE 200 - answer for M-SEARCH request
+    if (!SSDPPacketIsAnnouncement(&packet) ||
+        ![self isSearchingForType:SSDPPacketType(&packet)] ||
+        packet.usn.length == 0 ||
+        packet.uuid.length == 0)
+        return;
+
+    NSString *theUUID = SSDPHeaderValueCopyString(packet.uuid);
+    NSString *theType = SSDPHeaderValueCopyString(SSDPPacketType(&packet));
+
+    if (theUUID.length == 0)
+        return;
+
+    // If it is a NOTIFY - byebye message - try to find a device from a list and send him byebye
+    if (SSDPPacketIsByeBye(&packet))
+    {
+        @synchronized (_foundServices)
         {
-            //Extract the UUID
-            NSRegularExpression *reg = [[NSRegularExpression alloc] initWithPattern:@"(?:uuid:).*(?:::)" options:0 error:nil];
-            NSString *theUUID;
-            NSTextCheckingResult *match = [reg firstMatchInString:theUSSNKey options:0 range:NSMakeRange(0, [theUSSNKey length])];
-            
-            NSRange range = [match rangeAtIndex:0];
-            range.location = range.location + 5;
-            range.length = MIN(range.length - 7, (theUSSNKey.length -range.location));
-            theUUID = [theUSSNKey substringWithRange:range];
-            
-            if (theUUID && theUUID.length > 0)
+            ServiceDescription *theService = _foundServices[theUUID];
+
+            if (theService != nil)
             {
-                // If it is a NOTIFY - byebye message - try to find a device from a list and send him byebye
-                if ([theHeaderDictionary[@"NTS"] isEqualToString:@"ssdp:byebye"])
-                {
-                    @synchronized (_foundServices)
-                    {
-                        ServiceDescription *theService = _foundServices[theUUID];
+                [self notifyDelegateOfLostService:theService];
+
+                [_foundServices removeObjectForKey:theUUID];
+
+                theService = nil;
+            }
+        }
+
+        [[TimingWheel sharedWheel] cancelTimerForOwner:self name:[kExpiryTimerPrefix stringByAppendingString:theUUID]];
+    } else
+    {
+        NSString *location = SSDPHeaderValueCopyString(packet.location);
+
+        if (location && location.length > 0)
+        {
+            // Advertising or search-respond
+            // Try to figure out if the device has been dicovered yet
+            ServiceDescription *foundService;
+            ServiceDescription *helloService;
 
-                        if (theService != nil)
-                        {
-                            [self notifyDelegateOfLostService:theService];
+            @synchronized(_foundServices) { foundService = [_foundServices objectForKey:theUUID]; }
+            @synchronized(_helloDevices) { helloService = [_helloDevices objectForKey:theUUID]; }
 
-                            [_foundServices removeObjectForKey:theUUID];
+            BOOL isNew = NO;
+
+            // If it isn't  - create a new device object and add it to device list
+            if (foundService == nil && helloService == nil)
+            {
+                foundService = [[ServiceDescription alloc] init];
+                //Check that this is what is wanted
+                foundService.UUID = theUUID;
+                foundService.type =  theType;
+                foundService.address = anAddress;
+                foundService.port = 3001;
+                isNew = YES;
+            }
 
-                            theService = nil;
-                        }
-                    }
-                } else
+            foundService.lastDetection = [[NSDate date] timeIntervalSince1970];
+            [self scheduleExpiryForUUID:theUUID maxAge:SSDPPacketMaxAge(&packet)];
+
+            // If device - newly-created one notify about it's discovering
+            if (isNew)
+            {
+                @synchronized (_helloDevices)
                 {
-                    NSString *location = [theHeaderDictionary objectForKey:@"Location"];
-
-                    if (location && location.length > 0)
-                    {
-                        // Advertising or search-respond
-                        // Try to figure out if the device has been dicovered yet
-                        ServiceDescription *foundService;
-                        ServiceDescription *helloService;
-
-                        @synchronized(_foundServices) { foundService = [_foundServices objectForKey:theUUID]; }
-                        @synchronized(_helloDevices) { helloService = [_helloDevices objectForKey:theUUID]; }
-
-                        BOOL isNew = NO;
-
-                        // If it isn't  - create a new device object and add it to device list
-                        if (foundService == nil && helloService == nil)
-                        {
-                            foundService = [[ServiceDescription alloc] init];
-                            //Check that this is what is wanted
-                            foundService.UUID = theUUID;
-                            foundService.type =  theType;
-                            foundService.address = anAddress;
-                            foundService.port = 3001;
-                            isNew = YES;
-                        }
-
-                        foundService.lastDetection = [[NSDate date] timeIntervalSince1970];
-
-                        // If device - newly-created one notify about it's discovering
-                        if (isNew)
-                        {
-                            @synchronized (_helloDevices)
-                            {
-                                if (_helloDevices == nil)
-                                    _helloDevices = [NSMutableDictionary dictionary];
-
-                                [_helloDevices setObject:foundService forKey:theUUID];
-                            }
-
-                            [self getLocationData:location forKey:theUUID andType:theType];
-                        }
-                    }
+                    if (_helloDevices == nil)
+                        _helloDevices = [NSMutableDictionary dictionary];
+
+                    [_helloDevices setObject:foundService forKey:theUUID];
                 }
+
+                [self getLocationData:location
+                               forKey:theUUID
+                              andType:theType
+                               bootId:SSDPHeaderValueCopyString(packet.bootId)
+                             configId:SSDPHeaderValueCopyString(packet.configId)];
             }
-		}
-	}
-    
-	CFRelease(theHTTPMessage);
+        }
+    }
 }
 
-- (void) getLocationData:(NSString*)url forKey:(NSString*)UUID andType:(NSString *)theType
+- (void) getLocationData:(NSString*)url forKey:(NSString*)UUID andType:(NSString *)theType bootId:(NSString *)bootId configId:(NSString *)configId
 {
+    SSDPDescriptionCacheEntry *entry = [self.descriptionCache entryForUUID:UUID location:url configId:configId];
+
+    // A known device that hasn't rebooted or changed its description is
+    // announced without downloading anything
+    if (entry && ![self.descriptionCache entryNeedsRevalidation:entry bootId:bootId])
+    {
+        [_locationLoadQueue addOperationWithBlock:^{
+            [self foundDescription:entry forKey:UUID andType:theType];
+        }];
+        return;
+    }
+
     NSURL *req = [NSURL URLWithString:url];
-    NSURLRequest *request = [NSURLRequest requestWithURL:req];
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:req];
+
+    if (entry)
+    {
+        request.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+
+        if (entry.eTag)
+            [request setValue:entry.eTag forHTTPHeaderField:@"If-None-Match"];
+
+        if (entry.lastModified)
+            [request setValue:entry.lastModified forHTTPHeaderField:@"If-Modified-Since"];
+    }
+
     [NSURLConnection sendAsynchronousRequest:request queue:_locationLoadQueue completionHandler:^(NSURLResponse *response, NSData *data, NSError *connectionError) {
-        NSError *xmlError;
-        NSDictionary *xml = [CTXMLReader dictionaryForXMLData:data error:&xmlError];
+        NSHTTPURLResponse *httpResponse = [response isKindOfClass:[NSHTTPURLResponse class]] ? (NSHTTPURLResponse *)response : nil;
+        NSInteger statusCode = httpResponse.statusCode;
 
-        if (!xmlError)
+        if (entry && statusCode == 304)
         {
-            NSDictionary *device = [self device:[xml valueForKeyPath:@"root.device"]
-                   containingServicesWithFilter:theType];
+            // Still the same description, it just needed checking
+            [self.descriptionCache revalidateEntry:entry bootId:bootId forUUID:UUID];
+            [self foundDescription:entry forKey:UUID andType:theType];
+            return;
+        }
 
-            if (device)
-            {
-                ServiceDescription *service;
-                @synchronized(_helloDevices) { service = [_helloDevices objectForKey:UUID]; }
+        SSDPDescriptionCacheEntry *current;
+        NSDictionary *description;
 
-                if (service)
-                {
-                    service.type = theType;
-                    service.friendlyName = [device valueForKeyPath:@"friendlyName.text"];
-                    service.modelName = [[device objectForKey:@"modelName"] objectForKey:@"text"];
-                    service.modelNumber = [[device objectForKey:@"modelNumber"] objectForKey:@"text"];
-                    service.modelDescription = [[device objectForKey:@"modelDescription"] objectForKey:@"text"];
-                    service.manufacturer = [[device objectForKey:@"manufacturer"] objectForKey:@"text"];
-                    service.locationXML = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-                    service.serviceList = [self serviceListForDevice:device];
-                    service.commandURL = response.URL;
-                    service.locationResponseHeaders = [((NSHTTPURLResponse *)response) allHeaderFields];
-
-                    @synchronized(_foundServices) { [_foundServices setObject:service forKey:UUID]; }
-
-                    [self notifyDelegateOfNewService:service];
-                }
-            }
+        // Error pages and descriptions that can't be read are never cached,
+        // or the device wouldn't be announced until the entry expired
+        if (!connectionError && statusCode >= 200 && statusCode < 300 && data.length > 0)
+        {
+            current = [[SSDPDescriptionCacheEntry alloc] initWithLocation:url response:httpResponse data:data];
+            current.bootId = bootId;
+            current.configId = configId;
+
+            description = [self descriptionFromXML:current.locationXML forType:theType];
+        }
+
+        if (description)
+        {
+            [current setDescription:description forType:theType];
+            [self.descriptionCache setEntry:current forUUID:UUID];
+            [self foundDescription:current forKey:UUID andType:theType];
+        } else
+        {
+            [self.descriptionCache removeEntryForUUID:UUID];
+            @synchronized(_helloDevices) { [_helloDevices removeObjectForKey:UUID]; }
         }
-        
-        @synchronized(_helloDevices) { [_helloDevices removeObjectForKey:UUID]; }
     }];
 }
 
+/// Fills in the waiting service for the UUID from a description and announces
+/// it. The description is only parsed the first time it's used for a type.
+- (void) foundDescription:(SSDPDescriptionCacheEntry *)entry forKey:(NSString *)UUID andType:(NSString *)theType
+{
+    NSDictionary *description = [entry descriptionForType:theType];
+
+    if (!description)
+    {
+        description = [self descriptionFromXML:entry.locationXML forType:theType];
+
+        if (description)
+        {
+            [entry setDescription:description forType:theType];
+            [self.descriptionCache setEntry:entry forUUID:UUID];
+        }
+    }
+
+    // An empty description means nothing in it matched the type
+    if (description.count > 0)
+    {
+        ServiceDescription *service;
+        @synchronized(_helloDevices) { service = [_helloDevices objectForKey:UUID]; }
+
+        if (service)
+        {
+            service.type = theType;
+            service.friendlyName = description[@"friendlyName"];
+            service.modelName = description[@"modelName"];
+            service.modelNumber = description[@"modelNumber"];
+            service.modelDescription = description[@"modelDescription"];
+            service.manufacturer = description[@"manufacturer"];
+            service.locationXML = entry.locationXML;
+            service.serviceList = description[@"serviceList"];
+            service.commandURL = entry.commandURL;
+            service.locationResponseHeaders = entry.responseHeaders;
+
+            @synchronized(_foundServices) { [_foundServices setObject:service forKey:UUID]; }
+
+            [self notifyDelegateOfNewService:service];
+        }
+    }
+
+    @synchronized(_helloDevices) { [_helloDevices removeObjectForKey:UUID]; }
+}
+
+/// Returns the fields of the device in the description that provides the
+/// type's services, an empty dictionary if there isn't one, or @c nil if the
+/// XML can't be read.
+- (NSDictionary *) descriptionFromXML:(NSString *)locationXML forType:(NSString *)theType
+{
+    NSError *xmlError;
+    NSDictionary *xml = [CTXMLReader dictionaryForXMLData:[locationXML dataUsingEncoding:NSUTF8StringEncoding] error:&xmlError];
+
+    if (xmlError)
+        return nil;
+
+    NSDictionary *device = [self device:[xml valueForKeyPath:@"root.device"]
+           containingServicesWithFilter:theType];
+
+    if (!device)
+        return @{};
+
+    NSMutableDictionary *description = [NSMutableDictionary new];
+    [description setNullableObject:[device valueForKeyPath:@"friendlyName.text"] forKey:@"friendlyName"];
+    [description setNullableObject:[[device objectForKey:@"modelName"] objectForKey:@"text"] forKey:@"modelName"];
+    [description setNullableObject:[[device objectForKey:@"modelNumber"] objectForKey:@"text"] forKey:@"modelNumber"];
+    [description setNullableObject:[[device objectForKey:@"modelDescription"] objectForKey:@"text"] forKey:@"modelDescription"];
+    [description setNullableObject:[[device objectForKey:@"manufacturer"] objectForKey:@"text"] forKey:@"manufacturer"];
+    description[@"serviceList"] = [self serviceListForDevice:device];
+
+    return [NSDictionary dictionaryWithDictionary:description];
+}
+
+#pragma mark - Expiry
+
+/// (Re)starts the countdown to losing a device. A device that stops answering
+/// is lost once its advertisement expires, but never later than it would
+/// have been after missing six searches.
+- (void) scheduleExpiryForUUID:(NSString *)UUID maxAge:(NSInteger)maxAge
+{
+    NSTimeInterval lifetime = refreshTime * searchAttemptsBeforeKill;
+
+    if (maxAge > 0)
+        lifetime = MIN(lifetime, maxAge);
+
+    __weak typeof(self) weakSelf = self;
+    [[TimingWheel sharedWheel] scheduleTimerForOwner:self
+                                                name:[kExpiryTimerPrefix stringByAppendingString:UUID]
+                                          afterDelay:lifetime
+                                               block:^{ [weakSelf expireServiceWithUUID:UUID]; }];
+}
+
+- (void) expireServiceWithUUID:(NSString *)UUID
+{
+    @synchronized (_foundServices)
+    {
+        ServiceDescription *service = _foundServices[UUID];
+
+        if (service)
+        {
+            [self notifyDelegateOfLostService:service];
+
+            [_foundServices removeObjectForKey:UUID];
+        }
+    }
+}
+
 - (void) notifyDelegateOfNewService:(ServiceDescription *)service
 {
     NSArray *serviceIds = [self serviceIdsForFilter:service.type];
@@ -429,21 +614,15 @@ static double searchAttemptsBeforeKill = 6.0;
 
 #pragma mark - Helper methods
 
-- (BOOL) isSearchingForFilter:(NSString *)filter
+- (BOOL) isSearchingForType:(SSDPHeaderValue)type
 {
-    __block BOOL containsFilter = NO;
+    for (NSData *filterType in _serviceFilterTypes)
+    {
+        if (SSDPHeaderValueEqualsBytes(type, filterType.bytes, filterType.length))
+            return YES;
+    }
 
-    [_serviceFilters enumerateObjectsUsingBlock:^(NSDictionary *serviceFilter, NSUInteger idx, BOOL *stop) {
-        NSString *ssdpFilter = [[serviceFilter objectForKey:@"ssdp" ] objectForKey:@"filter"];
-        
-        if ([ssdpFilter isEqualToString:filter])
-        {
-            containsFilter = YES;
-            *stop = YES;
-        }
-    }];
-    
-    return containsFilter;
+    return NO;
 }
 
 /// Returns the required services strings array for the given registered filter,
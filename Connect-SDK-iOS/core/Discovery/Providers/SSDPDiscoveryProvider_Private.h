@@ -23,12 +23,20 @@
 #import "SSDPSocketListener.h"
 
 @class SSDPSocketListener;
+@class SSDPDescriptionCache;
+@class SSDPSearchPlanner;
 
 @interface SSDPDiscoveryProvider () <SocketListenerDelegate>
 
 @property (nonatomic, strong) SSDPSocketListener *multicastSocket;
 @property (nonatomic, strong) SSDPSocketListener *searchSocket;
 
+/// Where device descriptions are cached. Defaults to the shared cache.
+@property (nonatomic, strong) SSDPDescriptionCache *descriptionCache;
+
+/// Decides which searches are sent and counts the traffic they cause.
+@property (nonatomic, strong) SSDPSearchPlanner *searchPlanner;
+
 - (NSArray *) serviceListForDevice:(id)device;
 
 @end
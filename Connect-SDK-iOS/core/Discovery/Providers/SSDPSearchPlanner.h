@@ -0,0 +1,84 @@
+//
+//  SSDPSearchPlanner.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Search target that every UPnP device answers.
+extern NSString *const kSSDPSearchTargetAll;
+
+/// One M-SEARCH to send, covering one or more device filters.
+@interface SSDPSearch : NSObject
+
+/// The ST header value.
+@property (nonatomic, readonly) NSString *target;
+
+/// User agent product tokens wanted by the filters this search covers.
+@property (nonatomic, readonly) NSArray *userAgentTokens;
+
+- (instancetype)initWithTarget:(NSString *)target userAgentTokens:(NSArray *)tokens;
+
+@end
+
+/// Decides which M-SEARCH messages to send for a set of device filters, and
+/// when to send them.
+///
+/// Filters with the same search target share one search. If @c maxTargets is
+/// set and there are more distinct targets than that, a single @c ssdp:all
+/// search replaces them, since devices answer it with every type they have.
+/// That's fewer packets out but many more back, so it's off by default.
+///
+/// Each search is sent @c transmissions times, spread over the first half of
+/// the MX window with random jitter so that repeats from several searches, and
+/// from other control points, don't go out together.
+@interface SSDPSearchPlanner : NSObject
+
+/// Most distinct search targets sent before switching to @c ssdp:all.
+/// Defaults to @c NSUIntegerMax, which never switches.
+@property (nonatomic) NSUInteger maxTargets;
+
+/// The MX header value: how many seconds devices may wait before answering.
+/// Defaults to 5.
+@property (nonatomic) NSUInteger mx;
+
+/// How many times each search is sent, including the first. Defaults to 3.
+@property (nonatomic) NSUInteger transmissions;
+
+/// Number of M-SEARCH packets sent.
+@property (nonatomic, readonly) NSUInteger packetsSent;
+
+/// Number of search responses received, whether or not they matched a filter.
+@property (nonatomic, readonly) NSUInteger responsesReceived;
+
+/// Number of search responses that matched a filter.
+@property (nonatomic, readonly) NSUInteger matchingResponsesReceived;
+
+/// Returns the searches that cover the given device filters, in the format
+/// passed to @c -[DiscoveryProvider addDeviceFilter:].
+- (NSArray *)searchesForFilters:(NSArray *)filters;
+
+/// Returns the delays in seconds, from the start of a search round, at which
+/// the search at @c index should be sent.
+- (NSArray *)sendDelaysForSearchAtIndex:(NSUInteger)index;
+
+- (void)recordPacketSent;
+- (void)recordResponseMatchingFilter:(BOOL)matching;
+- (void)resetStatistics;
+
+@end
@@ -0,0 +1,178 @@
+//
+//  SSDPSearchPlanner.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPSearchPlanner.h"
+
+NSString *const kSSDPSearchTargetAll = @"ssdp:all";
+
+/// Searches in one round are staggered by this much so they don't go out as a
+/// single burst.
+static const NSTimeInterval kSearchSpacing = 0.1;
+
+/// Random delay of up to this many milliseconds added to every send.
+static const uint32_t kMaxJitterMilliseconds = 250;
+
+@implementation SSDPSearch
+
+- (instancetype)initWithTarget:(NSString *)target userAgentTokens:(NSArray *)tokens
+{
+    self = [super init];
+
+    if (self)
+    {
+        _target = target;
+        _userAgentTokens = tokens ?: @[];
+    }
+
+    return self;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (![object isKindOfClass:[SSDPSearch class]])
+        return NO;
+
+    SSDPSearch *search = object;
+    return [self.target isEqualToString:search.target] &&
+        [self.userAgentTokens isEqualToArray:search.userAgentTokens];
+}
+
+- (NSUInteger)hash
+{
+    return self.target.hash ^ self.userAgentTokens.hash;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<SSDPSearch %@ %@>", self.target, self.userAgentTokens];
+}
+
+@end
+
+@implementation SSDPSearchPlanner
+
+- (instancetype)init
+{
+    self = [super init];
+
+    if (self)
+    {
+        _maxTargets = NSUIntegerMax;
+        _mx = 5;
+        _transmissions = 3;
+    }
+
+    return self;
+}
+
+#pragma mark - Planning
+
+- (NSArray *)searchesForFilters:(NSArray *)filters
+{
+    NSMutableArray *targets = [NSMutableArray array];
+    NSMutableDictionary *tokensByTarget = [NSMutableDictionary dictionary];
+    NSMutableArray *allTokens = [NSMutableArray array];
+
+    for (NSDictionary *filter in filters)
+    {
+        NSDictionary *ssdpInfo = [filter objectForKey:@"ssdp"];
+        NSString *target = [ssdpInfo objectForKey:@"filter"];
+        NSString *token = [ssdpInfo objectForKey:@"userAgentToken"];
+
+        if (!target)
+            continue;
+
+        NSMutableArray *tokens = tokensByTarget[target];
+
+        if (!tokens)
+        {
+            tokens = [NSMutableArray array];
+            tokensByTarget[target] = tokens;
+            [targets addObject:target];
+        }
+
+        if (token && ![tokens containsObject:token])
+            [tokens addObject:token];
+
+        if (token && ![allTokens containsObject:token])
+            [allTokens addObject:token];
+    }
+
+    if (targets.count > self.maxTargets)
+        return @[[[SSDPSearch alloc] initWithTarget:kSSDPSearchTargetAll userAgentTokens:allTokens]];
+
+    NSMutableArray *searches = [NSMutableArray arrayWithCapacity:targets.count];
+
+    for (NSString *target in targets)
+        [searches addObject:[[SSDPSearch alloc] initWithTarget:target userAgentTokens:tokensByTarget[target]]];
+
+    return [NSArray arrayWithArray:searches];
+}
+
+- (NSArray *)sendDelaysForSearchAtIndex:(NSUInteger)index
+{
+    NSUInteger transmissions = MAX(1, self.transmissions);
+    NSTimeInterval window = self.mx / 2.0;
+    NSTimeInterval interval = window / transmissions;
+    NSTimeInterval offset = index * kSearchSpacing;
+
+    NSMutableArray *delays = [NSMutableArray arrayWithCapacity:transmissions];
+
+    // The first packet goes out straight away; only the repeats are jittered
+    [delays addObject:@(offset)];
+
+    for (NSUInteger transmission = 1; transmission < transmissions; ++transmission)
+    {
+        NSTimeInterval jitter = arc4random_uniform(kMaxJitterMilliseconds + 1) / 1000.0;
+        [delays addObject:@(offset + transmission * interval + jitter)];
+    }
+
+    return [NSArray arrayWithArray:delays];
+}
+
+#pragma mark - Statistics
+
+- (void)recordPacketSent
+{
+    @synchronized (self) { ++_packetsSent; }
+}
+
+- (void)recordResponseMatchingFilter:(BOOL)matching
+{
+    @synchronized (self)
+    {
+        ++_responsesReceived;
+
+        if (matching)
+            ++_matchingResponsesReceived;
+    }
+}
+
+- (void)resetStatistics
+{
+    @synchronized (self)
+    {
+        _packetsSent = 0;
+        _responsesReceived = 0;
+        _matchingResponsesReceived = 0;
+    }
+}
+
+@end
@@ -164,6 +164,25 @@ extern NSString* const GCDWebServerOption_AutomaticallyMapHEADToGET;
  */
 extern NSString* const GCDWebServerOption_ConnectedStateCoalescingInterval;
 
+/**
+ *  How long in seconds a connection is kept open waiting for the next request
+ *  once a response has been sent, so HTTP/1.1 clients can reuse it and
+ *  pipeline requests (NSNumber / double). Every connection will be closed after
+ *  its first response if the timeout is <= 0.0.
+ *
+ *  The default value is 5.0 seconds.
+ */
+extern NSString* const GCDWebServerOption_ConnectionKeepAliveTimeout;
+
+/**
+ *  The maximum number of open connections for which the GCDWebServer will keep
+ *  using persistent connections (NSNumber / NSUInteger). Past this number,
+ *  connections are closed after their response.
+ *
+ *  The default value is 16.
+ */
+extern NSString* const GCDWebServerOption_MaxKeepAliveConnections;
+
 #if TARGET_OS_IPHONE
 
 /**
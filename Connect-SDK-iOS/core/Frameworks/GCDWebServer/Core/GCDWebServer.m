@@ -59,6 +59,8 @@ NSString* const GCDWebServerOption_AuthenticationAccounts = @"AuthenticationAcco
 NSString* const GCDWebServerOption_ConnectionClass = @"ConnectionClass";
 NSString* const GCDWebServerOption_AutomaticallyMapHEADToGET = @"AutomaticallyMapHEADToGET";
 NSString* const GCDWebServerOption_ConnectedStateCoalescingInterval = @"ConnectedStateCoalescingInterval";
+NSString* const GCDWebServerOption_ConnectionKeepAliveTimeout = @"ConnectionKeepAliveTimeout";
+NSString* const GCDWebServerOption_MaxKeepAliveConnections = @"MaxKeepAliveConnections";
 #if TARGET_OS_IPHONE
 NSString* const GCDWebServerOption_AutomaticallySuspendInBackground = @"AutomaticallySuspendInBackground";
 #endif
@@ -155,6 +157,7 @@ static void _ExecuteMainThreadRunLoopSources() {
   dispatch_group_t _sourceGroup;
   NSMutableArray* _handlers;
   NSInteger _activeConnections;  // Accessed through _syncQueue only
+  NSHashTable* _connections;  // Accessed through _syncQueue only
   BOOL _connected;  // Accessed on main thread only
   CFRunLoopTimerRef _disconnectTimer;  // Accessed on main thread only
   
@@ -166,6 +169,8 @@ static void _ExecuteMainThreadRunLoopSources() {
   Class _connectionClass;
   BOOL _mapHEADToGET;
   CFTimeInterval _disconnectDelay;
+  NSTimeInterval _keepAliveTimeout;
+  NSUInteger _maxKeepAliveConnections;
   NSUInteger _port;
   dispatch_source_t _source4;
   dispatch_source_t _source6;
@@ -185,7 +190,7 @@ static void _ExecuteMainThreadRunLoopSources() {
 
 @synthesize delegate=_delegate, handlers=_handlers, port=_port, serverName=_serverName, authenticationRealm=_authenticationRealm,
             authenticationBasicAccounts=_authenticationBasicAccounts, authenticationDigestAccounts=_authenticationDigestAccounts,
-            shouldAutomaticallyMapHEADToGET=_mapHEADToGET;
+            shouldAutomaticallyMapHEADToGET=_mapHEADToGET, keepAliveTimeout=_keepAliveTimeout;
 
 + (void)initialize {
   GCDWebServerInitializeFunctions();
@@ -196,6 +201,7 @@ static void _ExecuteMainThreadRunLoopSources() {
     _syncQueue = dispatch_queue_create([NSStringFromClass([self class]) UTF8String], DISPATCH_QUEUE_SERIAL);
     _sourceGroup = dispatch_group_create();
     _handlers = [[NSMutableArray alloc] init];
+    _connections = [NSHashTable weakObjectsHashTable];
 #if TARGET_OS_IPHONE
     _backgroundTask = UIBackgroundTaskInvalid;
 #endif
@@ -268,10 +274,21 @@ static void _ExecuteMainThreadRunLoopSources() {
       });
     }
     _activeConnections += 1;
+    [_connections addObject:connection];
     
   });
 }
 
+- (BOOL)shouldKeepConnectionAlive:(GCDWebServerConnection*)connection {
+  __block BOOL keepAlive = NO;
+  if (_source4 && (_keepAliveTimeout > 0.0)) {
+    dispatch_sync(_syncQueue, ^{
+      keepAlive = ((NSUInteger)_activeConnections <= _maxKeepAliveConnections);
+    });
+  }
+  return keepAlive;
+}
+
 #if TARGET_OS_IPHONE
 
 // Always called on main thread
@@ -550,6 +567,8 @@ static inline NSString* _EncodeBase64(NSString* string) {
   _connectionClass = _GetOption(_options, GCDWebServerOption_ConnectionClass, [GCDWebServerConnection class]);
   _mapHEADToGET = [_GetOption(_options, GCDWebServerOption_AutomaticallyMapHEADToGET, @YES) boolValue];
   _disconnectDelay = [_GetOption(_options, GCDWebServerOption_ConnectedStateCoalescingInterval, @1.0) doubleValue];
+  _keepAliveTimeout = [_GetOption(_options, GCDWebServerOption_ConnectionKeepAliveTimeout, @5.0) doubleValue];
+  _maxKeepAliveConnections = [_GetOption(_options, GCDWebServerOption_MaxKeepAliveConnections, @16) unsignedIntegerValue];
   
   _source4 = [self _createDispatchSourceWithListeningSocket:listeningSocket4 isIPv6:NO];
   _source6 = [self _createDispatchSourceWithListeningSocket:listeningSocket6 isIPv6:YES];
@@ -620,6 +639,12 @@ static inline NSString* _EncodeBase64(NSString* string) {
   _source4 = NULL;
   _port = 0;
   
+  __block NSArray* connections = nil;
+  dispatch_sync(_syncQueue, ^{
+    connections = [_connections allObjects];
+  });
+  [connections makeObjectsPerformSelector:@selector(closeIfIdle)];  // Don't wait for persistent connections to time out
+  
   _serverName = nil;
   _authenticationRealm = nil;
   _authenticationBasicAccounts = nil;
@@ -887,7 +912,7 @@ static inline NSString* _EncodeBase64(NSString* string) {
     
     GCDWebServerResponse* response = nil;
     if (allowRangeRequests) {
-      response = [GCDWebServerFileResponse responseWithFile:filePath byteRange:request.byteRange isAttachment:isAttachment];
+      response = [GCDWebServerFileResponse responseWithFile:filePath forRequest:request isAttachment:isAttachment];
       [response setValue:@"bytes" forAdditionalHeader:@"Accept-Ranges"];
     } else {
       response = [GCDWebServerFileResponse responseWithFile:filePath isAttachment:isAttachment];
@@ -955,7 +980,7 @@ static inline NSString* _EncodeBase64(NSString* string) {
           response = [server _responseWithContentsOfDirectory:filePath];
         } else if ([fileType isEqualToString:NSFileTypeRegular]) {
           if (allowRangeRequests) {
-            response = [GCDWebServerFileResponse responseWithFile:filePath byteRange:request.byteRange];
+            response = [GCDWebServerFileResponse responseWithFile:filePath forRequest:request isAttachment:NO];
             [response setValue:@"bytes" forAdditionalHeader:@"Accept-Ranges"];
           } else {
             response = [GCDWebServerFileResponse responseWithFile:filePath];
@@ -74,6 +74,12 @@ static int32_t _connectionCounter = 0;
   GCDWebServerResponse* _response;
   NSInteger _statusCode;
   
+  BOOL _keepAlive;
+  BOOL _idle;
+  NSUInteger _completedRequests;
+  NSData* _pipelinedData;  // Bytes of the next request that were read along with the current one
+  dispatch_source_t _idleTimer;
+  
   BOOL _opened;
 #ifdef __GCDWEBSERVER_ENABLE_TESTING__
   NSUInteger _connectionIndex;
@@ -94,6 +100,9 @@ static int32_t _connectionCounter = 0;
       if (error == 0) {
         size_t size = dispatch_data_get_size(buffer);
         if (size > 0) {
+          if (_idle) {
+            [self _cancelIdleTimer];
+          }
           NSUInteger originalLength = data.length;
           dispatch_data_apply(buffer, ^bool(dispatch_data_t region, size_t chunkOffset, const void* chunkBytes, size_t chunkSize) {
             [data appendBytes:chunkBytes length:chunkSize];
@@ -102,7 +111,9 @@ static int32_t _connectionCounter = 0;
           [self didReadBytes:((char*)data.bytes + originalLength) length:(data.length - originalLength)];
           block(YES);
         } else {
-          if (_bytesRead > 0) {
+          if (_idle) {
+            GWS_LOG_DEBUG(@"Persistent connection closed on socket %i", _socket);
+          } else if (_bytesRead > 0) {
             GWS_LOG_ERROR(@"No more data available on socket %i", _socket);
           } else {
             GWS_LOG_WARNING(@"No data received from socket %i", _socket);
@@ -118,28 +129,30 @@ static int32_t _connectionCounter = 0;
   });
 }
 
+// Pipelined requests may already have their headers in "headersData"
 - (void)_readHeaders:(NSMutableData*)headersData withCompletionBlock:(ReadHeadersCompletionBlock)block {
   GWS_DCHECK(_requestMessage);
+  NSRange range = [headersData rangeOfData:_CRLFCRLFData options:0 range:NSMakeRange(0, headersData.length)];
+  if (range.location != NSNotFound) {
+    NSUInteger length = range.location + range.length;
+    if (CFHTTPMessageAppendBytes(_requestMessage, headersData.bytes, length)) {
+      if (CFHTTPMessageIsHeaderComplete(_requestMessage)) {
+        block([headersData subdataWithRange:NSMakeRange(length, headersData.length - length)]);
+      } else {
+        GWS_LOG_ERROR(@"Failed parsing request headers from socket %i", _socket);
+        block(nil);
+      }
+    } else {
+      GWS_LOG_ERROR(@"Failed appending request headers data from socket %i", _socket);
+      block(nil);
+    }
+    return;
+  }
+  
   [self _readData:headersData withLength:NSUIntegerMax completionBlock:^(BOOL success) {
     
     if (success) {
-      NSRange range = [headersData rangeOfData:_CRLFCRLFData options:0 range:NSMakeRange(0, headersData.length)];
-      if (range.location == NSNotFound) {
-        [self _readHeaders:headersData withCompletionBlock:block];
-      } else {
-        NSUInteger length = range.location + range.length;
-        if (CFHTTPMessageAppendBytes(_requestMessage, headersData.bytes, length)) {
-          if (CFHTTPMessageIsHeaderComplete(_requestMessage)) {
-            block([headersData subdataWithRange:NSMakeRange(length, headersData.length - length)]);
-          } else {
-            GWS_LOG_ERROR(@"Failed parsing request headers from socket %i", _socket);
-            block(nil);
-          }
-        } else {
-          GWS_LOG_ERROR(@"Failed appending request headers data from socket %i", _socket);
-          block(nil);
-        }
-      }
+      [self _readHeaders:headersData withCompletionBlock:block];
     } else {
       block(nil);
     }
@@ -220,6 +233,10 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
       } else {
         NSRange trailerRange = [chunkData rangeOfData:_CRLFCRLFData options:0 range:NSMakeRange(range.location, chunkData.length - range.location)];  // Ignore trailers
         if (trailerRange.location != NSNotFound) {
+          NSUInteger end = trailerRange.location + trailerRange.length;
+          if (end < chunkData.length) {
+            _pipelinedData = [chunkData subdataWithRange:NSMakeRange(end, chunkData.length - end)];
+          }
           block(YES);
           return;
         }
@@ -366,10 +383,20 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
   return (localSockAddr->sa_family == AF_INET6);
 }
 
+// https://tools.ietf.org/html/rfc7230#section-3.3.3
+static inline BOOL _HasMessageBody(NSInteger statusCode) {
+  return (statusCode >= 200) && (statusCode != kGCDWebServerHTTPStatusCode_NoContent) && (statusCode != kGCDWebServerHTTPStatusCode_NotModified);
+}
+
 - (void)_initializeResponseHeadersWithStatusCode:(NSInteger)statusCode {
   _statusCode = statusCode;
   _responseMessage = CFHTTPMessageCreateResponse(kCFAllocatorDefault, statusCode, NULL, kCFHTTPVersion1_1);
-  CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Connection"), CFSTR("Close"));
+  if (_keepAlive) {
+    CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Connection"), CFSTR("keep-alive"));
+    CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Keep-Alive"), (__bridge CFStringRef)[NSString stringWithFormat:@"timeout=%i", (int)ceil(_server.keepAliveTimeout)]);
+  } else {
+    CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Connection"), CFSTR("Close"));
+  }
   CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Server"), (__bridge CFStringRef)_server.serverName);
   CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Date"), (__bridge CFStringRef)GCDWebServerFormatRFC822([NSDate date]));
 }
@@ -409,6 +436,7 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
   }
   
   if (_response) {
+    _keepAlive = [self _shouldKeepAliveAfterResponse:_response];
     [self _initializeResponseHeadersWithStatusCode:_response.statusCode];
     if (_response.lastModifiedDate) {
       CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Last-Modified"), (__bridge CFStringRef)GCDWebServerFormatRFC822(_response.lastModifiedDate));
@@ -431,6 +459,8 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
     }
     if (_response.usesChunkedTransferEncoding) {
       CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Transfer-Encoding"), CFSTR("chunked"));
+    } else if (_keepAlive && ![_response hasBody] && _HasMessageBody(_response.statusCode)) {
+      CFHTTPMessageSetHeaderFieldValue(_responseMessage, CFSTR("Content-Length"), CFSTR("0"));  // Otherwise the client would wait for the connection to close
     }
     [_response.additionalHeaders enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL* stop) {
       CFHTTPMessageSetHeaderFieldValue(_responseMessage, (__bridge CFStringRef)key, (__bridge CFStringRef)obj);
@@ -442,8 +472,13 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
           [self _writeBodyWithCompletionBlock:^(BOOL successInner) {
             
             [_response performClose];  // TODO: There's nothing we can do on failure as headers have already been sent
+            if (successInner) {
+              [self _didFinishResponse];
+            }
             
           }];
+        } else {
+          [self _didFinishResponse];
         }
       } else if (hasBody) {
         [_response performClose];
@@ -456,6 +491,78 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
   
 }
 
+// https://tools.ietf.org/html/rfc7230#section-6.3
+- (BOOL)_shouldKeepAliveAfterResponse:(GCDWebServerResponse*)response {
+  if ((_server.keepAliveTimeout <= 0.0) || (_request == nil)) {
+    return NO;
+  }
+  NSString* connectionHeader = [_request.headers objectForKey:@"Connection"];
+  NSString* version = CFBridgingRelease(CFHTTPMessageCopyVersion(_requestMessage));
+  if ([version isEqualToString:(__bridge NSString*)kCFHTTPVersion1_1]) {
+    if (connectionHeader && ([connectionHeader rangeOfString:@"close" options:NSCaseInsensitiveSearch].location != NSNotFound)) {
+      return NO;
+    }
+  } else {
+    // HTTP/1.0 clients have to ask for it and can't read chunked bodies
+    if (!connectionHeader || ([connectionHeader rangeOfString:@"keep-alive" options:NSCaseInsensitiveSearch].location == NSNotFound) || response.usesChunkedTransferEncoding) {
+      return NO;
+    }
+  }
+  return [_server shouldKeepConnectionAlive:self];
+}
+
+- (void)_didFinishResponse {
+  if (!_keepAlive) {
+    return;  // The socket is closed once the connection is released
+  }
+  
+  [self _logRequest];
+  _completedRequests += 1;
+  
+  CFRelease(_requestMessage);
+  _requestMessage = NULL;
+  CFRelease(_responseMessage);
+  _responseMessage = NULL;
+  _request = nil;
+  _handler = nil;
+  _response = nil;
+  _statusCode = 0;
+  _virtualHEAD = NO;
+  _keepAlive = NO;
+  
+  [self _readRequestHeaders];
+}
+
+- (void)_startIdleTimer {
+  GWS_DCHECK(_idleTimer == NULL);
+  _idle = YES;
+  _idleTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, kGCDWebServerGCDQueue);
+  dispatch_source_set_timer(_idleTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_server.keepAliveTimeout * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, (int64_t)(0.1 * NSEC_PER_SEC));
+  CFSocketNativeHandle socket = _socket;  // Don't retain the connection
+  dispatch_source_set_event_handler(_idleTimer, ^{
+    GWS_LOG_DEBUG(@"Closing idle connection on socket %i", socket);
+    shutdown(socket, SHUT_RDWR);  // Ends the pending read
+  });
+  dispatch_resume(_idleTimer);
+}
+
+- (void)_cancelIdleTimer {
+  _idle = NO;
+  if (_idleTimer) {
+    dispatch_source_cancel(_idleTimer);
+#if !OS_OBJECT_USE_OBJC_RETAIN_RELEASE
+    dispatch_release(_idleTimer);
+#endif
+    _idleTimer = NULL;
+  }
+}
+
+- (void)closeIfIdle {
+  if (_idle) {
+    shutdown(_socket, SHUT_RDWR);
+  }
+}
+
 - (void)_readBodyWithLength:(NSUInteger)length initialData:(NSData*)initialData {
   NSError* error = nil;
   if (![_request performOpen:&error]) {
@@ -523,8 +630,16 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
 - (void)_readRequestHeaders {
   _requestMessage = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, true);
   NSMutableData* headersData = [[NSMutableData alloc] initWithCapacity:kHeadersReadCapacity];
+  if (_pipelinedData) {
+    [headersData appendData:_pipelinedData];
+    _pipelinedData = nil;
+  } else if (_completedRequests > 0) {
+    [self _startIdleTimer];
+  }
   [self _readHeaders:headersData withCompletionBlock:^(NSData* extraData) {
     
+    BOOL wasIdle = _idle;
+    [self _cancelIdleTimer];
     if (extraData) {
       NSString* requestMethod = CFBridgingRelease(CFHTTPMessageCopyRequestMethod(_requestMessage));  // Method verbs are case-sensitive and uppercase
       if (_server.shouldAutomaticallyMapHEADToGET && [requestMethod isEqualToString:@"HEAD"]) {
@@ -550,37 +665,40 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
         if (_request) {
           if ([_request hasBody]) {
             [_request prepareForWriting];
-            if (_request.usesChunkedTransferEncoding || (extraData.length <= _request.contentLength)) {
-              NSString* expectHeader = [requestHeaders objectForKey:@"Expect"];
-              if (expectHeader) {
-                if ([expectHeader caseInsensitiveCompare:@"100-continue"] == NSOrderedSame) {  // TODO: Actually validate request before continuing
-                  [self _writeData:_continueData withCompletionBlock:^(BOOL success) {
-                    
-                    if (success) {
-                      if (_request.usesChunkedTransferEncoding) {
-                        [self _readChunkedBodyWithInitialData:extraData];
-                      } else {
-                        [self _readBodyWithLength:_request.contentLength initialData:extraData];
-                      }
+            NSData* bodyData = extraData;
+            if (!_request.usesChunkedTransferEncoding && (extraData.length > _request.contentLength)) {  // The rest belongs to the next pipelined request
+              bodyData = [extraData subdataWithRange:NSMakeRange(0, _request.contentLength)];
+              _pipelinedData = [extraData subdataWithRange:NSMakeRange(_request.contentLength, extraData.length - _request.contentLength)];
+            }
+            NSString* expectHeader = [requestHeaders objectForKey:@"Expect"];
+            if (expectHeader) {
+              if ([expectHeader caseInsensitiveCompare:@"100-continue"] == NSOrderedSame) {  // TODO: Actually validate request before continuing
+                [self _writeData:_continueData withCompletionBlock:^(BOOL success) {
+                  
+                  if (success) {
+                    if (_request.usesChunkedTransferEncoding) {
+                      [self _readChunkedBodyWithInitialData:bodyData];
+                    } else {
+                      [self _readBodyWithLength:_request.contentLength initialData:bodyData];
                     }
-                    
-                  }];
-                } else {
-                  GWS_LOG_ERROR(@"Unsupported 'Expect' / 'Content-Length' header combination on socket %i", _socket);
-                  [self abortRequest:_request withStatusCode:kGCDWebServerHTTPStatusCode_ExpectationFailed];
-                }
+                  }
+                  
+                }];
               } else {
-                if (_request.usesChunkedTransferEncoding) {
-                  [self _readChunkedBodyWithInitialData:extraData];
-                } else {
-                  [self _readBodyWithLength:_request.contentLength initialData:extraData];
-                }
+                GWS_LOG_ERROR(@"Unsupported 'Expect' / 'Content-Length' header combination on socket %i", _socket);
+                [self abortRequest:_request withStatusCode:kGCDWebServerHTTPStatusCode_ExpectationFailed];
               }
             } else {
-              GWS_LOG_ERROR(@"Unexpected 'Content-Length' header value on socket %i", _socket);
-              [self abortRequest:_request withStatusCode:kGCDWebServerHTTPStatusCode_BadRequest];
+              if (_request.usesChunkedTransferEncoding) {
+                [self _readChunkedBodyWithInitialData:bodyData];
+              } else {
+                [self _readBodyWithLength:_request.contentLength initialData:bodyData];
+              }
             }
           } else {
+            if (extraData.length) {
+              _pipelinedData = extraData;
+            }
             [self _startProcessingRequest];
           }
         } else {
@@ -592,6 +710,8 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
         [self abortRequest:nil withStatusCode:kGCDWebServerHTTPStatusCode_InternalServerError];
         GWS_DNOT_REACHED();
       }
+    } else if (wasIdle && (headersData.length == 0)) {
+      ;  // The client closed the persistent connection or it timed out
     } else {
       [self abortRequest:nil withStatusCode:kGCDWebServerHTTPStatusCode_InternalServerError];
     }
@@ -620,6 +740,14 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
   return self;
 }
 
+- (void)_logRequest {
+  if (_request) {
+    GWS_LOG_VERBOSE(@"[%@] %@ %i \"%@ %@\" (%lu | %lu)", self.localAddressString, self.remoteAddressString, (int)_statusCode, _virtualHEAD ? @"HEAD" : _request.method, _request.path, (unsigned long)_bytesRead, (unsigned long)_bytesWritten);
+  } else {
+    GWS_LOG_VERBOSE(@"[%@] %@ %i \"(invalid request)\" (%lu | %lu)", self.localAddressString, self.remoteAddressString, (int)_statusCode, (unsigned long)_bytesRead, (unsigned long)_bytesWritten);
+  }
+}
+
 - (NSString*)localAddressString {
   return GCDWebServerStringFromSockAddr(_localAddress.bytes, YES);
 }
@@ -629,6 +757,8 @@ static inline NSUInteger _ScanHexNumber(const void* bytes, NSUInteger size) {
 }
 
 - (void)dealloc {
+  [self _cancelIdleTimer];
+  
   int result = close(_socket);
   if (result != 0) {
     GWS_LOG_ERROR(@"Failed closing socket %i for connection: %s (%i)", _socket, strerror(errno), errno);
@@ -795,6 +925,7 @@ static inline BOOL _CompareResources(NSString* responseETag, NSString* requestET
 - (void)abortRequest:(GCDWebServerRequest*)request withStatusCode:(NSInteger)statusCode {
   GWS_DCHECK(_responseMessage == NULL);
   GWS_DCHECK((statusCode >= 400) && (statusCode < 600));
+  _keepAlive = NO;  // The rest of the request may still be waiting on the socket
   [self _initializeResponseHeadersWithStatusCode:statusCode];
   [self _writeHeadersWithCompletionBlock:^(BOOL success) {
     ;  // Nothing more to do
@@ -835,10 +966,8 @@ static inline BOOL _CompareResources(NSString* responseETag, NSString* requestET
   }
 #endif
   
-  if (_request) {
-    GWS_LOG_VERBOSE(@"[%@] %@ %i \"%@ %@\" (%lu | %lu)", self.localAddressString, self.remoteAddressString, (int)_statusCode, _virtualHEAD ? @"HEAD" : _request.method, _request.path, (unsigned long)_bytesRead, (unsigned long)_bytesWritten);
-  } else {
-    GWS_LOG_VERBOSE(@"[%@] %@ %i \"(invalid request)\" (%lu | %lu)", self.localAddressString, self.remoteAddressString, (int)_statusCode, (unsigned long)_bytesRead, (unsigned long)_bytesWritten);
+  if (_request || !_completedRequests) {
+    [self _logRequest];
   }
 }
 
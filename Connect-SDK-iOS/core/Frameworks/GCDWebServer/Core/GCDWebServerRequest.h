@@ -148,9 +148,26 @@ extern NSString* const GCDWebServerRequestAttribute_RegexCaptures;
  *  Returns the parsed "Range" header or (NSUIntegerMax, 0) if absent or malformed.
  *  The range will be set to (offset, length) if expressed from the beginning
  *  of the entity body, or (NSUIntegerMax, length) if expressed from its end.
+ *
+ *  If the header asks for several ranges, this property is (NSUIntegerMax, 0)
+ *  and they are only available through the byteRanges property.
  */
 @property(nonatomic, readonly) NSRange byteRange;
 
+/**
+ *  Returns every range of the parsed "Range" header as NSValues wrapping
+ *  NSRanges in the same format as the byteRange property, in the order they
+ *  were requested, or nil if the header is absent or malformed.
+ */
+@property(nonatomic, readonly) NSArray* byteRanges;
+
+/**
+ *  Returns the "If-Range" header or nil if absent. It holds either an entity
+ *  tag or an HTTP date, and the ranges should only be honored if it matches
+ *  the current resource.
+ */
+@property(nonatomic, readonly) NSString* ifRange;
+
 /**
  *  Returns YES if the client supports gzip content encoding according to the
  *  "Accept-Encoding" header.
@@ -156,6 +156,8 @@ NSString* const GCDWebServerRequestAttribute_RegexCaptures = @"GCDWebServerReque
   NSDate* _modifiedSince;
   NSString* _noneMatch;
   NSRange _range;
+  NSArray* _ranges;
+  NSString* _ifRange;
   BOOL _gzipAccepted;
   
   BOOL _opened;
@@ -167,8 +169,50 @@ NSString* const GCDWebServerRequestAttribute_RegexCaptures = @"GCDWebServerReque
 
 @implementation GCDWebServerRequest : NSObject
 
+static inline BOOL _ScanByteOffset(NSString* string, NSUInteger* offset) {
+  if ((string.length == 0) || ([string rangeOfCharacterFromSet:[[NSCharacterSet decimalDigitCharacterSet] invertedSet]].location != NSNotFound)) {
+    return NO;
+  }
+  *offset = (NSUInteger)[string longLongValue];
+  return YES;
+}
+
+// https://tools.ietf.org/html/rfc7233#section-2.1
+static NSArray* _ParseByteRanges(NSString* rangeHeader) {
+  if (![rangeHeader hasPrefix:@"bytes="]) {
+    return nil;
+  }
+  NSMutableArray* ranges = [NSMutableArray array];
+  for (NSString* component in [[rangeHeader substringFromIndex:6] componentsSeparatedByString:@","]) {
+    NSString* spec = [component stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    if (spec.length == 0) {
+      continue;  // The grammar allows empty list elements
+    }
+    NSRange dash = [spec rangeOfString:@"-"];
+    if (dash.location == NSNotFound) {
+      return nil;
+    }
+    NSString* startString = [spec substringToIndex:dash.location];
+    NSString* endString = [spec substringFromIndex:(dash.location + 1)];
+    NSUInteger startValue = 0;
+    NSUInteger endValue = 0;
+    BOOL hasStart = _ScanByteOffset(startString, &startValue);
+    BOOL hasEnd = _ScanByteOffset(endString, &endValue);
+    if (hasStart && hasEnd && (endValue >= startValue)) {  // The second 500 bytes: "500-999"
+      [ranges addObject:[NSValue valueWithRange:NSMakeRange(startValue, endValue - startValue + 1)]];
+    } else if (hasStart && !endString.length) {  // The bytes after 9500 bytes: "9500-"
+      [ranges addObject:[NSValue valueWithRange:NSMakeRange(startValue, NSUIntegerMax)]];
+    } else if (!startString.length && hasEnd && (endValue > 0)) {  // The final 500 bytes: "-500"
+      [ranges addObject:[NSValue valueWithRange:NSMakeRange(NSUIntegerMax, endValue)]];
+    } else {
+      return nil;  // One bad range invalidates the whole header
+    }
+  }
+  return ranges.count ? ranges : nil;
+}
+
 @synthesize method=_method, URL=_url, headers=_headers, path=_path, query=_query, contentType=_type, contentLength=_length, ifModifiedSince=_modifiedSince, ifNoneMatch=_noneMatch,
-            byteRange=_range, acceptsGzipContentEncoding=_gzipAccepted, usesChunkedTransferEncoding=_chunked;
+            byteRange=_range, byteRanges=_ranges, ifRange=_ifRange, acceptsGzipContentEncoding=_gzipAccepted, usesChunkedTransferEncoding=_chunked;
 
 - (instancetype)initWithMethod:(NSString*)method url:(NSURL*)url headers:(NSDictionary*)headers path:(NSString*)path query:(NSDictionary*)query {
   if ((self = [super init])) {
@@ -213,32 +257,14 @@ NSString* const GCDWebServerRequestAttribute_RegexCaptures = @"GCDWebServerReque
     _range = NSMakeRange(NSUIntegerMax, 0);
     NSString* rangeHeader = GCDWebServerNormalizeHeaderValue([_headers objectForKey:@"Range"]);
     if (rangeHeader) {
-      if ([rangeHeader hasPrefix:@"bytes="]) {
-        NSArray* components = [[rangeHeader substringFromIndex:6] componentsSeparatedByString:@","];
-        if (components.count == 1) {
-          components = [[components firstObject] componentsSeparatedByString:@"-"];
-          if (components.count == 2) {
-            NSString* startString = [components objectAtIndex:0];
-            NSInteger startValue = [startString integerValue];
-            NSString* endString = [components objectAtIndex:1];
-            NSInteger endValue = [endString integerValue];
-            if (startString.length && (startValue >= 0) && endString.length && (endValue >= startValue)) {  // The second 500 bytes: "500-999"
-              _range.location = startValue;
-              _range.length = endValue - startValue + 1;
-            } else if (startString.length && (startValue >= 0)) {  // The bytes after 9500 bytes: "9500-"
-              _range.location = startValue;
-              _range.length = NSUIntegerMax;
-            } else if (endString.length && (endValue > 0)) {  // The final 500 bytes: "-500"
-              _range.location = NSUIntegerMax;
-              _range.length = endValue;
-            }
-          }
-        }
-      }
-      if ((_range.location == NSUIntegerMax) && (_range.length == 0)) {  // Ignore "Range" header if syntactically invalid
+      _ranges = _ParseByteRanges(rangeHeader);
+      if (_ranges.count == 1) {
+        _range = [[_ranges firstObject] rangeValue];
+      } else if (_ranges == nil) {  // Ignore "Range" header if syntactically invalid
         GWS_LOG_WARNING(@"Failed to parse 'Range' header \"%@\" for url: %@", rangeHeader, url);
       }
     }
+    _ifRange = [_headers objectForKey:@"If-Range"];
     
     if ([[_headers objectForKey:@"Accept-Encoding"] rangeOfString:@"gzip"].location != NSNotFound) {
       _gzipAccepted = YES;
@@ -27,6 +27,8 @@
 
 #import "GCDWebServerResponse.h"
 
+@class GCDWebServerRequest;
+
 /**
  *  The GCDWebServerFileResponse subclass of GCDWebServerResponse reads the body
  *  of the HTTP response from a file on disk.
@@ -34,6 +36,11 @@
  *  It will automatically set the contentType, lastModifiedDate and eTag
  *  properties of the GCDWebServerResponse according to the file extension and
  *  metadata.
+ *
+ *  Byte ranges are served as defined by RFC 7233: a single satisfiable range
+ *  gets a 206 response with a "Content-Range" header, several get a 206
+ *  "multipart/byteranges" response, and ranges that don't overlap the file
+ *  get a 416 response without a body.
  */
 @interface GCDWebServerFileResponse : GCDWebServerResponse
 
@@ -63,6 +70,14 @@
  */
 + (instancetype)responseWithFile:(NSString*)path byteRange:(NSRange)range isAttachment:(BOOL)attachment;
 
+/**
+ *  Creates a response like +responseWithFile:isAttachment: that serves the
+ *  byte ranges requested by a GCDWebServerRequest.
+ *
+ *  See -initWithFile:forRequest:isAttachment: for details.
+ */
++ (instancetype)responseWithFile:(NSString*)path forRequest:(GCDWebServerRequest*)request isAttachment:(BOOL)attachment;
+
 /**
  *  Initializes a response with the contents of a file.
  */
@@ -81,7 +96,8 @@
  *  the full file, (offset, length) if expressed from the beginning of the file,
  *  or (NSUIntegerMax, length) if expressed from the end of the file. The "offset"
  *  and "length" values will be automatically adjusted to be compatible with the
- *  actual size of the file.
+ *  actual size of the file, and the response will have a 416 status code if
+ *  the range is entirely past its end.
  *
  *  This argument would typically be set to the value of the byteRange property
  *  of the current GCDWebServerRequest.
@@ -89,8 +105,31 @@
 - (instancetype)initWithFile:(NSString*)path byteRange:(NSRange)range;
 
 /**
- *  This method is the designated initializer for the class.
+ *  Initializes a response like -initWithFile:byteRange: and sets the
+ *  "Content-Disposition" HTTP header for a download if the "attachment"
+ *  argument is YES.
  */
 - (instancetype)initWithFile:(NSString*)path byteRange:(NSRange)range isAttachment:(BOOL)attachment;
 
+/**
+ *  Initializes a response that serves the byteRanges of a GCDWebServerRequest
+ *  unless its "If-Range" header shows the client has an older version of the
+ *  file, in which case the whole file is sent.
+ *
+ *  This is what range-capable handlers should normally use, as it's the only
+ *  initializer that handles requests for several ranges.
+ */
+- (instancetype)initWithFile:(NSString*)path forRequest:(GCDWebServerRequest*)request isAttachment:(BOOL)attachment;
+
+/**
+ *  This method is the designated initializer for the class.
+ *
+ *  The "ranges" argument holds NSValues wrapping NSRanges in the format used
+ *  by -initWithFile:byteRange:, or is nil for the full file. Overlapping and
+ *  adjacent ranges are coalesced. The ranges are ignored if "ifRange" is not
+ *  nil and matches neither the entity tag nor the modification date of the
+ *  file.
+ */
+- (instancetype)initWithFile:(NSString*)path byteRanges:(NSArray*)ranges ifRange:(NSString*)ifRange isAttachment:(BOOL)attachment;
+
 @end
@@ -29,11 +29,13 @@
 #error GCDWebServer requires ARC
 #endif
 
+#import <sys/mman.h>
 #import <sys/stat.h>
 
 #import "GCDWebServerPrivate.h"
 
 #define kFileReadBufferSize (32 * 1024)
+#define kFileMapWindowSize (4 * 1024 * 1024)
 
 @interface GCDWebServerFileResponse () {
 @private
@@ -41,6 +43,11 @@
   NSUInteger _offset;
   NSUInteger _size;
   int _file;
+  BOOL _mapped;  // Whether the file is sent as memory-mapped windows instead of read() buffers
+  NSArray* _ranges;  // Parts of a "multipart/byteranges" body
+  NSArray* _partHeaders;
+  NSUInteger _partIndex;
+  NSData* _closingBoundary;
 }
 @end
 
@@ -62,23 +69,91 @@
   return [[[self class] alloc] initWithFile:path byteRange:range isAttachment:attachment];
 }
 
++ (instancetype)responseWithFile:(NSString*)path forRequest:(GCDWebServerRequest*)request isAttachment:(BOOL)attachment {
+  return [[[self class] alloc] initWithFile:path forRequest:request isAttachment:attachment];
+}
+
 - (instancetype)initWithFile:(NSString*)path {
-  return [self initWithFile:path byteRange:NSMakeRange(NSUIntegerMax, 0) isAttachment:NO];
+  return [self initWithFile:path byteRanges:nil ifRange:nil isAttachment:NO];
 }
 
 - (instancetype)initWithFile:(NSString*)path isAttachment:(BOOL)attachment {
-  return [self initWithFile:path byteRange:NSMakeRange(NSUIntegerMax, 0) isAttachment:attachment];
+  return [self initWithFile:path byteRanges:nil ifRange:nil isAttachment:attachment];
 }
 
 - (instancetype)initWithFile:(NSString*)path byteRange:(NSRange)range {
   return [self initWithFile:path byteRange:range isAttachment:NO];
 }
 
+- (instancetype)initWithFile:(NSString*)path byteRange:(NSRange)range isAttachment:(BOOL)attachment {
+  NSArray* ranges = GCDWebServerIsValidByteRange(range) ? @[[NSValue valueWithRange:range]] : nil;
+  return [self initWithFile:path byteRanges:ranges ifRange:nil isAttachment:attachment];
+}
+
+- (instancetype)initWithFile:(NSString*)path forRequest:(GCDWebServerRequest*)request isAttachment:(BOOL)attachment {
+  return [self initWithFile:path byteRanges:request.byteRanges ifRange:request.ifRange isAttachment:attachment];
+}
+
 static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
   return [NSDate dateWithTimeIntervalSince1970:((NSTimeInterval)t->tv_sec + (NSTimeInterval)t->tv_nsec / 1000000000.0)];
 }
 
-- (instancetype)initWithFile:(NSString*)path byteRange:(NSRange)range isAttachment:(BOOL)attachment {
+static inline NSString* _ETagFromFileInfo(const struct stat* info) {
+  return [NSString stringWithFormat:@"\"%llu-%li-%li\"", info->st_ino, info->st_mtimespec.tv_sec, info->st_mtimespec.tv_nsec];
+}
+
+// https://tools.ietf.org/html/rfc7233#section-3.2
+static BOOL _IfRangeMatchesFile(NSString* ifRange, const struct stat* info) {
+  if (ifRange == nil) {
+    return YES;
+  }
+  if ([ifRange hasPrefix:@"\""] || [ifRange hasPrefix:@"W/"]) {
+    return [ifRange isEqualToString:_ETagFromFileInfo(info)];  // Weak entity tags never match
+  }
+  NSDate* date = GCDWebServerParseRFC822(ifRange);
+  return date && ((time_t)[date timeIntervalSince1970] == info->st_mtimespec.tv_sec);
+}
+
+// Clamps the ranges to the file, drops the unsatisfiable ones and coalesces the ones that overlap or touch
+// https://tools.ietf.org/html/rfc7233#section-4.1
+static NSArray* _SatisfiableByteRanges(NSArray* ranges, NSUInteger fileSize) {
+  NSMutableArray* satisfiable = [NSMutableArray array];
+  for (NSValue* value in ranges) {
+    NSRange range = [value rangeValue];
+    if (range.location != NSUIntegerMax) {
+      if (range.location >= fileSize) {
+        continue;
+      }
+      range.length = MIN(range.length, fileSize - range.location);
+    } else {
+      range.length = MIN(range.length, fileSize);
+      range.location = fileSize - range.length;
+    }
+    if (range.length > 0) {
+      [satisfiable addObject:[NSValue valueWithRange:range]];
+    }
+  }
+  [satisfiable sortUsingComparator:^NSComparisonResult(NSValue* value1, NSValue* value2) {
+    NSUInteger location1 = [value1 rangeValue].location;
+    NSUInteger location2 = [value2 rangeValue].location;
+    return location1 < location2 ? NSOrderedAscending : (location1 > location2 ? NSOrderedDescending : NSOrderedSame);
+  }];
+  
+  NSMutableArray* coalesced = [NSMutableArray array];
+  for (NSValue* value in satisfiable) {
+    NSRange range = [value rangeValue];
+    NSRange previous = [[coalesced lastObject] rangeValue];
+    if (coalesced.count && (range.location <= NSMaxRange(previous))) {
+      previous.length = MAX(NSMaxRange(previous), NSMaxRange(range)) - previous.location;
+      [coalesced replaceObjectAtIndex:(coalesced.count - 1) withObject:[NSValue valueWithRange:previous]];
+    } else {
+      [coalesced addObject:value];
+    }
+  }
+  return coalesced;
+}
+
+- (instancetype)initWithFile:(NSString*)path byteRanges:(NSArray*)ranges ifRange:(NSString*)ifRange isAttachment:(BOOL)attachment {
   struct stat info;
   if (lstat([path fileSystemRepresentation], &info) || !(info.st_mode & S_IFREG)) {
     GWS_DNOT_REACHED();
@@ -92,31 +167,25 @@ static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
 #endif
   NSUInteger fileSize = (NSUInteger)info.st_size;
   
-  BOOL hasByteRange = GCDWebServerIsValidByteRange(range);
-  if (hasByteRange) {
-    if (range.location != NSUIntegerMax) {
-      range.location = MIN(range.location, fileSize);
-      range.length = MIN(range.length, fileSize - range.location);
-    } else {
-      range.length = MIN(range.length, fileSize);
-      range.location = fileSize - range.length;
-    }
-    if (range.length == 0) {
-      return nil;  // TODO: Return 416 status code and "Content-Range: bytes */{file length}" header
-    }
-  } else {
-    range.location = 0;
-    range.length = fileSize;
+  if (ranges.count && !_IfRangeMatchesFile(ifRange, &info)) {
+    GWS_LOG_DEBUG(@"Ignoring byte ranges as \"If-Range\" doesn't match file \"%@\"", path);
+    ranges = nil;
   }
+  NSArray* satisfiableRanges = _SatisfiableByteRanges(ranges, fileSize);
   
   if ((self = [super init])) {
     _path = [path copy];
-    _offset = range.location;
-    _size = range.length;
-    if (hasByteRange) {
-      [self setStatusCode:kGCDWebServerHTTPStatusCode_PartialContent];
-      [self setValue:[NSString stringWithFormat:@"bytes %lu-%lu/%lu", (unsigned long)_offset, (unsigned long)(_offset + _size - 1), (unsigned long)fileSize] forAdditionalHeader:@"Content-Range"];
-      GWS_LOG_DEBUG(@"Using content bytes range [%lu-%lu] for file \"%@\"", (unsigned long)_offset, (unsigned long)(_offset + _size - 1), path);
+    _offset = 0;
+    _size = fileSize;
+    
+    self.lastModifiedDate = _NSDateFromTimeSpec(&info.st_mtimespec);
+    self.eTag = _ETagFromFileInfo(&info);
+    
+    if (ranges.count && (satisfiableRanges.count == 0)) {
+      [self setStatusCode:kGCDWebServerHTTPStatusCode_RequestedRangeNotSatisfiable];
+      [self setValue:[NSString stringWithFormat:@"bytes */%lu", (unsigned long)fileSize] forAdditionalHeader:@"Content-Range"];
+      GWS_LOG_DEBUG(@"No satisfiable byte range for file \"%@\"", path);
+      return self;  // Without a body
     }
     
     if (attachment) {
@@ -131,10 +200,41 @@ static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
       }
     }
     
-    self.contentType = GCDWebServerGetMimeTypeForExtension([_path pathExtension]);
-    self.contentLength = _size;
-    self.lastModifiedDate = _NSDateFromTimeSpec(&info.st_mtimespec);
-    self.eTag = [NSString stringWithFormat:@"%llu/%li/%li", info.st_ino, info.st_mtimespec.tv_sec, info.st_mtimespec.tv_nsec];
+    NSString* mimeType = GCDWebServerGetMimeTypeForExtension([_path pathExtension]);
+    if (satisfiableRanges.count == 1) {
+      NSRange range = [[satisfiableRanges firstObject] rangeValue];
+      _offset = range.location;
+      _size = range.length;
+      [self setStatusCode:kGCDWebServerHTTPStatusCode_PartialContent];
+      [self setValue:[NSString stringWithFormat:@"bytes %lu-%lu/%lu", (unsigned long)_offset, (unsigned long)(_offset + _size - 1), (unsigned long)fileSize] forAdditionalHeader:@"Content-Range"];
+      GWS_LOG_DEBUG(@"Using content bytes range [%lu-%lu] for file \"%@\"", (unsigned long)_offset, (unsigned long)(_offset + _size - 1), path);
+      self.contentType = mimeType;
+      self.contentLength = _size;
+    } else if (satisfiableRanges.count > 1) {  // https://tools.ietf.org/html/rfc7233#appendix-A
+      NSString* boundary = [[NSUUID UUID] UUIDString];
+      NSMutableArray* partHeaders = [[NSMutableArray alloc] initWithCapacity:satisfiableRanges.count];
+      NSUInteger length = 0;
+      for (NSValue* value in satisfiableRanges) {
+        NSRange range = [value rangeValue];
+        NSString* header = [NSString stringWithFormat:@"%@--%@\r\nContent-Type: %@\r\nContent-Range: bytes %lu-%lu/%lu\r\n\r\n", partHeaders.count ? @"\r\n" : @"", boundary, mimeType,
+                                                      (unsigned long)range.location, (unsigned long)(NSMaxRange(range) - 1), (unsigned long)fileSize];
+        NSData* headerData = [header dataUsingEncoding:NSUTF8StringEncoding];
+        [partHeaders addObject:headerData];
+        length += headerData.length + range.length;
+      }
+      _closingBoundary = [[NSString stringWithFormat:@"\r\n--%@--\r\n", boundary] dataUsingEncoding:NSUTF8StringEncoding];
+      length += _closingBoundary.length;
+      _ranges = satisfiableRanges;
+      _partHeaders = partHeaders;
+      _size = 0;  // Set from each range as its part is sent
+      [self setStatusCode:kGCDWebServerHTTPStatusCode_PartialContent];
+      GWS_LOG_DEBUG(@"Using %lu content bytes ranges for file \"%@\"", (unsigned long)satisfiableRanges.count, path);
+      self.contentType = [NSString stringWithFormat:@"multipart/byteranges; boundary=%@", boundary];
+      self.contentLength = length;
+    } else {
+      self.contentType = mimeType;
+      self.contentLength = _size;
+    }
   }
   return self;
 }
@@ -147,20 +247,63 @@ static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
     }
     return NO;
   }
-  if (lseek(_file, _offset, SEEK_SET) != (off_t)_offset) {
+  _mapped = YES;
+  return YES;
+}
+
+// Maps the next window of the file and hands it over as NSData that unmaps it when released, so
+// the bytes go from the page cache to the socket without being copied or allocated per chunk
+- (NSData*)_readMappedData:(NSError**)error {
+  size_t pageSize = (size_t)getpagesize();
+  off_t start = (off_t)(_offset & ~(pageSize - 1));  // mmap() offsets must be page aligned
+  size_t skip = (size_t)(_offset - start);
+  size_t length = MIN((NSUInteger)kFileMapWindowSize, _size);
+  size_t mappedLength = skip + length;
+  void* bytes = mmap(NULL, mappedLength, PROT_READ, MAP_FILE | MAP_SHARED, _file, start);
+  if (bytes == MAP_FAILED) {
     if (error) {
       *error = GCDWebServerMakePosixError(errno);
     }
-    close(_file);
-    return NO;
+    return nil;
   }
-  return YES;
+  madvise(bytes, mappedLength, MADV_SEQUENTIAL);
+  NSData* data = [[NSData alloc] initWithBytesNoCopy:((char*)bytes + skip) length:length deallocator:^(void* ptr, NSUInteger dataLength) {
+    munmap(bytes, mappedLength);
+  }];
+  _offset += length;
+  _size -= length;
+  return data;
 }
 
 - (NSData*)readData:(NSError**)error {
+  if (_size == 0) {
+    if (_partIndex < _ranges.count) {  // Start the next part of a "multipart/byteranges" body
+      NSRange range = [[_ranges objectAtIndex:_partIndex] rangeValue];
+      NSData* header = [_partHeaders objectAtIndex:_partIndex];
+      _partIndex += 1;
+      _offset = range.location;
+      _size = range.length;
+      return header;
+    }
+    if (_closingBoundary) {
+      NSData* data = _closingBoundary;
+      _closingBoundary = nil;
+      return data;
+    }
+    return [NSData data];
+  }
+  if (_mapped) {
+    NSData* data = [self _readMappedData:error];
+    if (data) {
+      return data;
+    }
+    GWS_LOG_WARNING(@"Failed mapping file \"%@\", falling back to reading it: %@", _path, *error);  // "error" is guaranteed to be non-NULL
+    _mapped = NO;
+  }
+  
   size_t length = MIN((NSUInteger)kFileReadBufferSize, _size);
   NSMutableData* data = [[NSMutableData alloc] initWithLength:length];
-  ssize_t result = read(_file, data.mutableBytes, length);
+  ssize_t result = pread(_file, data.mutableBytes, length, _offset);
   if (result < 0) {
     if (error) {
       *error = GCDWebServerMakePosixError(errno);
@@ -169,6 +312,7 @@ static inline NSDate* _NSDateFromTimeSpec(const struct timespec* t) {
   }
   if (result > 0) {
     [data setLength:result];
+    _offset += result;
     _size -= result;
   }
   return data;
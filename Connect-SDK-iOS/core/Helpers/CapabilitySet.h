@@ -0,0 +1,71 @@
+//
+//  CapabilitySet.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Increases whenever any DeviceService's capabilities change, so cached
+/// capability sets can tell that they may be out of date.
+NSUInteger CapabilityGeneration(void);
+void CapabilityGenerationIncrement(void);
+
+/// An immutable set of capability names, stored as a bitset. Each name is
+/// given a bit the first time it's seen, so comparing sets is a few word
+/// operations rather than string comparisons.
+@interface CapabilitySet : NSObject
+
+/// The capability names in the set, in the order they were first seen.
+@property (nonatomic, readonly) NSArray *capabilities;
+
++ (instancetype)emptySet;
+
+/// Creates a set from capability names. @c .Any wildcards are stored as
+/// literal names; use CapabilityRequirement to match them.
++ (instancetype)setWithCapabilities:(NSArray *)capabilities;
+
+- (instancetype)setByAddingSet:(CapabilitySet *)set;
+- (instancetype)setBySubtractingSet:(CapabilitySet *)set;
+
+- (BOOL)containsSet:(CapabilitySet *)set;
+- (BOOL)intersectsSet:(CapabilitySet *)set;
+
+@end
+
+/// A list of capabilities to test against a CapabilitySet, compiled once.
+/// Follows the rules of -[DeviceService hasCapability:]: a name ending in
+/// @c .Any matches any capability containing the part before it.
+@interface CapabilityRequirement : NSObject
+
+@property (nonatomic, readonly) NSArray *capabilities;
+
++ (instancetype)requirementWithCapabilities:(NSArray *)capabilities;
+
+/// Returns a shared requirement for the capabilities, which is only compiled
+/// the first time an equal list is seen. Use this for lists that are checked
+/// over and over, so each check doesn't register names or look for wildcards.
++ (instancetype)sharedRequirementWithCapabilities:(NSArray *)capabilities;
+
+/// Returns @c YES if the set has every capability, like hasCapabilities:.
+- (BOOL)isSatisfiedBySet:(CapabilitySet *)set;
+
+/// Returns @c YES if the set has at least one of the capabilities, like
+/// hasAnyCapability:.
+- (BOOL)isPartlySatisfiedBySet:(CapabilitySet *)set;
+
+@end
@@ -0,0 +1,400 @@
+//
+//  CapabilitySet.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "CapabilitySet.h"
+
+#include <stdatomic.h>
+
+static atomic_ulong _generation;
+
+/// Every capability name seen so far, and the bit each one was given. Names
+/// are never removed, so a bit always means the same capability.
+static NSMutableDictionary *_bitsByName;
+static NSMutableArray *_names;
+static atomic_ulong _nameCount;
+
+NSUInteger CapabilityGeneration(void)
+{
+    return atomic_load(&_generation);
+}
+
+void CapabilityGenerationIncrement(void)
+{
+    atomic_fetch_add(&_generation, 1);
+}
+
+static void setUpNames(void)
+{
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _bitsByName = [NSMutableDictionary new];
+        _names = [NSMutableArray new];
+    });
+}
+
+static NSUInteger bitForName(NSString *name)
+{
+    setUpNames();
+
+    @synchronized (_names)
+    {
+        NSNumber *bit = _bitsByName[name];
+
+        if (!bit)
+        {
+            bit = @(_names.count);
+            _bitsByName[name] = bit;
+            [_names addObject:[name copy]];
+            atomic_store(&_nameCount, _names.count);
+        }
+
+        return bit.unsignedIntegerValue;
+    }
+}
+
+static NSArray *allNames(void)
+{
+    setUpNames();
+
+    @synchronized (_names) { return [_names copy]; }
+}
+
+static inline NSUInteger wordCountForBits(NSUInteger bits)
+{
+    return (bits + 63) / 64;
+}
+
+@interface CapabilitySet ()
+
+- (instancetype)initWithWords:(uint64_t *)words count:(NSUInteger)count;
+
+@end
+
+@implementation CapabilitySet
+{
+    uint64_t *_words;
+    NSUInteger _wordCount;
+}
+
++ (instancetype)emptySet
+{
+    static CapabilitySet *emptySet;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        emptySet = [[CapabilitySet alloc] initWithWords:NULL count:0];
+    });
+
+    return emptySet;
+}
+
++ (instancetype)setWithCapabilities:(NSArray *)capabilities
+{
+    if (capabilities.count == 0)
+        return [self emptySet];
+
+    NSUInteger bits[capabilities.count];
+    NSUInteger highestBit = 0;
+    NSUInteger count = 0;
+
+    for (NSString *capability in capabilities)
+    {
+        if (![capability isKindOfClass:[NSString class]])
+            continue;
+
+        bits[count] = bitForName(capability);
+        highestBit = MAX(highestBit, bits[count]);
+        ++count;
+    }
+
+    if (count == 0)
+        return [self emptySet];
+
+    NSUInteger wordCount = wordCountForBits(highestBit + 1);
+    uint64_t *words = calloc(wordCount, sizeof(uint64_t));
+
+    for (NSUInteger i = 0; i < count; ++i)
+        words[bits[i] / 64] |= 1ULL << (bits[i] % 64);
+
+    return [[CapabilitySet alloc] initWithWords:words count:wordCount];
+}
+
+- (instancetype)initWithWords:(uint64_t *)words count:(NSUInteger)count
+{
+    self = [super init];
+
+    if (self)
+    {
+        // Trailing empty words make no difference to any comparison
+        while (count > 0 && words[count - 1] == 0)
+            --count;
+
+        if (count == 0)
+        {
+            free(words);
+            words = NULL;
+        }
+
+        _words = words;
+        _wordCount = count;
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_words);
+}
+
+- (instancetype)setByAddingSet:(CapabilitySet *)set
+{
+    if (set->_wordCount == 0)
+        return self;
+
+    if (_wordCount == 0)
+        return set;
+
+    NSUInteger wordCount = MAX(_wordCount, set->_wordCount);
+    uint64_t *words = calloc(wordCount, sizeof(uint64_t));
+
+    for (NSUInteger i = 0; i < wordCount; ++i)
+    {
+        if (i < _wordCount)
+            words[i] |= _words[i];
+
+        if (i < set->_wordCount)
+            words[i] |= set->_words[i];
+    }
+
+    return [[CapabilitySet alloc] initWithWords:words count:wordCount];
+}
+
+- (instancetype)setBySubtractingSet:(CapabilitySet *)set
+{
+    if (_wordCount == 0 || set->_wordCount == 0)
+        return self;
+
+    uint64_t *words = calloc(_wordCount, sizeof(uint64_t));
+
+    for (NSUInteger i = 0; i < _wordCount; ++i)
+        words[i] = _words[i] & ~(i < set->_wordCount ? set->_words[i] : 0);
+
+    return [[CapabilitySet alloc] initWithWords:words count:_wordCount];
+}
+
+- (BOOL)containsSet:(CapabilitySet *)set
+{
+    if (set->_wordCount > _wordCount)
+        return NO;
+
+    for (NSUInteger i = 0; i < set->_wordCount; ++i)
+    {
+        if ((_words[i] & set->_words[i]) != set->_words[i])
+            return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)intersectsSet:(CapabilitySet *)set
+{
+    NSUInteger wordCount = MIN(_wordCount, set->_wordCount);
+
+    for (NSUInteger i = 0; i < wordCount; ++i)
+    {
+        if (_words[i] & set->_words[i])
+            return YES;
+    }
+
+    return NO;
+}
+
+- (NSArray *)capabilities
+{
+    if (_wordCount == 0)
+        return @[];
+
+    NSArray *names = allNames();
+    NSMutableArray *capabilities = [NSMutableArray new];
+
+    for (NSUInteger i = 0; i < _wordCount; ++i)
+    {
+        for (uint64_t word = _words[i]; word != 0; word &= word - 1)
+        {
+            NSUInteger bit = i * 64 + __builtin_ctzll(word);
+            [capabilities addObject:names[bit]];
+        }
+    }
+
+    return [NSArray arrayWithArray:capabilities];
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (![object isKindOfClass:[CapabilitySet class]])
+        return NO;
+
+    CapabilitySet *set = object;
+    return set->_wordCount == _wordCount &&
+        (_wordCount == 0 || memcmp(_words, set->_words, _wordCount * sizeof(uint64_t)) == 0);
+}
+
+- (NSUInteger)hash
+{
+    NSUInteger hash = _wordCount;
+
+    for (NSUInteger i = 0; i < _wordCount; ++i)
+        hash = hash * 31 + (NSUInteger)(_words[i] ^ (_words[i] >> 32));
+
+    return hash;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> %@", NSStringFromClass([self class]), self, self.capabilities];
+}
+
+@end
+
+@implementation CapabilityRequirement
+{
+    /// Names that must all be present.
+    CapabilitySet *_required;
+
+    /// The text before each @c .Any wildcard.
+    NSArray *_wildcardTerms;
+
+    /// For each wildcard, the known names that contain its term, and how many
+    /// names were known when they were worked out.
+    NSArray *_wildcardMasks;
+    NSUInteger _maskedNameCount;
+}
+
++ (instancetype)requirementWithCapabilities:(NSArray *)capabilities
+{
+    CapabilityRequirement *requirement = [[CapabilityRequirement alloc] init];
+    requirement->_capabilities = [capabilities copy] ?: @[];
+
+    NSMutableArray *required = [NSMutableArray new];
+    NSMutableArray *wildcardTerms = [NSMutableArray new];
+
+    for (NSString *capability in capabilities)
+    {
+        NSRange anyRange = [capability rangeOfString:@".Any"];
+
+        if (anyRange.location != NSNotFound)
+            [wildcardTerms addObject:[capability substringToIndex:anyRange.location]];
+        else
+            [required addObject:capability];
+    }
+
+    requirement->_required = [CapabilitySet setWithCapabilities:required];
+    requirement->_wildcardTerms = [wildcardTerms copy];
+
+    return requirement;
+}
+
++ (instancetype)sharedRequirementWithCapabilities:(NSArray *)capabilities
+{
+    static NSCache *requirements;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        requirements = [NSCache new];
+        requirements.countLimit = 256;
+    });
+
+    NSArray *key = [capabilities copy] ?: @[];
+    CapabilityRequirement *requirement = [requirements objectForKey:key];
+
+    if (!requirement)
+    {
+        requirement = [self requirementWithCapabilities:key];
+        [requirements setObject:requirement forKey:key];
+    }
+
+    return requirement;
+}
+
+- (BOOL)isSatisfiedBySet:(CapabilitySet *)set
+{
+    if (![set containsSet:_required])
+        return NO;
+
+    for (CapabilitySet *mask in [self wildcardMasks])
+    {
+        if (![set intersectsSet:mask])
+            return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)isPartlySatisfiedBySet:(CapabilitySet *)set
+{
+    if ([set intersectsSet:_required])
+        return YES;
+
+    for (CapabilitySet *mask in [self wildcardMasks])
+    {
+        if ([set intersectsSet:mask])
+            return YES;
+    }
+
+    return NO;
+}
+
+/// Wildcards can match names that are first seen after the requirement was
+/// created, so the masks are worked out again whenever there are new names.
+- (NSArray *)wildcardMasks
+{
+    if (_wildcardTerms.count == 0)
+        return nil;
+
+    @synchronized (self)
+    {
+        NSUInteger nameCount = atomic_load(&_nameCount);
+
+        if (_wildcardMasks && _maskedNameCount == nameCount)
+            return _wildcardMasks;
+
+        NSArray *names = allNames();
+        NSMutableArray *masks = [NSMutableArray new];
+
+        for (NSString *term in _wildcardTerms)
+        {
+            NSMutableArray *matches = [NSMutableArray new];
+
+            for (NSString *name in names)
+            {
+                if ([name rangeOfString:term].location != NSNotFound)
+                    [matches addObject:name];
+            }
+
+            [masks addObject:[CapabilitySet setWithCapabilities:matches]];
+        }
+
+        _wildcardMasks = [masks copy];
+        _maskedNameCount = names.count;
+
+        return _wildcardMasks;
+    }
+}
+
+@end
@@ -0,0 +1,36 @@
+//
+//  DLNAContentFeatures.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Returns the fourth field of a DLNA protocolInfo for media of the given MIME
+/// type, which is also what a media server sends as contentFeatures.dlna.org.
+/// Audio and video are marked as seekable by byte range and streamed; images
+/// are marked as interactive. A DLNA.ORG_PN profile is only given for MP3,
+/// because no other profile can be told from the MIME type alone and a wrong
+/// one makes renderers refuse the media.
+NSString *DLNAContentFeatures(NSString *mimeType);
+
+/// Returns the protocolInfo for media of the given MIME type served over HTTP.
+NSString *DLNAProtocolInfo(NSString *mimeType);
+
+/// Returns the transferMode.dlna.org for media of the given MIME type:
+/// @c Interactive for images and @c Streaming for everything else.
+NSString *DLNATransferMode(NSString *mimeType);
@@ -0,0 +1,60 @@
+//
+//  DLNAContentFeatures.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "DLNAContentFeatures.h"
+
+static inline BOOL isImage(NSString *mimeType)
+{
+    return [mimeType hasPrefix:@"image/"];
+}
+
+NSString *DLNAContentFeatures(NSString *mimeType)
+{
+    NSMutableString *features = [NSMutableString string];
+
+    if ([mimeType isEqualToString:@"audio/mpeg"])
+        [features appendString:@"DLNA.ORG_PN=MP3;"];
+
+    // Byte seeks are supported, time seeks aren't
+    if (!isImage(mimeType))
+        [features appendString:@"DLNA.ORG_OP=01;"];
+
+    // Not transcoded
+    [features appendString:@"DLNA.ORG_CI=0;"];
+
+    // DLNA 1.5 with background transfers, plus streaming and connection
+    // stalling for media or interactive transfers for images
+    if (isImage(mimeType))
+        [features appendString:@"DLNA.ORG_FLAGS=00D00000000000000000000000000000"];
+    else
+        [features appendString:@"DLNA.ORG_FLAGS=01700000000000000000000000000000"];
+
+    return features;
+}
+
+NSString *DLNAProtocolInfo(NSString *mimeType)
+{
+    return [NSString stringWithFormat:@"http-get:*:%@:%@", mimeType ?: @"", DLNAContentFeatures(mimeType)];
+}
+
+NSString *DLNATransferMode(NSString *mimeType)
+{
+    return isImage(mimeType) ? @"Interactive" : @"Streaming";
+}
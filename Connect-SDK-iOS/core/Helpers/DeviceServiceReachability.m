@@ -16,11 +16,14 @@
 //
 
 #import "DeviceServiceReachability.h"
+#import "TimingWheel.h"
+
+static NSString *const kReachabilityTimerName = @"reachability";
+static const NSTimeInterval kReachabilityInterval = 30;
 
 
 @implementation DeviceServiceReachability
 {
-    NSTimer *_runTimer;
     NSOperationQueue *_reachabilityQueue;
 }
 
@@ -43,19 +46,28 @@
     return [[self alloc] initWithTargetURL:targetURL];
 }
 
+- (void) dealloc
+{
+    [[TimingWheel sharedWheel] cancelAllTimersForOwner:self];
+}
+
 - (void) start
 {
     _running = YES;
-    _runTimer = [NSTimer scheduledTimerWithTimeInterval:30 target:self selector:@selector(checkReachability) userInfo:nil repeats:YES];
-    [_runTimer fire];
+
+    __weak typeof(self) weakSelf = self;
+    [[TimingWheel sharedWheel] scheduleRepeatingTimerForOwner:self
+                                                         name:kReachabilityTimerName
+                                                     interval:kReachabilityInterval
+                                                        block:^{ [weakSelf checkReachability]; }];
+    [self checkReachability];
 }
 
 - (void) stop
 {
     if (_running)
     {
-        [_runTimer invalidate];
-        _runTimer = nil;
+        [[TimingWheel sharedWheel] cancelTimerForOwner:self name:kReachabilityTimerName];
 
         _running = NO;
     }
@@ -0,0 +1,53 @@
+//
+//  NetworkChangeNotifier.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+/**
+ * Tells other components when the network configuration changes, such as
+ * joining a different Wi-Fi network, so they don't need to poll for it.
+ *
+ * Changes are reported by the system's network change notification, so
+ * nothing runs while the network stays the same. Changes made while the app
+ * is suspended aren't reported; check @c -currentSSID when it resumes.
+ */
+@interface NetworkChangeNotifier : NSObject
+
+/// Type of a block that is called when the network changes.
+typedef void (^NetworkChangeBlock)();
+
+/// The block is called on the main queue whenever the network configuration
+/// changes. Changes usually come in bursts, so it may be called several times
+/// for one switch of networks.
+@property (nonatomic, copy, nullable) NetworkChangeBlock didChangeBlock;
+
+/// Starts listening for network changes. This method is idempotent.
+- (void)startListening;
+
+/// Stops listening for network changes. This method is idempotent.
+- (void)stopListening;
+
+/// Returns the SSID of the current Wi-Fi network, or an empty string if
+/// there isn't one or it can't be read.
+- (NSString *)currentSSID;
+
+@end
+NS_ASSUME_NONNULL_END
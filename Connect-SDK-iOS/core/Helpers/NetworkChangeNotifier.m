@@ -0,0 +1,89 @@
+//
+//  NetworkChangeNotifier.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "NetworkChangeNotifier.h"
+
+#import <notify.h>
+#import <SystemConfiguration/CaptiveNetwork.h>
+
+/// Posted by configd whenever an interface, address or route changes.
+static const char *const kNetworkChangeNotification = "com.apple.system.config.network_change";
+
+@implementation NetworkChangeNotifier {
+    int _notifyToken;
+    BOOL _listening;
+}
+
+- (void)dealloc {
+    [self stopListening];
+}
+
+#pragma mark - Public Methods
+
+- (void)startListening {
+    if (_listening) {
+        return;
+    }
+
+    __weak typeof(self) wself = self;
+    const uint32_t status = notify_register_dispatch(kNetworkChangeNotification,
+                                                     &_notifyToken,
+                                                     dispatch_get_main_queue(),
+                                                     ^(int token) {
+        NetworkChangeBlock block = wself.didChangeBlock;
+        if (block) {
+            block();
+        }
+    });
+
+    _listening = (status == NOTIFY_STATUS_OK);
+
+    if (!_listening) {
+        DLog(@"Couldn't register for network changes: %u", status);
+    }
+}
+
+- (void)stopListening {
+    if (_listening) {
+        notify_cancel(_notifyToken);
+        _listening = NO;
+    }
+}
+
+- (NSString *)currentSSID {
+    NSArray *interfaces = (__bridge_transfer id) CNCopySupportedInterfaces();
+
+    for (NSString *interface in interfaces) {
+        if ([interface caseInsensitiveCompare:@"en0"] != NSOrderedSame) {
+            continue;
+        }
+
+        NSDictionary *info = (__bridge_transfer id) CNCopyCurrentNetworkInfo((__bridge CFStringRef) interface);
+        NSString *ssid = info[@"SSID"];
+
+        if (ssid) {
+            return ssid;
+        }
+    }
+
+    return @"";
+}
+
+@end
@@ -0,0 +1,106 @@
+//
+//  SSDPDescriptionCache.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "JSONObjectCoding.h"
+
+/// A device description downloaded from an SSDP LOCATION, along with what's
+/// needed to tell whether it's still current.
+@interface SSDPDescriptionCacheEntry : NSObject <JSONObjectCoding>
+
+/// The LOCATION the description was downloaded from.
+@property (nonatomic, strong) NSString *location;
+
+/// BOOTID.UPNP.ORG and CONFIGID.UPNP.ORG from the announcement, if the device
+/// sent them.
+@property (nonatomic, strong) NSString *bootId;
+@property (nonatomic, strong) NSString *configId;
+
+/// Validators from the description response, sent back as If-None-Match and
+/// If-Modified-Since when the entry is revalidated.
+@property (nonatomic, strong) NSString *eTag;
+@property (nonatomic, strong) NSString *lastModified;
+
+@property (nonatomic, strong) NSString *locationXML;
+@property (nonatomic, strong) NSURL *commandURL;
+@property (nonatomic, strong) NSDictionary *responseHeaders;
+
+/// When the description was last downloaded or revalidated.
+@property (nonatomic) double validated;
+
+/// Creates an entry from a description response.
+- (instancetype)initWithLocation:(NSString *)location
+                        response:(NSHTTPURLResponse *)response
+                            data:(NSData *)data;
+
+/// Returns the fields parsed from the description for the given search
+/// target, an empty dictionary if nothing in the description matches it, or
+/// @c nil if it hasn't been parsed for that target yet.
+- (NSDictionary *)descriptionForType:(NSString *)type;
+
+- (void)setDescription:(NSDictionary *)description forType:(NSString *)type;
+
+@end
+
+/// Persistent cache of device descriptions keyed by device UUID, so that known
+/// devices can be announced without downloading their descriptions again.
+///
+/// An entry is only used while the device advertises the same LOCATION and
+/// CONFIGID.UPNP.ORG. Entries older than @c maxAge, or whose BOOTID.UPNP.ORG
+/// has changed, are revalidated with a conditional request.
+@interface SSDPDescriptionCache : NSObject
+
+/// How long an entry is used without revalidating it. Defaults to one day.
+@property (nonatomic) NSTimeInterval maxAge;
+
+/// Most entries kept; the least recently validated ones are dropped first.
+@property (nonatomic) NSUInteger capacity;
+
+/// The cache shared by all SSDP discovery providers, stored in Caches.
++ (instancetype)sharedCache;
+
+/// Creates a cache stored at the given path, or only in memory if @c path is
+/// @c nil.
+- (instancetype)initWithPath:(NSString *)path;
+
+/// Returns the entry for a device if it was downloaded from the same location
+/// and has the same configuration, otherwise @c nil.
+- (SSDPDescriptionCacheEntry *)entryForUUID:(NSString *)UUID
+                                   location:(NSString *)location
+                                   configId:(NSString *)configId;
+
+/// Returns @c YES if the entry is too old to use as is, or the device has
+/// rebooted since it was validated.
+- (BOOL)entryNeedsRevalidation:(SSDPDescriptionCacheEntry *)entry
+                        bootId:(NSString *)bootId;
+
+- (void)setEntry:(SSDPDescriptionCacheEntry *)entry forUUID:(NSString *)UUID;
+
+/// Marks an entry as validated now, after the device answered a conditional
+/// request with 304, and records its new BOOTID.UPNP.ORG. The entry is shared
+/// with every lookup, so it's only changed under the cache's lock.
+- (void)revalidateEntry:(SSDPDescriptionCacheEntry *)entry
+                 bootId:(NSString *)bootId
+                forUUID:(NSString *)UUID;
+
+- (void)removeEntryForUUID:(NSString *)UUID;
+- (void)removeAllEntries;
+
+@end
@@ -0,0 +1,346 @@
+//
+//  SSDPDescriptionCache.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPDescriptionCache.h"
+#import "NSMutableDictionary+NilSafe.h"
+
+static const NSUInteger kDefaultCapacity = 64;
+
+/// Delay before changes are written, so a burst of discoveries is one write.
+static const double kWriteDelay = 1.0;
+
+@implementation SSDPDescriptionCacheEntry
+{
+    NSMutableDictionary *_descriptions;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+
+    if (self)
+        _descriptions = [NSMutableDictionary new];
+
+    return self;
+}
+
+- (instancetype)initWithLocation:(NSString *)location
+                        response:(NSHTTPURLResponse *)response
+                            data:(NSData *)data
+{
+    self = [self init];
+
+    if (self)
+    {
+        NSDictionary *headers = [response isKindOfClass:[NSHTTPURLResponse class]] ? response.allHeaderFields : nil;
+
+        _location = location;
+        _locationXML = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+        _commandURL = response.URL;
+        _responseHeaders = headers;
+        _eTag = [self headerValue:@"ETag" inHeaders:headers];
+        _lastModified = [self headerValue:@"Last-Modified" inHeaders:headers];
+        _validated = [[NSDate date] timeIntervalSince1970];
+    }
+
+    return self;
+}
+
+- (NSString *)headerValue:(NSString *)name inHeaders:(NSDictionary *)headers
+{
+    for (NSString *key in headers)
+    {
+        if ([key caseInsensitiveCompare:name] == NSOrderedSame)
+            return headers[key];
+    }
+
+    return nil;
+}
+
+- (NSDictionary *)descriptionForType:(NSString *)type
+{
+    @synchronized (_descriptions)
+    {
+        return _descriptions[type];
+    }
+}
+
+- (void)setDescription:(NSDictionary *)description forType:(NSString *)type
+{
+    @synchronized (_descriptions)
+    {
+        [_descriptions setNullableObject:description forKey:type];
+    }
+}
+
+#pragma mark - JSONObjectCoding methods
+
+- (instancetype)initWithJSONObject:(NSDictionary *)dict
+{
+    self = [self init];
+
+    if (self)
+    {
+        _location = dict[@"location"];
+        _bootId = dict[@"bootId"];
+        _configId = dict[@"configId"];
+        _eTag = dict[@"eTag"];
+        _lastModified = dict[@"lastModified"];
+        _locationXML = dict[@"locationXML"];
+        _responseHeaders = dict[@"responseHeaders"];
+        _validated = [dict[@"validated"] doubleValue];
+
+        NSString *commandPath = dict[@"commandURL"];
+
+        if (commandPath)
+            _commandURL = [NSURL URLWithString:commandPath];
+
+        NSDictionary *descriptions = dict[@"descriptions"];
+
+        if ([descriptions isKindOfClass:[NSDictionary class]])
+            [_descriptions addEntriesFromDictionary:descriptions];
+    }
+
+    return self;
+}
+
+- (NSDictionary *)toJSONObject
+{
+    NSMutableDictionary *dictionary = [NSMutableDictionary new];
+
+    [dictionary setNullableObject:self.location forKey:@"location"];
+    [dictionary setNullableObject:self.bootId forKey:@"bootId"];
+    [dictionary setNullableObject:self.configId forKey:@"configId"];
+    [dictionary setNullableObject:self.eTag forKey:@"eTag"];
+    [dictionary setNullableObject:self.lastModified forKey:@"lastModified"];
+    [dictionary setNullableObject:self.locationXML forKey:@"locationXML"];
+    [dictionary setNullableObject:self.commandURL.absoluteString forKey:@"commandURL"];
+    [dictionary setNullableObject:self.responseHeaders forKey:@"responseHeaders"];
+    dictionary[@"validated"] = @(self.validated);
+
+    @synchronized (_descriptions)
+    {
+        dictionary[@"descriptions"] = [NSDictionary dictionaryWithDictionary:_descriptions];
+    }
+
+    return [NSDictionary dictionaryWithDictionary:dictionary];
+}
+
+@end
+
+@implementation SSDPDescriptionCache
+{
+    NSString *_path;
+    NSMutableDictionary *_entries;
+
+    BOOL _writeScheduled;
+    dispatch_queue_t _writeQueue;
+}
+
++ (instancetype)sharedCache
+{
+    static SSDPDescriptionCache *sharedCache;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        NSString *caches = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) lastObject];
+        sharedCache = [[SSDPDescriptionCache alloc] initWithPath:[caches stringByAppendingPathComponent:@"Connect_SDK_Description_Cache.json"]];
+    });
+
+    return sharedCache;
+}
+
+- (instancetype)init
+{
+    return [self initWithPath:nil];
+}
+
+- (instancetype)initWithPath:(NSString *)path
+{
+    self = [super init];
+
+    if (self)
+    {
+        _path = path;
+        _maxAge = 24 * 60 * 60; // 1 day
+        _capacity = kDefaultCapacity;
+        _entries = [NSMutableDictionary new];
+        _writeQueue = dispatch_queue_create("Connect_SDK_Description_Cache", DISPATCH_QUEUE_SERIAL);
+
+        [self load];
+    }
+
+    return self;
+}
+
+#pragma mark - Lookup
+
+- (SSDPDescriptionCacheEntry *)entryForUUID:(NSString *)UUID
+                                   location:(NSString *)location
+                                   configId:(NSString *)configId
+{
+    if (!UUID)
+        return nil;
+
+    SSDPDescriptionCacheEntry *entry;
+    @synchronized (self) { entry = _entries[UUID]; }
+
+    if (![entry.location isEqualToString:location])
+        return nil;
+
+    // A changed CONFIGID means the description itself has changed
+    if (configId && entry.configId && ![configId isEqualToString:entry.configId])
+        return nil;
+
+    return entry;
+}
+
+- (BOOL)entryNeedsRevalidation:(SSDPDescriptionCacheEntry *)entry
+                        bootId:(NSString *)bootId
+{
+    @synchronized (self)
+    {
+        if ([[NSDate date] timeIntervalSince1970] - entry.validated > self.maxAge)
+            return YES;
+
+        return bootId && ![bootId isEqualToString:entry.bootId];
+    }
+}
+
+#pragma mark - Changes
+
+- (void)setEntry:(SSDPDescriptionCacheEntry *)entry forUUID:(NSString *)UUID
+{
+    if (!entry || !UUID)
+        return;
+
+    @synchronized (self)
+    {
+        _entries[UUID] = entry;
+
+        while (_entries.count > self.capacity)
+        {
+            NSString *oldest = [[_entries keysSortedByValueUsingComparator:^NSComparisonResult(SSDPDescriptionCacheEntry *a, SSDPDescriptionCacheEntry *b) {
+                return [@(a.validated) compare:@(b.validated)];
+            }] firstObject];
+
+            [_entries removeObjectForKey:oldest];
+        }
+    }
+
+    [self scheduleWrite];
+}
+
+- (void)revalidateEntry:(SSDPDescriptionCacheEntry *)entry
+                 bootId:(NSString *)bootId
+                forUUID:(NSString *)UUID
+{
+    if (!entry || !UUID)
+        return;
+
+    @synchronized (self)
+    {
+        if (bootId)
+            entry.bootId = bootId;
+
+        entry.validated = [[NSDate date] timeIntervalSince1970];
+    }
+
+    [self setEntry:entry forUUID:UUID];
+}
+
+- (void)removeEntryForUUID:(NSString *)UUID
+{
+    if (!UUID)
+        return;
+
+    @synchronized (self) { [_entries removeObjectForKey:UUID]; }
+
+    [self scheduleWrite];
+}
+
+- (void)removeAllEntries
+{
+    @synchronized (self) { [_entries removeAllObjects]; }
+
+    [self scheduleWrite];
+}
+
+#pragma mark - Persistence
+
+- (void)load
+{
+    if (!_path)
+        return;
+
+    NSData *data = [NSData dataWithContentsOfFile:_path];
+
+    if (!data)
+        return;
+
+    NSError *error;
+    NSDictionary *stored = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+
+    if (error || ![stored isKindOfClass:[NSDictionary class]])
+    {
+        DLog(@"Experienced error loading description cache: %@", error.localizedDescription);
+        return;
+    }
+
+    [stored enumerateKeysAndObjectsUsingBlock:^(NSString *UUID, NSDictionary *dict, BOOL *stop) {
+        if ([dict isKindOfClass:[NSDictionary class]])
+            _entries[UUID] = [[SSDPDescriptionCacheEntry alloc] initWithJSONObject:dict];
+    }];
+}
+
+- (void)scheduleWrite
+{
+    if (!_path)
+        return;
+
+    @synchronized (self)
+    {
+        if (_writeScheduled)
+            return;
+
+        _writeScheduled = YES;
+    }
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kWriteDelay * NSEC_PER_SEC)), _writeQueue, ^{
+        NSMutableDictionary *stored = [NSMutableDictionary new];
+
+        @synchronized (self)
+        {
+            _writeScheduled = NO;
+
+            [_entries enumerateKeysAndObjectsUsingBlock:^(NSString *UUID, SSDPDescriptionCacheEntry *entry, BOOL *stop) {
+                stored[UUID] = [entry toJSONObject];
+            }];
+        }
+
+        NSError *error;
+        NSData *data = [NSJSONSerialization dataWithJSONObject:stored options:0 error:&error];
+
+        if (error || ![data writeToFile:_path options:NSDataWritingAtomic error:&error])
+            DLog(@"Experienced error writing description cache: %@", error.localizedDescription);
+    });
+}
+
+@end
@@ -0,0 +1,96 @@
+//
+//  SSDPPacketParser.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// The kind of SSDP message held in a datagram.
+typedef NS_ENUM(NSInteger, SSDPPacketKind) {
+    SSDPPacketKindUnknown = 0,
+
+    /// An @c M-SEARCH request from another control point.
+    SSDPPacketKindSearch,
+
+    /// A @c NOTIFY advertisement or byebye.
+    SSDPPacketKindNotify,
+
+    /// An @c HTTP/1.1 response to one of our searches.
+    SSDPPacketKindResponse
+};
+
+/// A run of bytes inside the datagram. It is not NUL-terminated and is only
+/// valid for as long as the datagram is.
+typedef struct {
+    const char *bytes;
+    size_t length;
+} SSDPHeaderValue;
+
+/// The parts of an SSDP message that discovery needs. Every value points into
+/// the datagram, so parsing doesn't allocate anything.
+typedef struct {
+    SSDPPacketKind kind;
+
+    /// The status code of a response, or 0 for requests.
+    NSInteger statusCode;
+
+    SSDPHeaderValue st;
+    SSDPHeaderValue nt;
+    SSDPHeaderValue nts;
+    SSDPHeaderValue usn;
+    SSDPHeaderValue location;
+    SSDPHeaderValue cacheControl;
+
+    /// BOOTID.UPNP.ORG, which changes whenever the device reboots or rejoins
+    /// the network.
+    SSDPHeaderValue bootId;
+
+    /// CONFIGID.UPNP.ORG, which changes whenever the device description does.
+    SSDPHeaderValue configId;
+
+    /// The device UUID taken from the USN, without the @c uuid: prefix and
+    /// anything from @c :: onwards.
+    SSDPHeaderValue uuid;
+} SSDPPacket;
+
+/// Scans an SSDP datagram in place. Only the start line and the ST, NT, NTS,
+/// USN, LOCATION, CACHE-CONTROL, BOOTID.UPNP.ORG and CONFIGID.UPNP.ORG headers
+/// are read; header names are matched case-insensitively. Returns @c NO if the
+/// datagram isn't an SSDP message or its header isn't terminated by an empty
+/// line.
+BOOL SSDPPacketParse(const void *bytes, size_t length, SSDPPacket *packet);
+
+/// Returns the notification or search target: NT for a NOTIFY, ST otherwise.
+SSDPHeaderValue SSDPPacketType(const SSDPPacket *packet);
+
+/// Returns @c YES for NOTIFY messages and 200 responses, which are the only
+/// messages that announce devices.
+BOOL SSDPPacketIsAnnouncement(const SSDPPacket *packet);
+
+/// Returns @c YES if the NTS header is @c ssdp:byebye.
+BOOL SSDPPacketIsByeBye(const SSDPPacket *packet);
+
+/// Returns the @c max-age directive of the CACHE-CONTROL header in seconds, or
+/// -1 if there isn't one.
+NSInteger SSDPPacketMaxAge(const SSDPPacket *packet);
+
+/// Compares a header value with the given bytes exactly.
+BOOL SSDPHeaderValueEqualsBytes(SSDPHeaderValue value, const void *bytes, size_t length);
+
+/// Creates a string from a header value, or returns @c nil if it's empty.
+NSString *SSDPHeaderValueCopyString(SSDPHeaderValue value);
@@ -0,0 +1,264 @@
+//
+//  SSDPPacketParser.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "SSDPPacketParser.h"
+
+#include <string.h>
+#include <strings.h>
+
+static inline BOOL hasPrefix(const char *bytes, size_t length, const char *prefix, size_t prefixLength)
+{
+    return length >= prefixLength && memcmp(bytes, prefix, prefixLength) == 0;
+}
+
+static inline BOOL isBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/// Returns the length of the line starting at @c bytes, without the line
+/// break, and stores the offset of the next line in @c next. Returns -1 if the
+/// line isn't terminated.
+static ssize_t lineLength(const char *bytes, size_t length, size_t *next)
+{
+    const char *newline = memchr(bytes, '\n', length);
+    if (!newline)
+        return -1;
+
+    size_t end = newline - bytes;
+    *next = end + 1;
+
+    if (end > 0 && bytes[end - 1] == '\r')
+        --end;
+
+    return end;
+}
+
+static SSDPHeaderValue trimmed(const char *bytes, size_t length)
+{
+    while (length > 0 && isBlank(*bytes))
+    {
+        ++bytes;
+        --length;
+    }
+
+    while (length > 0 && isBlank(bytes[length - 1]))
+        --length;
+
+    SSDPHeaderValue value = { bytes, length };
+    return value;
+}
+
+static SSDPHeaderValue uuidFromUSN(SSDPHeaderValue usn)
+{
+    SSDPHeaderValue uuid = { NULL, 0 };
+    static const char kPrefix[] = "uuid:";
+    const size_t prefixLength = sizeof(kPrefix) - 1;
+
+    for (size_t i = 0; i + prefixLength <= usn.length; ++i)
+    {
+        if (strncasecmp(usn.bytes + i, kPrefix, prefixLength) != 0)
+            continue;
+
+        const char *start = usn.bytes + i + prefixLength;
+        size_t remaining = usn.length - i - prefixLength;
+        size_t end = 0;
+
+        while (end < remaining && !(start[end] == ':' && end + 1 < remaining && start[end + 1] == ':'))
+            ++end;
+
+        uuid.bytes = start;
+        uuid.length = end;
+        break;
+    }
+
+    return uuid;
+}
+
+BOOL SSDPPacketParse(const void *bytes, size_t length, SSDPPacket *packet)
+{
+    if (!bytes || !packet)
+        return NO;
+
+    memset(packet, 0, sizeof(SSDPPacket));
+
+    const char *cursor = bytes;
+    size_t remaining = length;
+    size_t next = 0;
+
+    // Start line
+    ssize_t line = lineLength(cursor, remaining, &next);
+    if (line < 0)
+        return NO;
+
+    if (hasPrefix(cursor, line, "HTTP/", 5))
+    {
+        packet->kind = SSDPPacketKindResponse;
+
+        const char *space = memchr(cursor, ' ', line);
+        if (space)
+        {
+            const char *end = cursor + line;
+            for (const char *digit = space + 1; digit < end && *digit >= '0' && *digit <= '9'; ++digit)
+                packet->statusCode = packet->statusCode * 10 + (*digit - '0');
+        }
+    }
+    else if (hasPrefix(cursor, line, "NOTIFY ", 7))
+        packet->kind = SSDPPacketKindNotify;
+    else if (hasPrefix(cursor, line, "M-SEARCH ", 9))
+        packet->kind = SSDPPacketKindSearch;
+    else
+        return NO;
+
+    cursor += next;
+    remaining -= next;
+
+    // Headers, up to the empty line
+    while (remaining > 0)
+    {
+        line = lineLength(cursor, remaining, &next);
+        if (line < 0)
+            return NO;
+
+        if (line == 0)
+            return YES;
+
+        const char *colon = memchr(cursor, ':', line);
+        if (colon)
+        {
+            SSDPHeaderValue name = trimmed(cursor, colon - cursor);
+            SSDPHeaderValue value = trimmed(colon + 1, cursor + line - colon - 1);
+            SSDPHeaderValue *field = NULL;
+
+            switch (name.length)
+            {
+                case 2:
+                    if (strncasecmp(name.bytes, "ST", 2) == 0)
+                        field = &packet->st;
+                    else if (strncasecmp(name.bytes, "NT", 2) == 0)
+                        field = &packet->nt;
+                    break;
+                case 3:
+                    if (strncasecmp(name.bytes, "NTS", 3) == 0)
+                        field = &packet->nts;
+                    else if (strncasecmp(name.bytes, "USN", 3) == 0)
+                        field = &packet->usn;
+                    break;
+                case 8:
+                    if (strncasecmp(name.bytes, "LOCATION", 8) == 0)
+                        field = &packet->location;
+                    break;
+                case 13:
+                    if (strncasecmp(name.bytes, "CACHE-CONTROL", 13) == 0)
+                        field = &packet->cacheControl;
+                    break;
+                case 15:
+                    if (strncasecmp(name.bytes, "BOOTID.UPNP.ORG", 15) == 0)
+                        field = &packet->bootId;
+                    break;
+                case 17:
+                    if (strncasecmp(name.bytes, "CONFIGID.UPNP.ORG", 17) == 0)
+                        field = &packet->configId;
+                    break;
+            }
+
+            if (field)
+            {
+                *field = value;
+
+                if (field == &packet->usn)
+                    packet->uuid = uuidFromUSN(value);
+            }
+        }
+
+        cursor += next;
+        remaining -= next;
+    }
+
+    // Ran out of datagram before the end of the header
+    return NO;
+}
+
+SSDPHeaderValue SSDPPacketType(const SSDPPacket *packet)
+{
+    return (packet->kind == SSDPPacketKindNotify) ? packet->nt : packet->st;
+}
+
+BOOL SSDPPacketIsAnnouncement(const SSDPPacket *packet)
+{
+    return packet->kind == SSDPPacketKindNotify ||
+        (packet->kind == SSDPPacketKindResponse && packet->statusCode == 200);
+}
+
+BOOL SSDPPacketIsByeBye(const SSDPPacket *packet)
+{
+    static const char kByeBye[] = "ssdp:byebye";
+    return SSDPHeaderValueEqualsBytes(packet->nts, kByeBye, sizeof(kByeBye) - 1);
+}
+
+NSInteger SSDPPacketMaxAge(const SSDPPacket *packet)
+{
+    static const char kMaxAge[] = "max-age";
+    const size_t directiveLength = sizeof(kMaxAge) - 1;
+    SSDPHeaderValue value = packet->cacheControl;
+
+    for (size_t i = 0; i + directiveLength <= value.length; ++i)
+    {
+        if (strncasecmp(value.bytes + i, kMaxAge, directiveLength) != 0)
+            continue;
+
+        size_t position = i + directiveLength;
+
+        while (position < value.length && isBlank(value.bytes[position]))
+            ++position;
+
+        if (position >= value.length || value.bytes[position] != '=')
+            return -1;
+
+        ++position;
+
+        while (position < value.length && isBlank(value.bytes[position]))
+            ++position;
+
+        NSInteger maxAge = -1;
+
+        for (; position < value.length && value.bytes[position] >= '0' && value.bytes[position] <= '9'; ++position)
+            maxAge = (maxAge < 0 ? 0 : maxAge * 10) + (value.bytes[position] - '0');
+
+        return maxAge;
+    }
+
+    return -1;
+}
+
+BOOL SSDPHeaderValueEqualsBytes(SSDPHeaderValue value, const void *bytes, size_t length)
+{
+    return value.length == length && (length == 0 || memcmp(value.bytes, bytes, length) == 0);
+}
+
+NSString *SSDPHeaderValueCopyString(SSDPHeaderValue value)
+{
+    if (value.length == 0)
+        return nil;
+
+    return [[NSString alloc] initWithBytes:value.bytes
+                                    length:value.length
+                                  encoding:NSUTF8StringEncoding];
+}
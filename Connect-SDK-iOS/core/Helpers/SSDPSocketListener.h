@@ -22,10 +22,24 @@
 
 @class SSDPSocketListener;
 
+/// A single datagram and the address it came from.
+@interface SSDPDatagram : NSObject
+
+@property (nonatomic, readonly) NSData *data;
+@property (nonatomic, readonly) NSString *address;
+
+- (instancetype)initWithData:(NSData *)aData address:(NSString *)anAddress;
+
+@end
+
 @protocol SocketListenerDelegate <NSObject>
 
 @optional
 
+/// Called with every datagram that was waiting when the socket became
+/// readable, in the order they arrived. If this isn't implemented,
+/// @c -socket:didReceiveData:fromAddress: is called for each datagram instead.
+- (void)socket:(SSDPSocketListener *)aSocket didReceiveDatagrams:(NSArray *)datagrams;
 - (void)socket:(SSDPSocketListener *)aSocket didReceiveData:(NSData *)aData fromAddress:(NSString *)anAddress;
 - (void)socket:(SSDPSocketListener *)aSocket didEncounterError:(NSError *)anError;
 
@@ -24,13 +24,131 @@
 #import <sys/types.h>
 #import <netinet/in.h>
 #import <arpa/inet.h>
+#import <fcntl.h>
+#import <errno.h>
+#import <libkern/OSAtomic.h>
 #import "ConnectError.h"
 
+/// Largest datagram we accept. SSDP messages are well under this; anything
+/// larger is dropped rather than delivered truncated.
+static const size_t kSSDPReceiveBufferSize = 8192;
+
+/// Number of receive buffers in the ring, which is also the most datagrams
+/// read in a single wakeup.
+static const NSUInteger kSSDPReceiveBufferCount = 32;
+
+/// Maximum number of cached source address strings.
+static const NSUInteger kSSDPAddressCacheLimit = 256;
+
+#pragma mark - Datagram
+
+@implementation SSDPDatagram
+
+- (instancetype)initWithData:(NSData *)aData address:(NSString *)anAddress
+{
+	self = [super init];
+	if (self)
+	{
+		_data = aData;
+		_address = anAddress;
+	}
+	return self;
+}
+
+@end
+
+#pragma mark - Receive ring
+
+/// A fixed ring of receive buffers. A datagram's @c NSData wraps its buffer
+/// without copying, and the buffer goes back into the ring when that
+/// @c NSData is released. The ring is kept alive by any outstanding data, so it
+/// can outlive the listener.
+@interface SSDPReceiveRing : NSObject
+
+/// Returns a free buffer of @c kSSDPReceiveBufferSize bytes, or @c NULL if
+/// every buffer is still in use.
+- (char *)acquireBuffer;
+
+/// Wraps @c length bytes of an acquired buffer. The buffer is released back to
+/// the ring when the data is deallocated.
+- (NSData *)dataWithBuffer:(char *)buffer length:(size_t)length;
+
+/// Returns an acquired buffer that wasn't used.
+- (void)releaseBuffer:(char *)buffer;
+
+@end
+
+@implementation SSDPReceiveRing
+{
+	char *_storage;
+	uint32_t _inUse;
+	OSSpinLock _lock;
+}
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self)
+	{
+		_storage = malloc(kSSDPReceiveBufferSize * kSSDPReceiveBufferCount);
+		_lock = OS_SPINLOCK_INIT;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_storage);
+}
+
+- (char *)acquireBuffer
+{
+	char *buffer = NULL;
+
+	OSSpinLockLock(&_lock);
+	for (NSUInteger index = 0; index < kSSDPReceiveBufferCount; ++index)
+	{
+		if (!(_inUse & (1u << index)))
+		{
+			_inUse |= (1u << index);
+			buffer = _storage + index * kSSDPReceiveBufferSize;
+			break;
+		}
+	}
+	OSSpinLockUnlock(&_lock);
+
+	return buffer;
+}
+
+- (void)releaseBuffer:(char *)buffer
+{
+	NSUInteger index = (buffer - _storage) / kSSDPReceiveBufferSize;
+
+	OSSpinLockLock(&_lock);
+	_inUse &= ~(1u << index);
+	OSSpinLockUnlock(&_lock);
+}
+
+- (NSData *)dataWithBuffer:(char *)buffer length:(size_t)length
+{
+	return [[NSData alloc] initWithBytesNoCopy:buffer
+										length:length
+								   deallocator:^(void *bytes, NSUInteger ignored) {
+									   [self releaseBuffer:bytes];
+								   }];
+}
+
+@end
+
+#pragma mark - Listener
+
 @implementation SSDPSocketListener
 {
 	BOOL _isListening;
 	dispatch_source_t _dispatchSource;
 	int _socket;
+	SSDPReceiveRing *_ring;
+	NSMutableDictionary *_addressCache;
 }
 
 - (instancetype)initWithAddress:(NSString *)anAddress andPort:(NSInteger)aPort
@@ -78,17 +196,99 @@
 		});
 }
 
-- (void)didReceiveData:(NSData *)aData fromAddress:(NSString *)anAddress
+- (void)didReceiveDatagrams:(NSArray *)datagrams
 {
 	dispatch_async(self.delegateQueue,
         ^{
-            if ([self.delegate respondsToSelector:@selector(socket:didReceiveData:fromAddress:)])
+            if ([self.delegate respondsToSelector:@selector(socket:didReceiveDatagrams:)])
+			{
+				[self.delegate socket:self didReceiveDatagrams:datagrams];
+			}
+			else if ([self.delegate respondsToSelector:@selector(socket:didReceiveData:fromAddress:)])
 			{
-				[self.delegate socket:self didReceiveData:aData fromAddress:anAddress];
+				for (SSDPDatagram *datagram in datagrams)
+					[self.delegate socket:self didReceiveData:datagram.data fromAddress:datagram.address];
 			}
     });
 }
 
+/// Returns the dotted string for a source address, reusing the string from
+/// earlier datagrams from the same device.
+- (NSString *)stringForAddress:(struct in_addr)anAddress
+{
+	NSNumber *key = @(anAddress.s_addr);
+	NSString *string = _addressCache[key];
+
+	if (!string)
+	{
+		char theCAddrBuffer[INET_ADDRSTRLEN];
+		memset(theCAddrBuffer, 0, INET_ADDRSTRLEN);
+		inet_ntop(AF_INET, &anAddress, theCAddrBuffer, INET_ADDRSTRLEN);
+		string = [[NSString alloc] initWithUTF8String:theCAddrBuffer];
+
+		if (_addressCache.count >= kSSDPAddressCacheLimit)
+			[_addressCache removeAllObjects];
+
+		_addressCache[key] = string;
+	}
+
+	return string;
+}
+
+/// Reads every datagram that is waiting on the socket, up to the size of the
+/// ring, and hands them to the delegate in one go.
+- (void)drainSocket:(int)aSocket
+{
+	NSMutableArray *theDatagrams = [NSMutableArray array];
+
+	while (theDatagrams.count < kSSDPReceiveBufferCount)
+	{
+		char *theBuffer = [_ring acquireBuffer];
+		BOOL theBufferIsFromRing = (theBuffer != NULL);
+
+		// Everything in the ring is still being processed
+		if (!theBufferIsFromRing)
+			theBuffer = malloc(kSSDPReceiveBufferSize);
+
+		struct sockaddr_in theIncomingAddr;
+		memset(&theIncomingAddr, 0, sizeof(theIncomingAddr));
+
+		struct iovec theVector = { theBuffer, kSSDPReceiveBufferSize };
+		struct msghdr theMessage;
+		memset(&theMessage, 0, sizeof(theMessage));
+		theMessage.msg_name = &theIncomingAddr;
+		theMessage.msg_namelen = sizeof(theIncomingAddr);
+		theMessage.msg_iov = &theVector;
+		theMessage.msg_iovlen = 1;
+
+		ssize_t theReceiveBytesCount = recvmsg(aSocket, &theMessage, 0);
+		BOOL isUsable = theReceiveBytesCount > 0 && !(theMessage.msg_flags & MSG_TRUNC);
+
+		if (isUsable)
+		{
+			NSData *theData = theBufferIsFromRing
+				? [_ring dataWithBuffer:theBuffer length:theReceiveBytesCount]
+				: [[NSData alloc] initWithBytesNoCopy:theBuffer length:theReceiveBytesCount freeWhenDone:YES];
+
+			[theDatagrams addObject:[[SSDPDatagram alloc] initWithData:theData
+															   address:[self stringForAddress:theIncomingAddr.sin_addr]]];
+			continue;
+		}
+
+		if (theBufferIsFromRing)
+			[_ring releaseBuffer:theBuffer];
+		else
+			free(theBuffer);
+
+		// Nothing left to read. Oversized datagrams are skipped.
+		if (theReceiveBytesCount < 0 && errno != EINTR)
+			break;
+	}
+
+	if (theDatagrams.count > 0)
+		[self didReceiveDatagrams:theDatagrams];
+}
+
 - (void)open
 {
 	int   theSocketDescriptor = socket (PF_INET, SOCK_DGRAM, 0);
@@ -133,31 +333,17 @@
 		return;
 	}
 
+	// Reads stop at EAGAIN instead of blocking once the socket is drained
+	fcntl(theSocketDescriptor, F_SETFL, fcntl(theSocketDescriptor, F_GETFL, 0) | O_NONBLOCK);
+
+	_ring = [SSDPReceiveRing new];
+	_addressCache = [NSMutableDictionary dictionary];
+
 	_dispatchSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, theSocketDescriptor, 0, self.workQueue);
 	_socket = theSocketDescriptor;
 	dispatch_source_set_event_handler(_dispatchSource,
 		^{
-			struct sockaddr_in theIncomingAddr;
-			memset(&theIncomingAddr, 0, sizeof(theIncomingAddr));
-			size_t theDataSize = dispatch_source_get_data(_dispatchSource);
-			char theBuffer[theDataSize + 1];
-			int theReceiveBytesCount = 0;
-			socklen_t theAddressSize = sizeof(theIncomingAddr);
-			while (theReceiveBytesCount < theDataSize)
-			{
-				theReceiveBytesCount += recvfrom(theSocketDescriptor, theBuffer,
-					sizeof(theBuffer), 0, (struct sockaddr*)&theIncomingAddr, &theAddressSize);
-			}
-			char theCAddrBuffer[SOCK_MAXADDRLEN];
-			memset(theCAddrBuffer, 0, SOCK_MAXADDRLEN);
-			inet_ntop(theIncomingAddr.sin_family, &theIncomingAddr.sin_addr, theCAddrBuffer, SOCK_MAXADDRLEN);
-
-			NSString *thePath = [[NSString alloc] initWithBytes:theCAddrBuffer
-				length:strlen(theCAddrBuffer) encoding:NSUTF8StringEncoding];
-			NSData * theReceivedData = [NSData dataWithBytes:theBuffer length:theDataSize];
-            
-			[self didReceiveData:theReceivedData fromAddress:thePath];
-			
+			[self drainSocket:theSocketDescriptor];
 		});
 	
 	dispatch_resume(_dispatchSource);
@@ -0,0 +1,67 @@
+//
+//  StreamChunkCache.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// On-disk cache of fixed-size chunks of remote media. Each stream is cached
+/// under its own key and each chunk is a file named after its index, so a
+/// chunk is only ever written once and can be mapped straight back in.
+///
+/// Chunks, and the length and type of the streams they belong to, are kept
+/// across launches. Once the cache grows past @c capacity the
+/// least recently used chunks are deleted first.
+@interface StreamChunkCache : NSObject
+
+/// Size of every chunk but the last one of a stream, in bytes.
+@property (nonatomic, readonly) NSUInteger chunkSize;
+
+/// Most bytes kept on disk. Defaults to 512 MB.
+@property (nonatomic) unsigned long long capacity;
+
+/// Bytes currently on disk.
+@property (nonatomic, readonly) unsigned long long size;
+
+/// Creates a cache of 1 MB chunks stored in the given directory, picking up
+/// any chunks that are already there.
+- (instancetype)initWithDirectory:(NSString *)directory;
+
+- (instancetype)initWithDirectory:(NSString *)directory chunkSize:(NSUInteger)chunkSize;
+
+/// Returns the chunk mapped from disk, or @c nil if it isn't cached.
+- (NSData *)chunkAtIndex:(NSUInteger)index forKey:(NSString *)key;
+
+- (BOOL)hasChunkAtIndex:(NSUInteger)index forKey:(NSString *)key;
+
+/// Writes a chunk to disk, evicting older chunks if the cache is over
+/// capacity.
+- (void)storeChunk:(NSData *)data atIndex:(NSUInteger)index forKey:(NSString *)key;
+
+/// Records the total length and MIME type of a stream, so that its cached
+/// chunks can be served after a relaunch without asking upstream again.
+- (void)setLength:(unsigned long long)length contentType:(NSString *)contentType forKey:(NSString *)key;
+
+/// Returns the length recorded for a stream, or -1 if there isn't one.
+- (long long)lengthForKey:(NSString *)key;
+
+- (NSString *)contentTypeForKey:(NSString *)key;
+
+- (void)removeAllChunks;
+
+@end
@@ -0,0 +1,254 @@
+//
+//  StreamChunkCache.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "StreamChunkCache.h"
+
+static const NSUInteger kDefaultChunkSize = 1024 * 1024;
+static const unsigned long long kDefaultCapacity = 512 * 1024 * 1024;
+
+/// Name of the file in each stream's directory that holds its length and type.
+static NSString *const kStreamInfoName = @"stream.plist";
+
+@implementation StreamChunkCache
+{
+    NSString *_directory;
+
+    /// Paths of the cached chunks relative to @c _directory, least recently
+    /// used first.
+    NSMutableOrderedSet *_chunks;
+    NSMutableDictionary *_chunkSizes;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory
+{
+    return [self initWithDirectory:directory chunkSize:kDefaultChunkSize];
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory chunkSize:(NSUInteger)chunkSize
+{
+    self = [super init];
+
+    if (self)
+    {
+        _directory = [directory copy];
+        _chunkSize = chunkSize;
+        _capacity = kDefaultCapacity;
+        _chunks = [NSMutableOrderedSet new];
+        _chunkSizes = [NSMutableDictionary new];
+
+        [self load];
+    }
+
+    return self;
+}
+
+#pragma mark - Lookup
+
+- (NSData *)chunkAtIndex:(NSUInteger)index forKey:(NSString *)key
+{
+    NSString *chunk = [self pathForChunkAtIndex:index key:key];
+
+    @synchronized (self)
+    {
+        if (![_chunks containsObject:chunk])
+            return nil;
+
+        // Move it to the end so it's evicted last
+        [_chunks removeObject:chunk];
+        [_chunks addObject:chunk];
+    }
+
+    NSError *error;
+    NSData *data = [NSData dataWithContentsOfFile:[_directory stringByAppendingPathComponent:chunk]
+                                          options:NSDataReadingMappedIfSafe
+                                            error:&error];
+
+    if (!data)
+    {
+        DLog(@"Experienced error reading stream chunk %@: %@", chunk, error.localizedDescription);
+        [self forgetChunk:chunk];
+    }
+
+    return data;
+}
+
+- (BOOL)hasChunkAtIndex:(NSUInteger)index forKey:(NSString *)key
+{
+    NSString *chunk = [self pathForChunkAtIndex:index key:key];
+
+    @synchronized (self) { return [_chunks containsObject:chunk]; }
+}
+
+- (long long)lengthForKey:(NSString *)key
+{
+    NSNumber *length = [self infoForKey:key][@"length"];
+
+    return [length isKindOfClass:[NSNumber class]] ? length.longLongValue : -1;
+}
+
+- (NSString *)contentTypeForKey:(NSString *)key
+{
+    NSString *contentType = [self infoForKey:key][@"contentType"];
+
+    return [contentType isKindOfClass:[NSString class]] ? contentType : nil;
+}
+
+- (NSDictionary *)infoForKey:(NSString *)key
+{
+    if (!key)
+        return nil;
+
+    return [NSDictionary dictionaryWithContentsOfFile:[[_directory stringByAppendingPathComponent:key] stringByAppendingPathComponent:kStreamInfoName]];
+}
+
+#pragma mark - Changes
+
+- (void)setLength:(unsigned long long)length contentType:(NSString *)contentType forKey:(NSString *)key
+{
+    if (!key)
+        return;
+
+    NSString *directory = [_directory stringByAppendingPathComponent:key];
+    NSMutableDictionary *info = [NSMutableDictionary dictionaryWithObject:@(length) forKey:@"length"];
+
+    if (contentType)
+        info[@"contentType"] = contentType;
+
+    [[NSFileManager defaultManager] createDirectoryAtPath:directory
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+
+    if (![info writeToFile:[directory stringByAppendingPathComponent:kStreamInfoName] atomically:YES])
+        DLog(@"Experienced error writing stream info for %@", key);
+}
+
+- (void)storeChunk:(NSData *)data atIndex:(NSUInteger)index forKey:(NSString *)key
+{
+    if (!data || !key)
+        return;
+
+    NSString *chunk = [self pathForChunkAtIndex:index key:key];
+    NSString *path = [_directory stringByAppendingPathComponent:chunk];
+    NSError *error;
+
+    [[NSFileManager defaultManager] createDirectoryAtPath:[path stringByDeletingLastPathComponent]
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+
+    if (![data writeToFile:path options:NSDataWritingAtomic error:&error])
+    {
+        DLog(@"Experienced error writing stream chunk %@: %@", chunk, error.localizedDescription);
+        return;
+    }
+
+    NSMutableArray *evicted = [NSMutableArray array];
+
+    @synchronized (self)
+    {
+        _size -= [_chunkSizes[chunk] unsignedLongLongValue];
+        _size += data.length;
+        _chunkSizes[chunk] = @(data.length);
+
+        [_chunks removeObject:chunk];
+        [_chunks addObject:chunk];
+
+        // Never evict the chunk that was just written
+        while (_size > self.capacity && _chunks.count > 1)
+        {
+            NSString *oldest = _chunks.firstObject;
+            [evicted addObject:oldest];
+
+            _size -= [_chunkSizes[oldest] unsignedLongLongValue];
+            [_chunkSizes removeObjectForKey:oldest];
+            [_chunks removeObjectAtIndex:0];
+        }
+    }
+
+    for (NSString *oldest in evicted)
+        [[NSFileManager defaultManager] removeItemAtPath:[_directory stringByAppendingPathComponent:oldest] error:nil];
+}
+
+- (void)removeAllChunks
+{
+    @synchronized (self)
+    {
+        [_chunks removeAllObjects];
+        [_chunkSizes removeAllObjects];
+        _size = 0;
+    }
+
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:nil];
+}
+
+- (void)forgetChunk:(NSString *)chunk
+{
+    @synchronized (self)
+    {
+        _size -= [_chunkSizes[chunk] unsignedLongLongValue];
+        [_chunkSizes removeObjectForKey:chunk];
+        [_chunks removeObject:chunk];
+    }
+}
+
+#pragma mark - Persistence
+
+- (NSString *)pathForChunkAtIndex:(NSUInteger)index key:(NSString *)key
+{
+    return [key stringByAppendingPathComponent:[NSString stringWithFormat:@"%lu", (unsigned long)index]];
+}
+
+/// Indexes the chunks left on disk by an earlier launch, oldest first.
+- (void)load
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray *keys = @[NSURLIsRegularFileKey, NSURLFileSizeKey, NSURLContentModificationDateKey];
+    NSDirectoryEnumerator *enumerator = [fileManager enumeratorAtURL:[NSURL fileURLWithPath:_directory]
+                                          includingPropertiesForKeys:keys
+                                                             options:0
+                                                        errorHandler:nil];
+    NSMutableArray *found = [NSMutableArray array];
+
+    for (NSURL *url in enumerator)
+    {
+        NSDictionary *values = [url resourceValuesForKeys:keys error:nil];
+
+        if (![values[NSURLIsRegularFileKey] boolValue] || [url.lastPathComponent isEqualToString:kStreamInfoName])
+            continue;
+
+        [found addObject:@{
+            @"chunk": [url.URLByDeletingLastPathComponent.lastPathComponent stringByAppendingPathComponent:url.lastPathComponent],
+            @"size": values[NSURLFileSizeKey] ?: @0,
+            @"date": values[NSURLContentModificationDateKey] ?: [NSDate distantPast]
+        }];
+    }
+
+    [found sortUsingDescriptors:@[[NSSortDescriptor sortDescriptorWithKey:@"date" ascending:YES]]];
+
+    for (NSDictionary *chunk in found)
+    {
+        [_chunks addObject:chunk[@"chunk"]];
+        _chunkSizes[chunk[@"chunk"]] = chunk[@"size"];
+        _size += [chunk[@"size"] unsignedLongLongValue];
+    }
+}
+
+@end
@@ -0,0 +1,80 @@
+//
+//  StreamProxy.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// Local HTTP server that renderers on the LAN can play remote media through.
+///
+/// The device fetches the media from upstream in fixed-size chunks, keeps them
+/// in an on-disk cache and reads ahead of whatever is being played. Adjacent
+/// missing chunks are fetched with one Range request, and renderers asking for
+/// a chunk that's already on its way wait for that fetch rather than starting
+/// another, so several renderers playing the same media share one download.
+/// Seeking back into a part that's already been fetched is served from the
+/// cache.
+///
+/// Proxy URLs only contain a digest of the upstream URL, so any credentials in
+/// its query never reach the renderer.
+///
+/// The same server also serves files that are already on the device, so they
+/// can be played without any WAN traffic. Files and proxied streams are sent
+/// with byte range support and DLNA contentFeatures.dlna.org and
+/// transferMode.dlna.org headers.
+@interface StreamProxy : NSObject
+
+/// Port the proxy listens on.
+@property (nonatomic, readonly) NSUInteger port;
+
+@property (nonatomic, readonly) BOOL isRunning;
+
+/// Number of chunks kept fetched ahead of the one being read. Defaults to 4.
+@property (nonatomic) NSUInteger readAheadChunks;
+
+/// The proxy shared by the whole app, listening on port 49292 and caching in
+/// Caches.
++ (instancetype)sharedProxy;
+
+- (instancetype)initWithPort:(NSUInteger)port;
+
+/// Starts listening, or returns @c YES straight away if already running. The
+/// server keeps running in the background, but only for as long as iOS lets
+/// the app run, so callers should hold a background task while renderers are
+/// using it.
+- (BOOL)start;
+
+/// Stops listening and cancels every upstream fetch. Cached chunks are kept.
+- (void)stop;
+
+/// Returns the URL a renderer should use to play @c url, starting the proxy if
+/// needed, or @c nil if the proxy can't start or the device has no LAN
+/// address.
+- (NSURL *)proxyURLForURL:(NSURL *)url;
+
+/// Returns a URL a renderer can use to play the local file at @c path,
+/// starting the proxy if needed, or @c nil if the proxy can't start or the
+/// device has no LAN address. Every call hands out a new random token, which
+/// is the only way to reach the file and stays valid until
+/// @c revokeFileURLs is called.
+- (NSURL *)URLForFileAtPath:(NSString *)path;
+
+/// Invalidates every URL handed out by @c URLForFileAtPath:.
+- (void)revokeFileURLs;
+
+@end
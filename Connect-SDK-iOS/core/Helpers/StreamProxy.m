@@ -0,0 +1,776 @@
+//
+//  StreamProxy.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "StreamProxy_Private.h"
+#import "ConnectError.h"
+#import "DLNAContentFeatures.h"
+#import "GCDWebServer.h"
+#import "GCDWebServerErrorResponse.h"
+#import "GCDWebServerFileResponse.h"
+#import "GCDWebServerFunctions.h"
+#import "GCDWebServerStreamedResponse.h"
+
+#import <CommonCrypto/CommonDigest.h>
+
+static const NSUInteger kDefaultPort = 49292;
+static const NSUInteger kDefaultReadAheadChunks = 4;
+
+typedef void (^StreamChunkBlock)(NSData *chunk, NSError *error);
+
+/// Returns the hex SHA-1 of the URL, which names the stream both in proxy URLs
+/// and in the chunk cache.
+static NSString *streamKey(NSURL *url)
+{
+    NSData *data = [url.absoluteString dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1(data.bytes, (CC_LONG)data.length, digest);
+
+    NSMutableString *key = [NSMutableString stringWithCapacity:CC_SHA1_DIGEST_LENGTH * 2];
+
+    for (NSUInteger i = 0; i < CC_SHA1_DIGEST_LENGTH; ++i)
+        [key appendFormat:@"%02x", digest[i]];
+
+    return key;
+}
+
+/// Returns 128 random bits as hex, for naming a file-serving session.
+static NSString *randomToken(void)
+{
+    uint8_t bytes[16];
+    arc4random_buf(bytes, sizeof(bytes));
+
+    NSMutableString *token = [NSMutableString stringWithCapacity:sizeof(bytes) * 2];
+
+    for (NSUInteger i = 0; i < sizeof(bytes); ++i)
+        [token appendFormat:@"%02x", bytes[i]];
+
+    return token;
+}
+
+static void addDLNAHeaders(GCDWebServerResponse *response, NSString *mimeType)
+{
+    [response setValue:@"bytes" forAdditionalHeader:@"Accept-Ranges"];
+    [response setValue:DLNAContentFeatures(mimeType) forAdditionalHeader:@"contentFeatures.dlna.org"];
+    [response setValue:DLNATransferMode(mimeType) forAdditionalHeader:@"transferMode.dlna.org"];
+}
+
+static NSString *headerValue(NSHTTPURLResponse *response, NSString *name)
+{
+    for (NSString *header in response.allHeaderFields)
+    {
+        if ([header caseInsensitiveCompare:name] == NSOrderedSame)
+            return response.allHeaderFields[header];
+    }
+
+    return nil;
+}
+
+/// Reads the first byte and total length from a Content-Range header such as
+/// @c bytes 0-1023/4096 or @c bytes */4096. The total is -1 if it's @c * or
+/// missing.
+static BOOL parseContentRange(NSString *contentRange, unsigned long long *first, long long *total)
+{
+    NSScanner *scanner = [NSScanner scannerWithString:contentRange ?: @""];
+    unsigned long long last;
+
+    *first = 0;
+    *total = -1;
+
+    if (![scanner scanString:@"bytes" intoString:NULL])
+        return NO;
+
+    if (![scanner scanString:@"*" intoString:NULL])
+    {
+        if (![scanner scanUnsignedLongLong:first] || ![scanner scanString:@"-" intoString:NULL] ||
+            ![scanner scanUnsignedLongLong:&last])
+            return NO;
+    }
+
+    if ([scanner scanString:@"/" intoString:NULL])
+        [scanner scanLongLong:total];
+
+    return YES;
+}
+
+/// Returns the span covering every satisfiable range in @c ranges, which come
+/// from GCDWebServerRequest's @c byteRanges, or a location of NSNotFound if
+/// none of them is satisfiable.
+static NSRange spanOfRanges(NSArray *ranges, NSUInteger length)
+{
+    NSUInteger start = NSUIntegerMax;
+    NSUInteger end = 0;
+
+    for (NSValue *value in ranges)
+    {
+        NSRange range = [value rangeValue];
+
+        if (range.location == NSUIntegerMax)
+        {
+            // A suffix range
+            range.length = MIN(range.length, length);
+            range.location = length - range.length;
+        }
+        else if (range.location >= length)
+            continue;
+        else
+            range.length = MIN(range.length, length - range.location);
+
+        if (range.length == 0)
+            continue;
+
+        start = MIN(start, range.location);
+        end = MAX(end, NSMaxRange(range));
+    }
+
+    if (start == NSUIntegerMax)
+        return NSMakeRange(NSNotFound, 0);
+
+    return NSMakeRange(start, end - start);
+}
+
+/// Returns part of a chunk without copying it. The chunk is kept alive, and
+/// mapped, for as long as the slice is.
+static NSData *sliceOfChunk(NSData *chunk, NSUInteger offset, NSUInteger length)
+{
+    if (offset == 0 && length == chunk.length)
+        return chunk;
+
+    return [[NSData alloc] initWithBytesNoCopy:(char *)chunk.bytes + offset
+                                        length:length
+                                   deallocator:^(void *bytes, NSUInteger sliceLength) {
+                                       [chunk self];
+                                   }];
+}
+
+/// A stream the proxy has handed out a URL for.
+@interface StreamProxyResource : NSObject
+
+@property (nonatomic, strong) NSURL *URL;
+@property (nonatomic, strong) NSString *key;
+
+/// Total length in bytes, or -1 until upstream has said. It's kept in the
+/// cache along with the chunks.
+@property (nonatomic) long long length;
+
+@property (nonatomic, strong) NSString *contentType;
+
+/// Blocks waiting for chunks keyed by chunk index. A chunk with an entry is
+/// being fetched, even if nobody is waiting for it yet.
+@property (nonatomic, strong) NSMutableDictionary *waiters;
+
+@end
+
+@implementation StreamProxyResource
+
+@end
+
+/// A single upstream Range request for a run of chunks.
+@interface StreamProxyFetch : NSObject
+
+@property (nonatomic, strong) StreamProxyResource *resource;
+
+/// The chunk currently being filled, and the one after the last chunk asked
+/// for.
+@property (nonatomic) NSUInteger nextChunk;
+@property (nonatomic) NSUInteger endChunk;
+
+/// Data received since the last complete chunk.
+@property (nonatomic, strong) NSMutableData *buffer;
+
+@end
+
+@implementation StreamProxyFetch
+
+@end
+
+@interface StreamProxy () <NSURLSessionDataDelegate>
+
+@end
+
+@implementation StreamProxy
+{
+    GCDWebServer *_server;
+    dispatch_queue_t _queue;
+
+    /// Everything below is only used on @c _queue.
+    NSURLSession *_session;
+
+    /// Streams keyed by the key in their proxy path.
+    NSMutableDictionary *_resources;
+
+    /// Upstream fetches keyed by task identifier.
+    NSMutableDictionary *_fetches;
+
+    /// Paths of local files keyed by the token in their path.
+    NSMutableDictionary *_files;
+}
+
++ (instancetype)sharedProxy
+{
+    static StreamProxy *sharedProxy;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedProxy = [[StreamProxy alloc] initWithPort:kDefaultPort];
+    });
+
+    return sharedProxy;
+}
+
+- (instancetype)init
+{
+    return [self initWithPort:kDefaultPort];
+}
+
+- (instancetype)initWithPort:(NSUInteger)port
+{
+    NSString *caches = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) lastObject];
+    StreamChunkCache *cache = [[StreamChunkCache alloc] initWithDirectory:[caches stringByAppendingPathComponent:@"Connect_SDK_Stream_Cache"]];
+
+    return [self initWithPort:port cache:cache];
+}
+
+- (instancetype)initWithPort:(NSUInteger)port cache:(StreamChunkCache *)cache
+{
+    self = [super init];
+
+    if (self)
+    {
+        _port = port;
+        _cache = cache;
+        _readAheadChunks = kDefaultReadAheadChunks;
+        _queue = dispatch_queue_create("Connect_SDK_Stream_Proxy", DISPATCH_QUEUE_SERIAL);
+        _resources = [NSMutableDictionary new];
+        _fetches = [NSMutableDictionary new];
+        _files = [NSMutableDictionary new];
+    }
+
+    return self;
+}
+
+#pragma mark - Server
+
+- (BOOL)isRunning
+{
+    return _server.isRunning;
+}
+
+- (BOOL)start
+{
+    if (self.isRunning)
+        return YES;
+
+    _server = [[GCDWebServer alloc] init];
+
+    __weak StreamProxy *weakSelf = self;
+
+    [_server addHandlerForMethod:@"GET"
+                       pathRegex:@"^/stream/[0-9a-f]+$"
+                    requestClass:[GCDWebServerRequest class]
+               asyncProcessBlock:^(GCDWebServerRequest *request, GCDWebServerCompletionBlock completionBlock) {
+                   StreamProxy *proxy = weakSelf;
+
+                   if (proxy)
+                       [proxy respondToRequest:request completion:completionBlock];
+                   else
+                       completionBlock(nil);
+               }];
+
+    [_server addHandlerForMethod:@"GET"
+                       pathRegex:@"^/file/[0-9a-f]+/"
+                    requestClass:[GCDWebServerRequest class]
+                    processBlock:^GCDWebServerResponse *(GCDWebServerRequest *request) {
+                        return [weakSelf responseForFileRequest:request];
+                    }];
+
+    // The session retains its delegate, so it only lives while the server does
+    NSOperationQueue *delegateQueue = [NSOperationQueue new];
+    delegateQueue.maxConcurrentOperationCount = 1;
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]
+                                                          delegate:self
+                                                     delegateQueue:delegateQueue];
+
+    dispatch_sync(_queue, ^{ _session = session; });
+
+    NSError *error;
+
+    // Renderers keep coming back for more long after the phone locks, so the
+    // server mustn't stop when the app goes into the background. Keeping the
+    // app running is up to whoever hands out the URLs.
+    NSDictionary *options = @{ GCDWebServerOption_Port: @(_port),
+                               GCDWebServerOption_AutomaticallySuspendInBackground: @NO };
+
+    if (![_server startWithOptions:options error:&error])
+    {
+        DLog(@"Experienced error starting stream proxy: %@", error.localizedDescription);
+        [self stop];
+        return NO;
+    }
+
+    return YES;
+}
+
+- (void)stop
+{
+    if (_server.isRunning)
+        [_server stop];
+
+    _server = nil;
+
+    dispatch_sync(_queue, ^{
+        [_session invalidateAndCancel];
+        _session = nil;
+
+        [_fetches removeAllObjects];
+
+        NSError *error = [ConnectError generateErrorWithCode:ConnectStatusCodeError andDetails:@"The stream proxy was stopped"];
+
+        for (StreamProxyResource *resource in _resources.allValues)
+        {
+            for (NSNumber *index in resource.waiters.allKeys)
+                [self finishChunk:index.unsignedIntegerValue ofResource:resource data:nil error:error];
+        }
+    });
+}
+
+- (NSURL *)proxyURLForURL:(NSURL *)url
+{
+    if (!url)
+        return nil;
+
+    return [self URLForPath:[self pathForURL:url]];
+}
+
+- (NSURL *)URLForFileAtPath:(NSString *)path
+{
+    if (!path)
+        return nil;
+
+    return [self URLForPath:[self pathForFileAtPath:path]];
+}
+
+- (NSURL *)URLForPath:(NSString *)path
+{
+    if (![self start])
+        return nil;
+
+    NSURL *serverURL = _server.serverURL;
+
+    if (!serverURL)
+        return nil;
+
+    return [NSURL URLWithString:path relativeToURL:serverURL].absoluteURL;
+}
+
+- (NSString *)pathForURL:(NSURL *)url
+{
+    NSString *key = streamKey(url);
+
+    dispatch_sync(_queue, ^{
+        if (_resources[key])
+            return;
+
+        StreamProxyResource *resource = [StreamProxyResource new];
+        resource.URL = url;
+        resource.key = key;
+        resource.length = [_cache lengthForKey:key];
+        resource.contentType = [_cache contentTypeForKey:key];
+        resource.waiters = [NSMutableDictionary new];
+
+        _resources[key] = resource;
+    });
+
+    return [@"/stream/" stringByAppendingString:key];
+}
+
+- (NSString *)pathForFileAtPath:(NSString *)path
+{
+    NSString *token = randomToken();
+
+    dispatch_sync(_queue, ^{ _files[token] = [path copy]; });
+
+    // Renderers that go by the extension get the file's name as well
+    return [NSString stringWithFormat:@"/file/%@/%@", token, GCDWebServerEscapeURLString(path.lastPathComponent)];
+}
+
+- (void)revokeFileURLs
+{
+    dispatch_sync(_queue, ^{ [_files removeAllObjects]; });
+}
+
+#pragma mark - Responses
+
+- (void)respondToRequest:(GCDWebServerRequest *)request completion:(GCDWebServerCompletionBlock)completion
+{
+    NSString *key = request.path.lastPathComponent;
+
+    dispatch_async(_queue, ^{
+        StreamProxyResource *resource = _resources[key];
+
+        if (!resource)
+        {
+            completion([GCDWebServerErrorResponse responseWithClientError:kGCDWebServerHTTPStatusCode_NotFound message:@"Unknown stream"]);
+            return;
+        }
+
+        if (resource.length >= 0)
+        {
+            completion([self responseForRequest:request resource:resource]);
+            return;
+        }
+
+        // The length is only known once upstream has answered, so fetch the
+        // chunk the request starts in first
+        NSRange first = [[request.byteRanges firstObject] rangeValue];
+        NSUInteger index = (request.byteRanges.count && first.location != NSUIntegerMax) ? first.location / _cache.chunkSize : 0;
+
+        [self chunkAtIndex:index ofResource:resource completion:^(NSData *chunk, NSError *error) {
+            if (resource.length < 0)
+                completion([GCDWebServerErrorResponse responseWithServerError:kGCDWebServerHTTPStatusCode_BadGateway underlyingError:error message:@"Could not reach upstream"]);
+            else
+                completion([self responseForRequest:request resource:resource]);
+        }];
+    });
+}
+
+- (GCDWebServerResponse *)responseForRequest:(GCDWebServerRequest *)request resource:(StreamProxyResource *)resource
+{
+    NSUInteger length = (NSUInteger)resource.length;
+    NSRange range = NSMakeRange(0, length);
+
+    if (request.byteRanges.count)
+    {
+        // Several ranges are served as the one range that spans them all
+        range = spanOfRanges(request.byteRanges, length);
+
+        if (range.location == NSNotFound)
+        {
+            GCDWebServerResponse *response = [GCDWebServerResponse responseWithStatusCode:kGCDWebServerHTTPStatusCode_RequestedRangeNotSatisfiable];
+            [response setValue:[NSString stringWithFormat:@"bytes */%lu", (unsigned long)length] forAdditionalHeader:@"Content-Range"];
+            return response;
+        }
+    }
+
+    __weak StreamProxy *weakSelf = self;
+    NSUInteger chunkSize = _cache.chunkSize;
+    NSUInteger end = NSMaxRange(range);
+    __block NSUInteger offset = range.location;
+
+    GCDWebServerStreamedResponse *response = [GCDWebServerStreamedResponse responseWithContentType:resource.contentType ?: @"application/octet-stream" asyncStreamBlock:^(GCDWebServerBodyReaderCompletionBlock completionBlock) {
+        StreamProxy *proxy = weakSelf;
+
+        if (offset >= end)
+        {
+            completionBlock([NSData data], nil);
+            return;
+        }
+
+        if (!proxy)
+        {
+            completionBlock(nil, [ConnectError generateErrorWithCode:ConnectStatusCodeError andDetails:@"The stream proxy was stopped"]);
+            return;
+        }
+
+        NSUInteger index = offset / chunkSize;
+
+        dispatch_async(proxy->_queue, ^{
+            [proxy chunkAtIndex:index ofResource:resource completion:^(NSData *chunk, NSError *error) {
+                NSUInteger start = offset - index * chunkSize;
+
+                if (chunk.length <= start)
+                {
+                    completionBlock(nil, error ?: [ConnectError generateErrorWithCode:ConnectStatusCodeError andDetails:@"Stream chunk is too short"]);
+                    return;
+                }
+
+                NSUInteger sliceLength = MIN(chunk.length - start, end - offset);
+                offset += sliceLength;
+
+                [proxy readAheadOfChunk:index resource:resource];
+                completionBlock(sliceOfChunk(chunk, start, sliceLength), nil);
+            }];
+        });
+    }];
+
+    response.contentLength = range.length;
+    addDLNAHeaders(response, response.contentType);
+
+    if (request.byteRanges.count)
+    {
+        response.statusCode = kGCDWebServerHTTPStatusCode_PartialContent;
+        [response setValue:[NSString stringWithFormat:@"bytes %lu-%lu/%lu", (unsigned long)range.location, (unsigned long)end - 1, (unsigned long)length]
+       forAdditionalHeader:@"Content-Range"];
+    }
+
+    return response;
+}
+
+- (GCDWebServerResponse *)responseForFileRequest:(GCDWebServerRequest *)request
+{
+    NSArray *components = request.path.pathComponents;
+    NSString *token = (components.count > 2) ? components[2] : nil;
+    __block NSString *path;
+
+    dispatch_sync(_queue, ^{ path = _files[token]; });
+
+    GCDWebServerFileResponse *response = path ? [GCDWebServerFileResponse responseWithFile:path forRequest:request isAttachment:NO] : nil;
+
+    if (!response)
+        return [GCDWebServerErrorResponse responseWithClientError:kGCDWebServerHTTPStatusCode_NotFound message:@"Unknown file"];
+
+    // A multipart response's own type isn't the media's
+    addDLNAHeaders(response, GCDWebServerGetMimeTypeForExtension(path.pathExtension));
+
+    return response;
+}
+
+#pragma mark - Chunks
+
+/// Calls @c completion on the queue once the chunk is available, joining the
+/// fetch that's already bringing it in or starting one for it and the chunks
+/// after it.
+- (void)chunkAtIndex:(NSUInteger)index ofResource:(StreamProxyResource *)resource completion:(StreamChunkBlock)completion
+{
+    NSData *chunk = [_cache chunkAtIndex:index forKey:resource.key];
+
+    if (chunk)
+    {
+        completion(chunk, nil);
+        return;
+    }
+
+    if (resource.length >= 0 && index >= [self chunkCountOfResource:resource])
+    {
+        completion(nil, [ConnectError generateErrorWithCode:ConnectStatusCodeArgumentError andDetails:@"Chunk is past the end of the stream"]);
+        return;
+    }
+
+    if (!resource.waiters[@(index)] && ![self fetchChunksFromIndex:index ofResource:resource])
+    {
+        completion(nil, [ConnectError generateErrorWithCode:ConnectStatusCodeError andDetails:@"The stream proxy isn't running"]);
+        return;
+    }
+
+    [resource.waiters[@(index)] addObject:[completion copy]];
+}
+
+/// Starts fetching the first chunk in the read-ahead window after @c index
+/// that is neither cached nor already on its way.
+- (void)readAheadOfChunk:(NSUInteger)index resource:(StreamProxyResource *)resource
+{
+    NSUInteger last = MIN(index + self.readAheadChunks, [self chunkCountOfResource:resource] - 1);
+
+    for (NSUInteger next = index + 1; next <= last; ++next)
+    {
+        if (!resource.waiters[@(next)] && ![_cache hasChunkAtIndex:next forKey:resource.key])
+        {
+            [self fetchChunksFromIndex:next ofResource:resource];
+            return;
+        }
+    }
+}
+
+/// Starts one upstream request for the run of chunks from @c index that are
+/// neither cached nor already on their way, up to the read-ahead limit.
+- (BOOL)fetchChunksFromIndex:(NSUInteger)index ofResource:(StreamProxyResource *)resource
+{
+    if (!_session)
+        return NO;
+
+    NSUInteger chunkSize = _cache.chunkSize;
+    NSUInteger limit = index + 1 + self.readAheadChunks;
+    NSUInteger end = index;
+
+    if (resource.length >= 0)
+        limit = MIN(limit, [self chunkCountOfResource:resource]);
+
+    while (end < limit && !resource.waiters[@(end)] && ![_cache hasChunkAtIndex:end forKey:resource.key])
+    {
+        resource.waiters[@(end)] = [NSMutableArray array];
+        ++end;
+    }
+
+    if (end == index)
+        return YES;
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:resource.URL];
+    [request setValue:[NSString stringWithFormat:@"bytes=%lu-%lu", (unsigned long)(index * chunkSize), (unsigned long)(end * chunkSize - 1)]
+   forHTTPHeaderField:@"Range"];
+
+    StreamProxyFetch *fetch = [StreamProxyFetch new];
+    fetch.resource = resource;
+    fetch.nextChunk = index;
+    fetch.endChunk = end;
+    fetch.buffer = [NSMutableData dataWithCapacity:chunkSize];
+
+    NSURLSessionDataTask *task = [_session dataTaskWithRequest:request];
+    _fetches[@(task.taskIdentifier)] = fetch;
+    [task resume];
+
+    return YES;
+}
+
+- (NSUInteger)chunkCountOfResource:(StreamProxyResource *)resource
+{
+    NSUInteger chunkSize = _cache.chunkSize;
+
+    if (resource.length < 0)
+        return NSUIntegerMax;
+
+    return (NSUInteger)((resource.length + chunkSize - 1) / chunkSize);
+}
+
+- (void)finishChunk:(NSUInteger)index ofResource:(StreamProxyResource *)resource data:(NSData *)data error:(NSError *)error
+{
+    if (data)
+        [_cache storeChunk:data atIndex:index forKey:resource.key];
+
+    NSArray *waiters = resource.waiters[@(index)];
+    [resource.waiters removeObjectForKey:@(index)];
+
+    for (StreamChunkBlock waiter in waiters)
+        waiter(data, error);
+}
+
+/// Checks that upstream is sending the range that was asked for and learns
+/// the stream's length and type from it.
+- (BOOL)acceptResponse:(NSHTTPURLResponse *)response forFetch:(StreamProxyFetch *)fetch
+{
+    if (![response isKindOfClass:[NSHTTPURLResponse class]])
+        return NO;
+
+    StreamProxyResource *resource = fetch.resource;
+    unsigned long long first;
+    long long total;
+
+    switch (response.statusCode)
+    {
+        case 206:
+            if (!parseContentRange(headerValue(response, @"Content-Range"), &first, &total) ||
+                first != fetch.nextChunk * _cache.chunkSize)
+                return NO;
+            break;
+
+        case 200:
+            // Upstream ignored the range, which is only any use from the start
+            if (fetch.nextChunk != 0)
+                return NO;
+
+            total = response.expectedContentLength;
+            break;
+
+        case 416:
+            // Asked for chunks past the end, but it still says how long it is
+            if (parseContentRange(headerValue(response, @"Content-Range"), &first, &total) && total >= 0)
+                [self setLength:total ofResource:resource];
+
+            return NO;
+
+        default:
+            return NO;
+    }
+
+    if (!resource.contentType)
+        resource.contentType = response.MIMEType;
+
+    if (total >= 0)
+        [self setLength:total ofResource:resource];
+
+    return YES;
+}
+
+/// Remembers the length in the cache as well, so the stream's cached chunks
+/// can be served after a relaunch without going upstream.
+- (void)setLength:(long long)length ofResource:(StreamProxyResource *)resource
+{
+    if (resource.length == length)
+        return;
+
+    resource.length = length;
+    [_cache setLength:(unsigned long long)length contentType:resource.contentType forKey:resource.key];
+}
+
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+{
+    dispatch_async(_queue, ^{
+        StreamProxyFetch *fetch = _fetches[@(dataTask.taskIdentifier)];
+        BOOL accepted = fetch && [self acceptResponse:(NSHTTPURLResponse *)response forFetch:fetch];
+
+        completionHandler(accepted ? NSURLSessionResponseAllow : NSURLSessionResponseCancel);
+    });
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    dispatch_async(_queue, ^{
+        StreamProxyFetch *fetch = _fetches[@(dataTask.taskIdentifier)];
+
+        if (!fetch)
+            return;
+
+        NSUInteger chunkSize = _cache.chunkSize;
+        [fetch.buffer appendData:data];
+
+        while (fetch.buffer.length >= chunkSize && fetch.nextChunk < fetch.endChunk)
+        {
+            NSData *chunk = [fetch.buffer subdataWithRange:NSMakeRange(0, chunkSize)];
+            [fetch.buffer replaceBytesInRange:NSMakeRange(0, chunkSize) withBytes:NULL length:0];
+
+            [self finishChunk:fetch.nextChunk ofResource:fetch.resource data:chunk error:nil];
+            fetch.nextChunk += 1;
+        }
+
+        // Upstream sent more than was asked for
+        if (fetch.nextChunk == fetch.endChunk)
+            [dataTask cancel];
+    });
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+{
+    dispatch_async(_queue, ^{
+        StreamProxyFetch *fetch = _fetches[@(task.taskIdentifier)];
+
+        if (!fetch)
+            return;
+
+        [_fetches removeObjectForKey:@(task.taskIdentifier)];
+
+        StreamProxyResource *resource = fetch.resource;
+        NSUInteger start = fetch.nextChunk * _cache.chunkSize;
+
+        // Only the last chunk of the stream may be short
+        if (!error && fetch.buffer.length > 0 && fetch.nextChunk < fetch.endChunk &&
+            resource.length == (long long)(start + fetch.buffer.length))
+        {
+            [self finishChunk:fetch.nextChunk ofResource:resource data:[fetch.buffer copy] error:nil];
+            fetch.nextChunk += 1;
+        }
+
+        NSError *failure = error ?: [ConnectError generateErrorWithCode:ConnectStatusCodeError andDetails:@"Upstream ended before the chunk was fetched"];
+
+        for (NSUInteger index = fetch.nextChunk; index < fetch.endChunk; ++index)
+            [self finishChunk:index ofResource:resource data:nil error:failure];
+    });
+}
+
+@end
@@ -0,0 +1,64 @@
+//
+//  TimingWheel.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/// A hierarchical timing wheel that runs many timers off a single dispatch
+/// timer. Scheduling and cancelling are O(1), and each tick only touches the
+/// timers that are due, so the cost doesn't grow with the number of devices
+/// being watched.
+///
+/// Timers are identified by an owner and a name. Scheduling a timer replaces
+/// any timer the owner already has with that name. The owner is only used for
+/// identity and isn't retained.
+@interface TimingWheel : NSObject
+
+/// Length of one tick. Timers fire on the first tick at or after their delay.
+@property (nonatomic, readonly) NSTimeInterval tickInterval;
+
+/// Number of scheduled timers.
+@property (nonatomic, readonly) NSUInteger count;
+
+/// The wheel shared by discovery: device expiry, SSDP searches and
+/// reachability checks. It ticks once a second and fires on the main queue.
++ (instancetype)sharedWheel;
+
+/// Creates a wheel that fires timers on the given queue.
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval
+                               queue:(dispatch_queue_t)queue;
+
+/// Runs @c block once, @c delay seconds from now.
+- (void)scheduleTimerForOwner:(id)owner
+                         name:(NSString *)name
+                   afterDelay:(NSTimeInterval)delay
+                        block:(dispatch_block_t)block;
+
+/// Runs @c block every @c interval seconds, starting @c interval seconds from
+/// now, until it's cancelled.
+- (void)scheduleRepeatingTimerForOwner:(id)owner
+                                  name:(NSString *)name
+                              interval:(NSTimeInterval)interval
+                                 block:(dispatch_block_t)block;
+
+- (BOOL)hasTimerForOwner:(id)owner name:(NSString *)name;
+- (void)cancelTimerForOwner:(id)owner name:(NSString *)name;
+- (void)cancelAllTimersForOwner:(id)owner;
+
+@end
@@ -0,0 +1,389 @@
+//
+//  TimingWheel.m
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TimingWheel_Private.h"
+
+/// Each level has 64 slots, and each slot of a level spans a full turn of the
+/// level below. With a one second tick, four levels cover about 194 days.
+static const NSUInteger kSlotBits = 6;
+static const NSUInteger kSlotCount = 1 << kSlotBits;
+static const NSUInteger kSlotMask = kSlotCount - 1;
+static const NSUInteger kLevelCount = 4;
+
+@interface TimingWheelTimer : NSObject
+
+@property (nonatomic, strong) id key;
+@property (nonatomic) uint64_t deadline;
+@property (nonatomic) uint64_t repeatTicks;
+@property (nonatomic, copy) dispatch_block_t block;
+@property (nonatomic, weak) NSMutableSet *slot;
+
+@end
+
+@implementation TimingWheelTimer
+
+@end
+
+@implementation TimingWheel
+{
+    dispatch_queue_t _queue;
+    dispatch_source_t _source;
+    BOOL _sourceRunning;
+
+    /// _levels[level][slot] is a set of timers
+    NSArray *_levels;
+
+    /// Timers keyed by owner pointer, then by name
+    NSMutableDictionary *_timers;
+
+    NSTimeInterval _origin;
+    uint64_t _currentTick;
+}
+
++ (instancetype)sharedWheel
+{
+    static TimingWheel *sharedWheel;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedWheel = [[TimingWheel alloc] initWithTickInterval:1 queue:dispatch_get_main_queue()];
+    });
+
+    return sharedWheel;
+}
+
+- (instancetype)init
+{
+    return [self initWithTickInterval:1 queue:dispatch_get_main_queue()];
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval
+                               queue:(dispatch_queue_t)queue
+{
+    self = [super init];
+
+    if (self)
+    {
+        _tickInterval = tickInterval;
+        _queue = queue;
+        _timers = [NSMutableDictionary new];
+        _timeSource = ^{ return [[NSDate date] timeIntervalSince1970]; };
+        _origin = _timeSource();
+
+        NSMutableArray *levels = [NSMutableArray arrayWithCapacity:kLevelCount];
+        for (NSUInteger level = 0; level < kLevelCount; ++level)
+        {
+            NSMutableArray *slots = [NSMutableArray arrayWithCapacity:kSlotCount];
+            for (NSUInteger slot = 0; slot < kSlotCount; ++slot)
+                [slots addObject:[NSMutableSet set]];
+
+            [levels addObject:slots];
+        }
+        _levels = levels;
+
+        __weak typeof(self) weakSelf = self;
+        _source = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+        dispatch_source_set_timer(_source,
+                                  dispatch_time(DISPATCH_TIME_NOW, (int64_t)(tickInterval * NSEC_PER_SEC)),
+                                  (uint64_t)(tickInterval * NSEC_PER_SEC),
+                                  (uint64_t)(tickInterval * NSEC_PER_SEC / 10));
+        dispatch_source_set_event_handler(_source, ^{
+            [weakSelf fireExpiredTimers];
+        });
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    // A suspended source can't be released
+    if (!_sourceRunning)
+        dispatch_resume(_source);
+
+    dispatch_source_cancel(_source);
+}
+
+- (void)setTimeSource:(NSTimeInterval (^)(void))timeSource
+{
+    @synchronized (self)
+    {
+        _timeSource = [timeSource copy];
+        _origin = _timeSource() - _currentTick * _tickInterval;
+    }
+}
+
+#pragma mark - Scheduling
+
+- (void)scheduleTimerForOwner:(id)owner
+                         name:(NSString *)name
+                   afterDelay:(NSTimeInterval)delay
+                        block:(dispatch_block_t)block
+{
+    [self scheduleTimerForOwner:owner name:name delay:delay repeatInterval:0 block:block];
+}
+
+- (void)scheduleRepeatingTimerForOwner:(id)owner
+                                  name:(NSString *)name
+                              interval:(NSTimeInterval)interval
+                                 block:(dispatch_block_t)block
+{
+    [self scheduleTimerForOwner:owner name:name delay:interval repeatInterval:interval block:block];
+}
+
+- (void)scheduleTimerForOwner:(id)owner
+                         name:(NSString *)name
+                        delay:(NSTimeInterval)delay
+               repeatInterval:(NSTimeInterval)repeatInterval
+                        block:(dispatch_block_t)block
+{
+    if (!owner || !name || !block)
+        return;
+
+    TimingWheelTimer *timer = [TimingWheelTimer new];
+    timer.key = [self keyForOwner:owner];
+    timer.block = block;
+    timer.repeatTicks = (repeatInterval > 0) ? [self ticksForInterval:repeatInterval] : 0;
+
+    @synchronized (self)
+    {
+        // Nothing is due while the wheel is empty, so it can jump straight to now
+        uint64_t now = MAX(_currentTick, [self tickForNow]);
+        if (self.count == 0)
+            _currentTick = now;
+
+        NSMutableDictionary *ownerTimers = _timers[timer.key];
+        if (!ownerTimers)
+        {
+            ownerTimers = [NSMutableDictionary new];
+            _timers[timer.key] = ownerTimers;
+        }
+
+        [self removeTimer:ownerTimers[name]];
+
+        // The wheel may not have caught up with the clock yet, so the delay
+        // counts from now rather than from the last tick it ran
+        timer.deadline = now + [self ticksForInterval:delay];
+        ownerTimers[name] = timer;
+        [self placeTimer:timer];
+
+        [self updateSource];
+    }
+}
+
+- (BOOL)hasTimerForOwner:(id)owner name:(NSString *)name
+{
+    if (!owner || !name)
+        return NO;
+
+    @synchronized (self)
+    {
+        return _timers[[self keyForOwner:owner]][name] != nil;
+    }
+}
+
+- (void)cancelTimerForOwner:(id)owner name:(NSString *)name
+{
+    if (!owner || !name)
+        return;
+
+    @synchronized (self)
+    {
+        id key = [self keyForOwner:owner];
+        NSMutableDictionary *ownerTimers = _timers[key];
+
+        [self removeTimer:ownerTimers[name]];
+        [ownerTimers removeObjectForKey:name];
+
+        if (ownerTimers.count == 0)
+            [_timers removeObjectForKey:key];
+
+        [self updateSource];
+    }
+}
+
+- (void)cancelAllTimersForOwner:(id)owner
+{
+    if (!owner)
+        return;
+
+    @synchronized (self)
+    {
+        id key = [self keyForOwner:owner];
+
+        for (TimingWheelTimer *timer in [_timers[key] allValues])
+            [self removeTimer:timer];
+
+        [_timers removeObjectForKey:key];
+
+        [self updateSource];
+    }
+}
+
+- (NSUInteger)count
+{
+    @synchronized (self)
+    {
+        NSUInteger count = 0;
+
+        for (NSDictionary *ownerTimers in [_timers allValues])
+            count += ownerTimers.count;
+
+        return count;
+    }
+}
+
+#pragma mark - Ticking
+
+- (void)fireExpiredTimers
+{
+    NSMutableArray *expired = [NSMutableArray array];
+
+    @synchronized (self)
+    {
+        uint64_t target = [self tickForNow];
+
+        if (_timers.count == 0)
+            _currentTick = MAX(_currentTick, target);
+
+        while (_currentTick < target)
+        {
+            ++_currentTick;
+            [self cascade];
+
+            NSMutableSet *slot = _levels[0][_currentTick & kSlotMask];
+
+            for (TimingWheelTimer *timer in [slot allObjects])
+            {
+                if (timer.deadline > _currentTick)
+                    continue;
+
+                [slot removeObject:timer];
+                [expired addObject:timer];
+
+                if (timer.repeatTicks > 0)
+                {
+                    // Counted from now, so a wheel catching up after the app
+                    // was suspended fires each repeating timer only once
+                    timer.deadline = target + timer.repeatTicks;
+                    [self placeTimer:timer];
+                } else
+                {
+                    [self forgetTimer:timer];
+                }
+            }
+        }
+
+        [self updateSource];
+    }
+
+    // Blocks run outside the lock so they can schedule and cancel timers
+    for (TimingWheelTimer *timer in expired)
+        timer.block();
+}
+
+/// Moves the timers of every higher-level slot that has just come round down
+/// into the levels below.
+- (void)cascade
+{
+    for (NSUInteger level = 1; level < kLevelCount; ++level)
+    {
+        // The level below has only just wrapped if its bits are all zero
+        if ((_currentTick & ((1ull << (kSlotBits * level)) - 1)) != 0)
+            break;
+
+        NSMutableSet *slot = _levels[level][(_currentTick >> (kSlotBits * level)) & kSlotMask];
+        NSArray *timers = [slot allObjects];
+        [slot removeAllObjects];
+
+        for (TimingWheelTimer *timer in timers)
+            [self placeTimer:timer];
+    }
+}
+
+#pragma mark - Helpers
+
+- (void)placeTimer:(TimingWheelTimer *)timer
+{
+    // A timer due now goes into the current slot, which is about to be run
+    uint64_t deadline = MAX(timer.deadline, _currentTick);
+    uint64_t delta = deadline - _currentTick;
+    NSUInteger level = 0;
+
+    while (level < kLevelCount - 1 && delta >= (1ull << (kSlotBits * (level + 1))))
+        ++level;
+
+    // Anything beyond the top level waits in its last slot and is re-placed
+    // each time that slot comes round
+    if (delta >= (1ull << (kSlotBits * kLevelCount)))
+        deadline = _currentTick + (1ull << (kSlotBits * kLevelCount)) - 1;
+
+    NSMutableSet *slot = _levels[level][(deadline >> (kSlotBits * level)) & kSlotMask];
+    [slot addObject:timer];
+    timer.slot = slot;
+}
+
+- (void)removeTimer:(TimingWheelTimer *)timer
+{
+    [timer.slot removeObject:timer];
+    timer.slot = nil;
+}
+
+- (void)forgetTimer:(TimingWheelTimer *)timer
+{
+    NSMutableDictionary *ownerTimers = _timers[timer.key];
+    NSArray *names = [ownerTimers allKeysForObject:timer];
+
+    [ownerTimers removeObjectsForKeys:names];
+
+    if (ownerTimers.count == 0)
+        [_timers removeObjectForKey:timer.key];
+}
+
+/// The dispatch timer only runs while there is something to fire.
+- (void)updateSource
+{
+    BOOL shouldRun = _timers.count > 0;
+
+    if (shouldRun && !_sourceRunning)
+        dispatch_resume(_source);
+    else if (!shouldRun && _sourceRunning)
+        dispatch_suspend(_source);
+
+    _sourceRunning = shouldRun;
+}
+
+- (id)keyForOwner:(id)owner
+{
+    return [NSValue valueWithNonretainedObject:owner];
+}
+
+- (uint64_t)ticksForInterval:(NSTimeInterval)interval
+{
+    return MAX(1, (uint64_t)ceil(interval / _tickInterval));
+}
+
+- (uint64_t)tickForNow
+{
+    NSTimeInterval elapsed = _timeSource() - _origin;
+    return (elapsed > 0) ? (uint64_t)(elapsed / _tickInterval) : 0;
+}
+
+@end
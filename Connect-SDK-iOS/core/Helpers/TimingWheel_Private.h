@@ -0,0 +1,33 @@
+//
+//  TimingWheel_Private.h
+//  Connect SDK
+//
+//  Created by Stephen Radford on 2026-10-18.
+//  Copyright (c) 2026 LG Electronics. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#import "TimingWheel.h"
+
+@interface TimingWheel ()
+
+/// Returns the current time in seconds. Defaults to the wall clock; tests
+/// replace it to move time forward.
+@property (nonatomic, copy) NSTimeInterval (^timeSource)(void);
+
+/// Advances the wheel to the current time and runs every timer that has come
+/// due, on the calling thread.
+- (void)fireExpiredTimers;
+
+@end
@@ -23,6 +23,7 @@
 #import "CTXMLReader.h"
 #import "ConnectUtil.h"
 #import "DeviceServiceReachability.h"
+#import "DLNAContentFeatures.h"
 #import "DLNAHTTPServer.h"
 
 #import "NSDictionary+KeyPredicateSearch.h"
@@ -1333,10 +1334,7 @@ static const NSInteger kValueNotFound = -1;
                                                  toWriter:writer];
                 }
 
-                NSString *value = [NSString stringWithFormat:
-                    @"http-get:*:%@:DLNA.ORG_PN=MP3;DLNA.ORG_OP=01;DLNA.ORG_FLAGS=01500000000000000000000000000000",
-                    [mimeType orEmpty]];
-                [writer writeAttribute:@"protocolInfo" value:value];
+                [writer writeAttribute:@"protocolInfo" value:DLNAProtocolInfo(mimeType)];
                 [writer writeCharacters:mediaInfoURLString];
             }];
 
@@ -24,6 +24,7 @@
 #import "ExternalInputControl.h"
 #import "WebAppLauncher.h"
 #import "ConnectError.h"
+#import "CapabilitySet.h"
 
 @implementation DeviceService
 {
@@ -149,6 +150,7 @@ static BOOL _shouldDisconnectOnBackground = YES;
     NSArray *oldCapabilities = _capabilities;
 
     _capabilities = [NSMutableArray arrayWithArray:newCapabilities];
+    CapabilityGenerationIncrement();
 
     NSMutableArray *lostCapabilities = [NSMutableArray new];
 
@@ -179,6 +181,7 @@ static BOOL _shouldDisconnectOnBackground = YES;
         return;
 
     [_capabilities addObject:capability];
+    CapabilityGenerationIncrement();
 
     if (self.delegate && [self.delegate respondsToSelector:@selector(deviceService:capabilitiesAdded:removed:)])
         [self.delegate deviceService:self capabilitiesAdded:@[capability] removed:[NSArray array]];
@@ -197,6 +200,8 @@ static BOOL _shouldDisconnectOnBackground = YES;
         [_capabilities addObject:capability];
     }];
 
+    CapabilityGenerationIncrement();
+
     if (self.delegate && [self.delegate respondsToSelector:@selector(deviceService:capabilitiesAdded:removed:)])
         [self.delegate deviceService:self capabilitiesAdded:capabilities removed:[NSArray array]];
 }
@@ -214,6 +219,8 @@ static BOOL _shouldDisconnectOnBackground = YES;
         [_capabilities removeObject:capability];
     } while ([_capabilities containsObject:capability]);
 
+    CapabilityGenerationIncrement();
+
     if (self.delegate && [self.delegate respondsToSelector:@selector(deviceService:capabilitiesAdded:removed:)])
         [self.delegate deviceService:self capabilitiesAdded:[NSArray array] removed:@[capability]];
 }
@@ -234,6 +241,8 @@ static BOOL _shouldDisconnectOnBackground = YES;
         } while ([_capabilities containsObject:capability]);
     }];
 
+    CapabilityGenerationIncrement();
+
     if (self.delegate && [self.delegate respondsToSelector:@selector(deviceService:capabilitiesAdded:removed:)])
         [self.delegate deviceService:self capabilitiesAdded:[NSArray array] removed:capabilities];
 }
@@ -82,7 +82,8 @@ class AppDelegate: UIResponder, UIApplicationDelegate, PutioDelegate {
         print(Putio.keychain)
         
         if let token = Putio.accessToken {
-            // The user is logged in
+            // The user is logged in so pick up anything left in the download queue
+            Downloader.sharedInstance.schedule()
         } else {
             let sb: UIStoryboard = UIStoryboard(name: "FirstRun", bundle: nil)
             let vc: UIViewController = sb.instantiateInitialViewController()!
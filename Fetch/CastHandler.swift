@@ -45,6 +45,9 @@ class CastHandler: NSObject, DevicePickerDelegate, ConnectableDeviceDelegate, Di
     /// Are subtitles on?
     var subtitlesEnabled = false
     
+    /// Background time held while the TV is playing from the phone
+    private var proxyBackgroundTask = UIBackgroundTaskInvalid
+    
     
     override init() {
         super.init()
@@ -72,6 +75,8 @@ class CastHandler: NSObject, DevicePickerDelegate, ConnectableDeviceDelegate, Di
             CapabilityFilter(capabilities: [kMediaPlayerPlayVideo])
         ]
         
+        // Look for TVs we've used before straight away rather than waiting for multicast
+        discoveryManager?.fastStartEnabled = true
         discoveryManager?.startDiscovery()
         discoveryManager?.devicePicker().delegate = self
     }
@@ -127,6 +132,36 @@ class CastHandler: NSObject, DevicePickerDelegate, ConnectableDeviceDelegate, Di
         filePlaying = nil
         isPlaying = false
         subtitlesEnabled = false
+        
+        // End the session for any downloaded file the TV was given
+        StreamProxy.shared().revokeFileURLs()
+        endProxySession()
+    }
+    
+    
+    // MARK: - Proxy
+    
+    /// Keep the app running while the TV plays from the proxy on the phone. iOS only grants a few
+    /// minutes of background time, so a long film played through the proxy can still stop once the
+    /// phone has been locked for a while. That's why streams only go through the proxy when casting
+    /// starts in the foreground, and use put.io directly otherwise.
+    private func beginProxySession() {
+        guard proxyBackgroundTask == UIBackgroundTaskInvalid else {
+            return
+        }
+        
+        proxyBackgroundTask = UIApplication.shared.beginBackgroundTask { [weak self] in
+            self?.endProxySession()
+        }
+    }
+    
+    private func endProxySession() {
+        guard proxyBackgroundTask != UIBackgroundTaskInvalid else {
+            return
+        }
+        
+        UIApplication.shared.endBackgroundTask(proxyBackgroundTask)
+        proxyBackgroundTask = UIBackgroundTaskInvalid
     }
     
     
@@ -208,7 +243,19 @@ class CastHandler: NSObject, DevicePickerDelegate, ConnectableDeviceDelegate, Di
             URL = "\(Putio.api)files/\(file.id)/stream?oauth_token=\(Putio.accessToken!)"
         }
         
-        let info = MediaInfo(url: NSURL(string: URL)! as URL!, mimeType: "video/mp4")
+        var mediaURL = Foundation.URL(string: URL)!
+        
+        // Everything but Chromecast plays through the proxy on the phone, which reads ahead
+        // and serves seeks into what it has already fetched without going back to put.io.
+        // The proxy only runs while the app does, so casting from the background goes direct.
+        if device?.service(withName: "Chromecast") == nil && UIApplication.shared.applicationState == .active, let proxied = StreamProxy.shared().proxyURL(for: mediaURL) {
+            mediaURL = proxied
+            beginProxySession()
+        } else {
+            endProxySession()
+        }
+        
+        let info = MediaInfo(url: mediaURL, mimeType: "video/mp4")
         info?.title = file.name
         
         // Add subtitles if it's an MP4 and chromecast
@@ -255,6 +302,49 @@ class CastHandler: NSObject, DevicePickerDelegate, ConnectableDeviceDelegate, Di
         
     }
     
+    /// Send a downloaded file to the connected device. The TV plays it from the phone over the LAN,
+    /// using a URL that only works until casting stops.
+    func sendDownloadedFile(file: DownloadedFile, callback: () -> Void) {
+        
+        // A new cast starts a new session, so the last file's URL stops working
+        StreamProxy.shared().revokeFileURLs()
+        
+        launchObject = nil
+        filePlaying = nil
+        isPlaying = true
+        
+        guard let url = StreamProxy.shared().url(forFileAtPath: file.url.path) else {
+            print("Could not serve \(file.filename) on the local network")
+            isPlaying = false
+            return
+        }
+        
+        // There's nowhere else to play a downloaded file from
+        beginProxySession()
+        
+        callback()
+        
+        var mp: MediaPlayer = device!.mediaPlayer()
+        
+        // Same lookup the proxy uses for the file's Content-Type
+        let info = MediaInfo(url: url, mimeType: GCDWebServerGetMimeTypeForExtension(file.url.pathExtension))
+        info?.title = file.filename
+        
+        if device?.service(withName: "Chromecast") != nil {
+            let cs: CastService = device!.mediaPlayer() as! CastService
+            cs.castWebAppId = castID
+            mp = cs as MediaPlayer
+        }
+        
+        mp.playMedia(with: info, shouldLoop: false, success: { (media) -> Void in
+            self.launchObject = media
+            self.delegate?.launchObjectSuccess()
+        }) { (error) -> Void in
+            print(error)
+        }
+        
+    }
+    
     // MARK: - Remote
     
     /// Show the Cast Remote in a overlay
@@ -0,0 +1,135 @@
+//
+//  DownloadItem.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import PutioKit
+
+/// Which downloads are started first when a slot frees up
+enum DownloadPriority: Int {
+    case high = 0
+    case normal = 1
+    case low = 2
+}
+
+/// Where a download is up to
+enum DownloadState: Int {
+    case queued
+    case downloading
+    case paused
+    case failed
+}
+
+/// Bytes received and how quickly they're arriving
+struct DownloadThroughput {
+
+    /// Bytes received so far
+    var receivedBytes: Int64 = 0
+
+    /// Total size in bytes or -1 if it isn't known yet
+    var totalBytes: Int64 = -1
+
+    /// Smoothed transfer rate
+    var bytesPerSecond: Double = 0
+
+    /// Progress between 0 and 1
+    var fractionCompleted: Double {
+        return totalBytes > 0 ? Double(receivedBytes) / Double(totalBytes) : 0
+    }
+
+    /// Estimated time left or nil if there's no rate to go on
+    var timeRemaining: TimeInterval? {
+        guard totalBytes > 0 && bytesPerSecond > 0 else {
+            return nil
+        }
+        return Double(totalBytes - receivedBytes) / bytesPerSecond
+    }
+
+}
+
+/// A file in the download queue
+class DownloadItem {
+
+    /// The file being downloaded
+    let file: File
+
+    /// Which items are started first
+    var priority: DownloadPriority
+
+    /// Where the download is up to
+    var state: DownloadState = .queued
+
+    /// Per-item progress and rate
+    var throughput = DownloadThroughput()
+
+    /// The running download while the item is in a slot
+    var download: SegmentedDownload?
+
+    /// The last error if the item failed
+    var error: NSError?
+
+    init(file: File, priority: DownloadPriority = .normal) {
+        self.file = file
+        self.priority = priority
+    }
+
+
+    // MARK: - Persistence
+
+    /// The item as it's stored in the persisted queue. Files are stored in the same shape as the
+    /// put.io API so they're read back through `FileRecord`.
+    var dictionary: [String:Any] {
+        var raw: [String:Any] = [
+            "id": file.id,
+            "name": file.name ?? "",
+            "size": NSNumber(value: file.size),
+            "content_type": file.content_type ?? "",
+            "is_mp4_available": file.has_mp4,
+            "parent_id": file.parent_id
+        ]
+        raw["icon"] = file.icon
+        raw["screenshot"] = file.screenshot
+
+        var item: [String:Any] = [
+            "file": raw,
+            "priority": priority.rawValue,
+            "paused": state == .paused,
+            "failed": state == .failed
+        ]
+
+        if state == .failed, let error = error {
+            item["error"] = ["domain": error.domain, "code": error.code, "description": error.localizedDescription]
+        }
+
+        return item
+    }
+
+    /**
+     Restore an item from the persisted queue
+
+     - parameter dictionary: The item as it was saved
+
+     - returns: The item or nil if it couldn't be read
+     */
+    convenience init?(dictionary: [String:Any]) {
+        guard let raw = dictionary["file"] as? [String:Any], let record = FileRecord(raw) else {
+            return nil
+        }
+
+        self.init(file: File(record: record), priority: DownloadPriority(rawValue: dictionary["priority"] as? Int ?? 1) ?? .normal)
+
+        // Failed items stay failed until they're retried
+        if dictionary["failed"] as? Bool == true {
+            state = .failed
+            if let raw = dictionary["error"] as? [String:Any] {
+                error = NSError(domain: raw["domain"] as? String ?? NSURLErrorDomain, code: raw["code"] as? Int ?? NSURLErrorUnknown, userInfo: [NSLocalizedDescriptionKey: raw["description"] as? String ?? ""])
+            }
+        } else if dictionary["paused"] as? Bool == true {
+            state = .paused
+        }
+    }
+
+}
@@ -0,0 +1,314 @@
+//
+//  DownloadLibrary.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import PutioKit
+import AVFoundation
+
+/// A downloaded file in Documents
+struct DownloadedFile {
+
+    /// put.io file ID or 0 if it was found on disk before the library existed
+    let fileID: Int
+
+    /// Name of the file in Documents
+    let filename: String
+
+    /// Size on disk in bytes
+    var size: Int64
+
+    /// Running time in seconds or 0 until the asset has been read
+    var duration: TimeInterval
+
+    /// Where playback got to last time
+    var resumePoint: TimeInterval
+
+    /// CRC-32 of the file as lowercase hex, in the same format put.io uses. This is nil until it's been calculated.
+    var checksum: String?
+
+    /// Where the file is on disk
+    var url: URL {
+        return DownloadLibrary.documents.appendingPathComponent(filename)
+    }
+
+}
+
+/// A persisted index of everything in Documents. Entries are added when a download finishes
+/// and removed when a file is deleted, so listing downloads never touches the filesystem.
+class DownloadLibrary {
+
+    /// The shared library
+    static let sharedInstance = DownloadLibrary()
+
+    /// Where downloads end up
+    static var documents: URL {
+        return FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+    }
+
+    /// Where the index is saved
+    static var url: URL {
+        let support = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        return support.appendingPathComponent("DownloadLibrary.json")
+    }
+
+    /// Downloaded files sorted by name
+    private(set) var files: [DownloadedFile] = []
+
+    /// Index into `files` keyed by file name
+    private var positions: [String:Int] = [:]
+
+    /// Whether a save has already been scheduled
+    private var saveScheduled = false
+
+    /// Saves are written one at a time, so an older snapshot can't land after a newer one
+    private let saveQueue = DispatchQueue(label: "uk.co.wearecocoon.fetch.download-library", qos: .utility)
+
+    init() {
+        if let files = DownloadLibrary.load() {
+            self.files = files.filter { FileManager.default.fileExists(atPath: $0.url.path) }
+        } else {
+            files = DownloadLibrary.scanDocuments()
+        }
+
+        reindex()
+
+        if files.contains(where: { $0.checksum == nil }) || !FileManager.default.fileExists(atPath: DownloadLibrary.url.path) {
+            scheduleSave()
+        }
+
+        for file in files where file.duration == 0 {
+            loadDuration(of: file.filename)
+        }
+
+        for file in files where file.checksum == nil {
+            calculateChecksum(of: file.filename)
+        }
+    }
+
+    /// Number of downloaded files
+    var count: Int {
+        return files.count
+    }
+
+    subscript(index: Int) -> DownloadedFile {
+        return files[index]
+    }
+
+    /**
+     Find a downloaded file by name
+
+     - parameter filename: Name of the file in Documents
+
+     - returns: The file or nil if it isn't in the library
+     */
+    func file(named filename: String) -> DownloadedFile? {
+        return positions[filename].map { files[$0] }
+    }
+
+
+    // MARK: - Changes
+
+    /**
+     Add a file that has just finished downloading. The duration and checksum are filled in
+     once they've been read from disk.
+
+     - parameter file: The put.io file that was downloaded
+     - parameter url:  Where it was saved
+     */
+    func add(_ file: File, at url: URL) {
+        let filename = url.lastPathComponent
+        let size = ((try? FileManager.default.attributesOfItem(atPath: url.path))?[.size] as? NSNumber)?.int64Value ?? file.size
+
+        let entry = DownloadedFile(fileID: file.id, filename: filename, size: size, duration: 0, resumePoint: 0, checksum: nil)
+
+        if let index = positions[filename] {
+            files[index] = entry
+        } else {
+            let index = files.index { $0.filename.localizedStandardCompare(filename) == .orderedDescending } ?? files.endIndex
+            files.insert(entry, at: index)
+            reindex()
+        }
+
+        scheduleSave()
+        loadDuration(of: filename)
+        calculateChecksum(of: filename)
+    }
+
+    /**
+     Delete a file from disk and from the library
+
+     - parameter index: Position of the file in `files`
+     */
+    func remove(at index: Int) {
+        let file = files.remove(at: index)
+        reindex()
+        scheduleSave()
+
+        do {
+            try FileManager.default.removeItem(at: file.url)
+        } catch {
+            print("Could not delete file")
+        }
+    }
+
+    /**
+     Remember where playback got to
+
+     - parameter time:     Position in seconds
+     - parameter filename: Name of the file in Documents
+     */
+    func setResumePoint(_ time: TimeInterval, for filename: String) {
+        update(filename) { $0.resumePoint = time }
+    }
+
+    private func update(_ filename: String, _ change: (inout DownloadedFile) -> Void) {
+        guard let index = positions[filename] else {
+            return
+        }
+
+        change(&files[index])
+        scheduleSave()
+    }
+
+    private func reindex() {
+        positions = [:]
+        for (index, file) in files.enumerated() {
+            positions[file.filename] = index
+        }
+    }
+
+
+    // MARK: - Metadata
+
+    private func loadDuration(of filename: String) {
+        guard let file = file(named: filename) else {
+            return
+        }
+
+        let asset = AVURLAsset(url: file.url)
+        asset.loadValuesAsynchronously(forKeys: ["duration"]) {
+            let duration = CMTimeGetSeconds(asset.duration)
+            guard duration.isFinite else {
+                return
+            }
+
+            DispatchQueue.main.async {
+                self.update(filename) { $0.duration = duration }
+            }
+        }
+    }
+
+    private func calculateChecksum(of filename: String) {
+        guard let file = file(named: filename) else {
+            return
+        }
+
+        DispatchQueue.global(qos: .background).async {
+            guard let checksum = DownloadLibrary.checksum(of: file.url) else {
+                return
+            }
+
+            DispatchQueue.main.async {
+                self.update(filename) { $0.checksum = checksum }
+            }
+        }
+    }
+
+    /// CRC-32 of a file, read through a memory map a slice at a time
+    private class func checksum(of url: URL) -> String? {
+        guard let data = try? Data(contentsOf: url, options: .alwaysMapped) else {
+            return nil
+        }
+
+        let slice = 4 * 1024 * 1024
+        var crc = crc32(0, nil, 0)
+
+        data.withUnsafeBytes { (bytes: UnsafePointer<Bytef>) in
+            var offset = 0
+            while offset < data.count {
+                let length = min(slice, data.count - offset)
+                crc = crc32(crc, bytes + offset, uInt(length))
+                offset += length
+            }
+        }
+
+        return String(format: "%08lx", crc)
+    }
+
+
+    // MARK: - Persistence
+
+    private class func load() -> [DownloadedFile]? {
+        guard let data = try? Data(contentsOf: url), let object = try? JSONSerialization.jsonObject(with: data), let raw = object as? [[String:Any]] else {
+            return nil
+        }
+
+        return raw.flatMap { entry -> DownloadedFile? in
+            guard let filename = entry["filename"] as? String else {
+                return nil
+            }
+
+            return DownloadedFile(
+                fileID: entry["file_id"] as? Int ?? 0,
+                filename: filename,
+                size: (entry["size"] as? NSNumber)?.int64Value ?? 0,
+                duration: entry["duration"] as? Double ?? 0,
+                resumePoint: entry["resume_point"] as? Double ?? 0,
+                checksum: entry["checksum"] as? String
+            )
+        }
+    }
+
+    /// Build the library from whatever is in Documents. This only happens the first time the library is used.
+    private class func scanDocuments() -> [DownloadedFile] {
+        let urls = (try? FileManager.default.contentsOfDirectory(at: documents, includingPropertiesForKeys: [.fileSizeKey], options: [])) ?? []
+
+        return urls
+            .filter { $0.pathExtension == "mp4" }
+            .map { url in
+                let size = (try? url.resourceValues(forKeys: [.fileSizeKey]))?.fileSize ?? 0
+                return DownloadedFile(fileID: 0, filename: url.lastPathComponent, size: Int64(size), duration: 0, resumePoint: 0, checksum: nil)
+            }
+            .sorted { $0.filename.localizedStandardCompare($1.filename) == .orderedAscending }
+    }
+
+    /// Batch up writes so playback doesn't rewrite the file every few seconds
+    private func scheduleSave() {
+        guard !saveScheduled else {
+            return
+        }
+
+        saveScheduled = true
+
+        DispatchQueue.main.asyncAfter(deadline: .now() + 1) {
+            self.saveScheduled = false
+
+            let raw: [[String:Any]] = self.files.map { file in
+                var entry: [String:Any] = [
+                    "file_id": file.fileID,
+                    "filename": file.filename,
+                    "size": NSNumber(value: file.size),
+                    "duration": file.duration,
+                    "resume_point": file.resumePoint
+                ]
+                entry["checksum"] = file.checksum
+                return entry
+            }
+
+            self.saveQueue.async {
+                do {
+                    try FileManager.default.createDirectory(at: DownloadLibrary.url.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
+                    let data = try JSONSerialization.data(withJSONObject: raw)
+                    try data.write(to: DownloadLibrary.url, options: .atomic)
+                } catch {
+                    print("Could not save download library: \(error)")
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,80 @@
+//
+//  DownloadPlayerViewController.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import UIKit
+import AVFoundation
+import AVKit
+import CoreMedia
+
+class DownloadPlayerViewController: AVPlayerViewController {
+
+    // MARK: - Variables
+
+    /// The downloaded file being played
+    var file: DownloadedFile?
+
+    /// Token for the periodic observer that stores the resume point
+    var observer: Any?
+
+    /// Set once the player is at its starting position. Ticks before then would store 0 over the resume point.
+    var ready = false
+
+    var checked = false
+
+
+    // MARK: - Layout
+
+    override func viewDidAppear(_ animated: Bool) {
+        super.viewDidAppear(animated)
+
+        // Check the time at intervals
+        observer = player?.addPeriodicTimeObserver(forInterval: CMTime(seconds: 5, preferredTimescale: 1), queue: .main) { [weak self] _ in
+            self?.saveTime()
+        }
+
+        if !checked {
+            loadTime()
+            checked = true
+        }
+    }
+
+    override func viewWillDisappear(_ animated: Bool) {
+        super.viewWillDisappear(animated)
+        saveTime()
+
+        if let observer = observer {
+            player?.removeTimeObserver(observer)
+        }
+        observer = nil
+    }
+
+
+    // MARK: - Continue Playing
+
+    /// Pick up where we left off unless it was watched to the end
+    func loadTime() {
+        guard let file = file, let player = player else { return }
+
+        if file.resumePoint > 0 && (file.duration == 0 || file.resumePoint < file.duration - 10) {
+            player.seek(to: CMTime(seconds: file.resumePoint, preferredTimescale: 1)) { [weak self] _ in
+                self?.ready = true
+                player.play()
+            }
+        } else {
+            ready = true
+            player.play()
+        }
+    }
+
+    /// Store the current position in the download library
+    func saveTime() {
+        guard ready, let file = file, let time = player?.currentTime() else { return }
+        DownloadLibrary.sharedInstance.setResumePoint(CMTimeGetSeconds(time), for: file.filename)
+    }
+
+}
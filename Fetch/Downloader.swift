@@ -11,11 +11,15 @@ import Alamofire
 
 protocol DownloaderDelegate {
     
-    func percentageChanged(percentage: String)
+    /// Called roughly once a second while anything is downloading
+    func progressChanged(item: DownloadItem, aggregate: DownloadThroughput)
     
-    func downloadCompleted()
+    func downloadCompleted(item: DownloadItem)
     
-    func downloadError(error: NSError)
+    func downloadError(item: DownloadItem, error: NSError)
+    
+    /// Items were added, removed, paused or reprioritised
+    func queueChanged()
     
 }
 
@@ -23,93 +27,337 @@ class Downloader {
     
     static let sharedInstance = Downloader()
     
-    var isDownloading = false
+    /// Number of files downloaded at the same time
+    var maxConcurrentDownloads = 2
+    
+    /// Optional cap on the combined transfer rate in bytes per second. This only applies while
+    /// the app is running; the system downloads at full speed while we're suspended.
+    var bandwidthLimit: Int64? {
+        didSet {
+            allowance = Double(bandwidthLimit ?? 0)
+        }
+    }
+    
+    /// Combined progress and rate of everything in the queue
+    private(set) var aggregate = DownloadThroughput()
 
     var delegate: DownloaderDelegate?
 
     lazy var manager: SessionManager = {
         let configuration = URLSessionConfiguration.background(withIdentifier: "uk.co.wearecocoon.background")
-        return Alamofire.SessionManager(configuration: configuration)
+        let manager = Alamofire.SessionManager(configuration: configuration)
+        
+        // Chunks left running by a previous launch have nothing to hand their data to. They'll be
+        // fetched again from the manifest so cancel them rather than download them twice.
+        manager.session.getTasksWithCompletionHandler { _, _, downloads in
+            for task in downloads where manager.delegate[task] == nil {
+                task.cancel()
+            }
+        }
+        
+        return manager
     }()
     
-    let destination = DownloadRequest.suggestedDownloadDestination(for: .documentDirectory)
+    /// Files waiting, downloading, paused or failed in the order they were added
+    private(set) var queue = [DownloadItem]()
     
-    var queue = [File]() {
-        didSet {
-            setTabBarIcon()
-            downloadNext()
-        }
+    /// Where the queue is saved so it survives a relaunch
+    static var queueURL: URL {
+        let support = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        return support.appendingPathComponent("DownloadQueue.json")
     }
-//
-//    /// This is the current download request. We store this so we can cancel it if required.
-    var currentRequest: Request?
-//
-//    /// MP4s that are in the documents folder.
-    var downloadedFiles: [String] {
-        do {
-            let documentsUrl = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first!
-            let directoryUrls = try FileManager.default.contentsOfDirectory(at: documentsUrl, includingPropertiesForKeys: nil, options: [])
-            return directoryUrls.filter { $0.pathExtension == "mp4" }.map { $0.lastPathComponent }
-        } catch {
-            return []
+    
+    /// Samples throughput and enforces the bandwidth cap while anything is downloading
+    private var timer: DispatchSourceTimer?
+    
+    /// How often throughput is sampled
+    private let sampleInterval: TimeInterval = 0.5
+    
+    /// Bytes per item at the last sample
+    private var lastSample: [Int:Int64] = [:]
+    
+    /// Bytes we can still receive before going over the bandwidth cap
+    private var allowance: Double = 0
+    
+    /// Downloads are suspended until this date to stay under the bandwidth cap
+    private var throttledUntil = Date.distantPast
+    
+    init() {
+        loadQueue()
+    }
+
+    // MARK: - Queue
+
+    /**
+     Add a file to the queue unless it's already there
+
+     - parameter file:     The file to download
+     - parameter priority: Which files are started first
+     */
+    func enqueue(_ file: File, priority: DownloadPriority = .normal) {
+        guard !queue.contains(where: { $0.file.id == file.id }) else {
+            return
         }
+        
+        queue.append(DownloadItem(file: file, priority: priority))
+        queueChanged()
     }
+    
+    /**
+     Take an item out of the queue and throw away anything downloaded so far
 
-    // MARK: - Methods
+     - parameter item: The item to remove
+     */
+    func remove(_ item: DownloadItem) {
+        guard let index = queue.index(where: { $0 === item }) else {
+            return
+        }
+        
+        if let download = item.download {
+            download.cancel()
+        } else {
+            SegmentedDownload.discard(item.file)
+        }
+        
+        item.download = nil
+        queue.remove(at: index)
+        queueChanged()
+    }
+    
+    /**
+     Stop downloading an item but keep its place and what's been downloaded so far
 
+     - parameter item: The item to pause
+     */
+    func pause(_ item: DownloadItem) {
+        item.download?.stop()
+        item.download = nil
+        item.state = .paused
+        queueChanged()
+    }
+    
     /**
-     Download the next file in the queue
+     Put a paused or failed item back in line
+
+     - parameter item: The item to resume
      */
-    func downloadNext() {
-        guard !isDownloading else {
+    func resume(_ item: DownloadItem) {
+        guard item.state == .paused || item.state == .failed else {
             return
         }
+        
+        item.state = .queued
+        item.error = nil
+        queueChanged()
+    }
+    
+    /**
+     Change which items are started first. This doesn't interrupt anything already downloading.
+
+     - parameter item:     The item to change
+     - parameter priority: The new priority
+     */
+    func setPriority(_ priority: DownloadPriority, for item: DownloadItem) {
+        item.priority = priority
+        queueChanged()
+    }
+    
+    /// Persist the queue, refill the slots and let everyone know
+    private func queueChanged() {
+        saveQueue()
+        schedule()
+        setTabBarIcon()
+        delegate?.queueChanged()
+    }
 
-        if let file = queue.first {
+    // MARK: - Scheduling
 
-            let endpoint = (file.has_mp4) ? "mp4/download" : "download"
-            isDownloading = true
-            UIApplication.shared.isNetworkActivityIndicatorVisible = true
+    /**
+     Start queued items until every slot is full. Higher priorities go first and items of the same
+     priority go in the order they were added.
+     */
+    func schedule() {
+        guard Putio.accessToken != nil else {
+            return
+        }
+        
+        let active = queue.filter { $0.state == .downloading }.count
+        let waiting = queue.enumerated()
+            .filter { $0.element.state == .queued }
+            .sorted { ($0.element.priority.rawValue, $0.offset) < ($1.element.priority.rawValue, $1.offset) }
+        
+        for (_, item) in waiting.prefix(max(maxConcurrentDownloads - active, 0)) {
+            start(item)
+        }
+        
+        let isDownloading = queue.contains { $0.state == .downloading }
+        UIApplication.shared.isNetworkActivityIndicatorVisible = isDownloading
+        
+        if isDownloading {
+            startTimer()
+        } else {
+            stopTimer()
+        }
+    }
+    
+    private func start(_ item: DownloadItem) {
+        let download = SegmentedDownload(file: item.file, manager: manager)
+        
+        download.completion = { [unowned self] download, error in
+            guard item.download === download else {
+                return
+            }
             
-            currentRequest = manager.download("\(Putio.api)/files/\(file.id)/\(endpoint)?oauth_token=\(Putio.accessToken!)", to: destination)
+            item.download = nil
+            self.lastSample[item.file.id] = nil
             
-                .downloadProgress { progress in
-                    
-                    DispatchQueue.main.async {
-                        UIApplication.shared.isNetworkActivityIndicatorVisible = true
-                        let formatter = NumberFormatter()
-                        formatter.numberStyle = .percent
-                        let percentage = formatter.string(from: NSNumber(value: progress.fractionCompleted))
-                        self.delegate?.percentageChanged(percentage: percentage!)
-                    }
-                    
-                }
+            if let e = error {
+                item.state = .failed
+                item.error = e
+                self.delegate?.downloadError(item: item, error: e)
+            } else if let index = self.queue.index(where: { $0 === item }) {
+                DownloadLibrary.sharedInstance.add(item.file, at: download.destination)
+                self.queue.remove(at: index)
+                self.delegate?.downloadCompleted(item: item)
+                self.sendNotification()
+            }
             
-                .responseData { (response) in
-                    UIApplication.shared.isNetworkActivityIndicatorVisible = false
-                    if(self.queue.count > 0) { self.queue.removeFirst() }
-                    
-                    self.isDownloading = false
-                    self.downloadNext()
-                    self.sendNotification()
-                    
-                    if let e = response.error {
-                        self.delegate?.downloadError(error: e as NSError)
-                    } else {
-                        self.delegate?.downloadCompleted()
-                    }
-                }
+            self.queueChanged()
+        }
+        
+        item.state = .downloading
+        item.download = download
+        item.throughput = DownloadThroughput()
+        
+        if Date() < throttledUntil {
+            download.suspend()
+        }
+        
+        download.start()
+    }
+
+    // MARK: - Throughput
+
+    private func startTimer() {
+        guard timer == nil else {
+            return
+        }
+        
+        let timer = DispatchSource.makeTimerSource(queue: .main)
+        timer.scheduleRepeating(deadline: .now() + sampleInterval, interval: sampleInterval)
+        timer.setEventHandler { [unowned self] in
+            self.sample()
+        }
+        timer.resume()
+        
+        self.timer = timer
+        allowance = Double(bandwidthLimit ?? 0)
+    }
+    
+    private func stopTimer() {
+        timer?.cancel()
+        timer = nil
+        lastSample = [:]
+        aggregate.bytesPerSecond = 0
+    }
+    
+    /// Update the rates of everything that's downloading and throttle if we're over the cap
+    private func sample() {
+        var received: Int64 = 0
+        var total: Int64 = 0
+        var rate: Double = 0
+        var delta: Int64 = 0
+        
+        for item in queue {
+            if let download = item.download {
+                let previous = lastSample[item.file.id] ?? download.receivedBytes
+                let instant = Double(download.receivedBytes - previous) / sampleInterval
+                
+                item.throughput.receivedBytes = download.receivedBytes
+                item.throughput.totalBytes = download.totalBytes
+                item.throughput.bytesPerSecond = item.throughput.bytesPerSecond * 0.7 + instant * 0.3
+                
+                lastSample[item.file.id] = download.receivedBytes
+                delta += download.receivedBytes - previous
+                rate += item.throughput.bytesPerSecond
+            }
             
+            received += item.throughput.receivedBytes
+            total += max(item.throughput.totalBytes, 0)
+        }
+        
+        aggregate = DownloadThroughput(receivedBytes: received, totalBytes: total, bytesPerSecond: rate)
+        
+        throttle(received: delta)
+        
+        for item in queue where item.state == .downloading {
+            delegate?.progressChanged(item: item, aggregate: aggregate)
+        }
+    }
+    
+    /**
+     Keep the combined rate under `bandwidthLimit`. The allowance refills at the limit and anything
+     received comes out of it. Once it's spent every download is suspended until it's back in credit.
 
+     - parameter bytes: Bytes received since the last sample
+     */
+    private func throttle(received bytes: Int64) {
+        guard let limit = bandwidthLimit, limit > 0 else {
+            return
+        }
+        
+        allowance = min(allowance + Double(limit) * sampleInterval, Double(limit)) - Double(bytes)
+        
+        let downloads = queue.flatMap { $0.download }
+        
+        guard allowance < 0 else {
+            downloads.forEach { $0.resume() }
+            return
         }
+        
+        // Stay suspended until the allowance has refilled enough to cover the overshoot
+        let wait = -allowance / Double(limit)
+        throttledUntil = Date().addingTimeInterval(wait)
+        downloads.forEach { $0.suspend() }
+        
+        DispatchQueue.main.asyncAfter(deadline: .now() + wait) {
+            guard Date() >= self.throttledUntil else {
+                return
+            }
+            self.queue.flatMap { $0.download }.forEach { $0.resume() }
+        }
+    }
 
+    // MARK: - Persistence
+    
+    private func saveQueue() {
+        let raw = queue.map { $0.dictionary }
+        
+        do {
+            try FileManager.default.createDirectory(at: Downloader.queueURL.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
+            let data = try JSONSerialization.data(withJSONObject: raw)
+            try data.write(to: Downloader.queueURL, options: .atomic)
+        } catch {
+            print("Could not save download queue: \(error)")
+        }
     }
+    
+    private func loadQueue() {
+        guard let data = try? Data(contentsOf: Downloader.queueURL), let object = try? JSONSerialization.jsonObject(with: data), let raw = object as? [[String:Any]] else {
+            return
+        }
+        
+        queue = raw.flatMap { DownloadItem(dictionary: $0) }
+    }
+
+    // MARK: - Methods
 
     /**
      Send a notification when the files finish downloading
      */
     func sendNotification() {
-        if self.queue.isEmpty && UIApplication.shared.applicationState == .background {
+        let isFinished = !queue.contains { $0.state == .queued || $0.state == .downloading }
+        if isFinished && UIApplication.shared.applicationState == .background {
             let notification = UILocalNotification()
             notification.alertBody = "Your files have finished downloading."
             notification.alertAction = "open"
@@ -118,22 +366,6 @@ class Downloader {
         }
     }
 
-    /**
-     Delete the file at the index referenced
-
-     - parameter index: The index of the file to remove
-     */
-    func deleteFileAtIndex(index: Int) {
-        let file = downloadedFiles[index]
-        let fm = FileManager.default
-        let documentsUrl = fm.urls(for: .documentDirectory, in: .userDomainMask).first!
-        do {
-            try fm.removeItem(at: try documentsUrl.asURL().appendingPathComponent(file))
-        } catch {
-            print("Could not delete file")
-        }
-    }
-
     /**
      Set the badge icon to be the same value as the queue amount
      */
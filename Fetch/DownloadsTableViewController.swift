@@ -12,7 +12,8 @@ import AVFoundation
 
 class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
 
-    var percentage = "0%"
+    /// Formats transfer rates
+    let byteFormatter = ByteCountFormatter()
     
     var noResultsView: NoResultsView!
     
@@ -26,7 +27,7 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
     }
     
     func showNoResultsIfRequired() {
-        if Downloader.sharedInstance.queue.count > 0 || Downloader.sharedInstance.downloadedFiles.count > 0 {
+        if Downloader.sharedInstance.queue.count > 0 || DownloadLibrary.sharedInstance.count > 0 {
             noResultsView.isHidden = true
         } else {
             noResultsView.isHidden = false
@@ -35,21 +36,32 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
 
     // MARK: - DownloaderDelegate
     
-    func percentageChanged(percentage: String) {
-        self.percentage = percentage
-        if !tableView.isEditing {
-            tableView.reloadData()
-            showNoResultsIfRequired()
+    func progressChanged(item: DownloadItem, aggregate: DownloadThroughput) {
+        guard !tableView.isEditing, let row = Downloader.sharedInstance.queue.index(where: { $0 === item }) else {
+            return
+        }
+        
+        if let cell = tableView.cellForRow(at: IndexPath(row: row, section: 0)) {
+            cell.detailTextLabel?.text = status(for: item)
         }
+        
+        let header = tableView.headerView(forSection: 0)
+        header?.textLabel?.text = (aggregate.bytesPerSecond > 0) ? "Download Queue · \(byteFormatter.string(fromByteCount: Int64(aggregate.bytesPerSecond)))/s" : "Download Queue"
     }
     
-    func downloadCompleted() {
-        percentage = "0%"
+    func downloadCompleted(item: DownloadItem) {
         tableView.reloadData()
         showNoResultsIfRequired()
     }
     
-    func downloadError(error: NSError) {
+    func queueChanged() {
+        if !tableView.isEditing {
+            tableView.reloadData()
+            showNoResultsIfRequired()
+        }
+    }
+    
+    func downloadError(item: DownloadItem, error: NSError) {
         if error.code != -999 {
             let alert = FetchAlertController(title: "Could Not Download", message: "The download could not be completed. Do you have an internet connection or enough storage?", preferredStyle: .alert)
             alert.addAction(UIAlertAction(title: "OK", style: .default, handler: nil))
@@ -71,14 +83,14 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
         if section == 0 {
             return Downloader.sharedInstance.queue.count
         }
-        return Downloader.sharedInstance.downloadedFiles.count
+        return DownloadLibrary.sharedInstance.count
     }
     
     override func tableView(_ tableView: UITableView, titleForHeaderInSection section: Int) -> String? {
         if section == 0 {
             return (Downloader.sharedInstance.queue.count > 0) ? "Download Queue" : ""
         }
-        return (Downloader.sharedInstance.downloadedFiles.count > 0) ? "Files" : ""
+        return (DownloadLibrary.sharedInstance.count > 0) ? "Files" : ""
     }
     
     override func tableView(_ tableView: UITableView, heightForHeaderInSection section: Int) -> CGFloat {
@@ -94,46 +106,78 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
         let cell = tableView.dequeueReusableCell(withIdentifier: identifier)!
         
         if indexPath.section == 0 {
-            cell.textLabel?.text = Downloader.sharedInstance.queue[indexPath.row].name
-            cell.detailTextLabel?.text = (indexPath.row == 0) ? "Downloading… \(percentage)" : "Queued"
+            let item = Downloader.sharedInstance.queue[indexPath.row]
+            cell.textLabel?.text = item.file.name
+            cell.detailTextLabel?.text = status(for: item)
         } else {
-            cell.textLabel?.text = Downloader.sharedInstance.downloadedFiles[indexPath.row]
+            cell.textLabel?.text = DownloadLibrary.sharedInstance[indexPath.row].filename
         }
         return cell
     }
     
+    /// Subtitle for an item in the queue
+    func status(for item: DownloadItem) -> String {
+        switch item.state {
+        case .queued:
+            return (item.priority == .high) ? "Up Next" : "Queued"
+        case .paused:
+            return "Paused"
+        case .failed:
+            return "Failed"
+        case .downloading:
+            let formatter = NumberFormatter()
+            formatter.numberStyle = .percent
+            let percentage = formatter.string(from: NSNumber(value: item.throughput.fractionCompleted)) ?? "0%"
+            guard item.throughput.bytesPerSecond > 0 else {
+                return "Downloading… \(percentage)"
+            }
+            return "Downloading… \(percentage) · \(byteFormatter.string(fromByteCount: Int64(item.throughput.bytesPerSecond)))/s"
+        }
+    }
+    
     
     
     // MARK: - Delete Files
     
     override func tableView(_ tableView: UITableView, editActionsForRowAt indexPath: IndexPath) -> [UITableViewRowAction]? {
         if indexPath.section == 0 {
-            if indexPath.row == 0 {
-                return [
-                    UITableViewRowAction(style: .destructive, title: "Cancel") { action, indexPath in
-                        Downloader.sharedInstance.currentRequest?.cancel()
-                        if(Downloader.sharedInstance.queue.count > 0) { Downloader.sharedInstance.queue.removeFirst() }
-                        self.tableView.beginUpdates()
-                        self.tableView.deleteRows(at: [indexPath], with: .automatic)
-                        self.tableView.endUpdates()
-                        self.showNoResultsIfRequired()
-                    }
-                ]
-            } else {
-                return [
-                    UITableViewRowAction(style: .destructive, title: "Remove") { action, indexPath in
-                        Downloader.sharedInstance.queue.remove(at: indexPath.row)
-                        self.tableView.beginUpdates()
-                        self.tableView.deleteRows(at: [indexPath], with: .automatic)
-                        self.tableView.endUpdates()
-                        self.showNoResultsIfRequired()
-                    }
-                ]
+            let item = Downloader.sharedInstance.queue[indexPath.row]
+            
+            var actions = [
+                UITableViewRowAction(style: .destructive, title: (item.state == .downloading) ? "Cancel" : "Remove") { action, indexPath in
+                    Downloader.sharedInstance.remove(item)
+                    self.tableView.beginUpdates()
+                    self.tableView.deleteRows(at: [indexPath], with: .automatic)
+                    self.tableView.endUpdates()
+                    self.showNoResultsIfRequired()
+                }
+            ]
+            
+            switch item.state {
+            case .downloading, .queued:
+                actions.append(UITableViewRowAction(style: .normal, title: "Pause") { action, indexPath in
+                    self.tableView.setEditing(false, animated: true)
+                    Downloader.sharedInstance.pause(item)
+                })
+            case .paused, .failed:
+                actions.append(UITableViewRowAction(style: .normal, title: (item.state == .failed) ? "Retry" : "Resume") { action, indexPath in
+                    self.tableView.setEditing(false, animated: true)
+                    Downloader.sharedInstance.resume(item)
+                })
+            }
+            
+            if item.state != .downloading && item.priority != .high {
+                actions.append(UITableViewRowAction(style: .normal, title: "Next") { action, indexPath in
+                    self.tableView.setEditing(false, animated: true)
+                    Downloader.sharedInstance.setPriority(.high, for: item)
+                })
             }
+            
+            return actions
         } else {
             return [
                 UITableViewRowAction(style: .destructive, title: "Delete") { action, indexPath in
-                    Downloader.sharedInstance.deleteFileAtIndex(index: indexPath.row)
+                    DownloadLibrary.sharedInstance.remove(at: indexPath.row)
                     self.tableView.beginUpdates()
                     self.tableView.deleteRows(at: [indexPath], with: .automatic)
                     self.tableView.endUpdates()
@@ -141,10 +185,7 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
                 },
 
                 UITableViewRowAction(style: .normal, title: "Share") { [unowned self] action, indexPath in
-                    let path = Downloader.sharedInstance.downloadedFiles[indexPath.row]
-                    
-                    let documentsUrl = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first!
-                    let URL = try! documentsUrl.asURL().appendingPathComponent(path)
+                    let URL = DownloadLibrary.sharedInstance[indexPath.row].url
                     let viewController = UIActivityViewController(activityItems: [URL], applicationActivities: nil)
                     let frame = self.tableView.rectForRow(at: indexPath)
                     viewController.popoverPresentationController?.sourceView = self.tableView
@@ -162,23 +203,27 @@ class DownloadsTableViewController: UITableViewController, DownloaderDelegate {
         if indexPath.section == 0 {
             tableView.deselectRow(at: indexPath, animated: false)
         } else {
-            if Downloader.sharedInstance.downloadedFiles.count > indexPath.row {
-                performSegue(withIdentifier: "showPlayer", sender: Downloader.sharedInstance.downloadedFiles[indexPath.row])
+            guard DownloadLibrary.sharedInstance.count > indexPath.row else {
+                return
+            }
+            
+            let file = DownloadLibrary.sharedInstance[indexPath.row]
+            
+            // Play it on the TV straight from the phone if we're connected to one
+            if CastHandler.sharedInstance.device != nil {
+                tableView.deselectRow(at: indexPath, animated: true)
+                CastHandler.sharedInstance.sendDownloadedFile(file: file) {}
+            } else {
+                performSegue(withIdentifier: "showPlayer", sender: file.filename)
             }
         }
     }
     
     override func prepare(for segue: UIStoryboardSegue, sender: Any?) {
-        if let vc = segue.destination as? AVPlayerViewController, let file = sender as? String {
+        if let vc = segue.destination as? DownloadPlayerViewController, let filename = sender as? String, let file = DownloadLibrary.sharedInstance.file(named: filename) {
             vc.delegate = PlayerDelegate.sharedInstance
-
-            let documentsUrl = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask).first!
-            let fileUrl = try! documentsUrl.asURL().appendingPathComponent(file)
-            
-            let player = AVPlayer(url: fileUrl)
-            vc.player = player
-            vc.player?.play()
-            
+            vc.file = file
+            vc.player = AVPlayer(url: file.url)
         }
     }
 
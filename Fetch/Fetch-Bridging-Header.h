@@ -20,5 +20,8 @@
 #import <ConnectSDK/WebOSTVService.h>
 #import <ConnectSDK/FireTVService.h>
 #import <ConnectSDK/FireTVDiscoveryProvider.h>
+#import <ConnectSDK/StreamProxy.h>
+#import <ConnectSDK/GCDWebServerFunctions.h>
+#include <zlib.h>
 
 #endif /* Fetch_Bridging_Header_h */
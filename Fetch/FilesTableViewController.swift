@@ -201,9 +201,7 @@ class FilesTableViewController: UITableViewController, AVPlayerViewControllerDel
      - parameter file: The file to add to the queue
      */
     func addFileToQueue(file: File) {
-        if !Downloader.sharedInstance.queue.contains(where: { $0 == file }) {
-            Downloader.sharedInstance.queue.append(file)
-        }
+        Downloader.sharedInstance.enqueue(file)
         tableView.setEditing(false, animated: true)
     }
     
@@ -0,0 +1,585 @@
+//
+//  SegmentedDownload.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import PutioKit
+import Alamofire
+
+/// A byte range of a download
+struct DownloadChunk {
+
+    /// First byte of the range
+    let start: Int64
+
+    /// Last byte of the range, inclusive. This is -1 when the server doesn't support ranges.
+    let end: Int64
+
+    /// Whether the range has been written to the partial file
+    var isComplete: Bool
+
+    /// Number of bytes in the range
+    var length: Int64 {
+        return end - start + 1
+    }
+
+}
+
+/// What has been downloaded so far for a file. This is saved next to the partial file so that a
+/// download can pick up from the last finished chunk after the app is killed or the network drops.
+struct DownloadManifest {
+
+    /// Identifies the file and the variant being downloaded
+    let key: String
+
+    /// Total size in bytes or -1 if the server can't tell us or doesn't accept ranges
+    let length: Int64
+
+    /// ETag or Last-Modified of the file when the download started
+    let validator: String?
+
+    /// Every chunk in order
+    var chunks: [DownloadChunk]
+
+    /// Where partial downloads are kept. This is excluded from backups and never purged by the system.
+    static var directory: URL {
+        var url = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0].appendingPathComponent("Downloads", isDirectory: true)
+        if !FileManager.default.fileExists(atPath: url.path) {
+            try? FileManager.default.createDirectory(at: url, withIntermediateDirectories: true, attributes: nil)
+            var values = URLResourceValues()
+            values.isExcludedFromBackup = true
+            try? url.setResourceValues(values)
+        }
+        return url
+    }
+
+    /// Where the manifest is saved
+    var url: URL {
+        return DownloadManifest.directory.appendingPathComponent("\(key).json")
+    }
+
+    /// The partial file that chunks are written into
+    var partURL: URL {
+        return DownloadManifest.directory.appendingPathComponent("\(key).part")
+    }
+
+    /// Where a chunk is downloaded to before it's written into the partial file
+    func url(forChunk index: Int) -> URL {
+        return DownloadManifest.directory.appendingPathComponent("\(key).\(index).chunk")
+    }
+
+    /// Whether the server accepted ranges so the file could be split up
+    var isSegmented: Bool {
+        return length >= 0
+    }
+
+    /// Bytes that have been written to the partial file
+    var received: Int64 {
+        return chunks.reduce(0) { $0 + ($1.isComplete && isSegmented ? $1.length : 0) }
+    }
+
+    init(key: String, length: Int64, validator: String?, chunkSize: Int64) {
+        self.key = key
+        self.length = length
+        self.validator = validator
+
+        guard length > 0 else {
+            chunks = [DownloadChunk(start: 0, end: -1, isComplete: false)]
+            return
+        }
+
+        chunks = stride(from: 0, to: length, by: chunkSize).map { start in
+            DownloadChunk(start: start, end: min(start + chunkSize, length) - 1, isComplete: false)
+        }
+    }
+
+    private init(key: String, length: Int64, validator: String?, chunks: [DownloadChunk]) {
+        self.key = key
+        self.length = length
+        self.validator = validator
+        self.chunks = chunks
+    }
+
+
+    // MARK: - Persistence
+
+    /**
+     Load the manifest for a previous attempt at a download
+
+     - parameter key: The key the download was saved under
+
+     - returns: The manifest or nil if the file hasn't been started
+     */
+    static func load(key: String) -> DownloadManifest? {
+        let url = DownloadManifest.directory.appendingPathComponent("\(key).json")
+
+        guard let data = try? Data(contentsOf: url), let object = try? JSONSerialization.jsonObject(with: data), let raw = object as? [String:Any] else {
+            return nil
+        }
+
+        guard let length = (raw["length"] as? NSNumber)?.int64Value, let ranges = raw["chunks"] as? [[NSNumber]] else {
+            return nil
+        }
+
+        let chunks = ranges.filter { $0.count == 3 }.map { DownloadChunk(start: $0[0].int64Value, end: $0[1].int64Value, isComplete: $0[2].boolValue) }
+        return DownloadManifest(key: key, length: length, validator: raw["validator"] as? String, chunks: chunks)
+    }
+
+    /// Write the manifest to disk
+    func save() {
+        var raw: [String:Any] = [
+            "length": NSNumber(value: length),
+            "chunks": chunks.map { [NSNumber(value: $0.start), NSNumber(value: $0.end), NSNumber(value: $0.isComplete)] }
+        ]
+        raw["validator"] = validator
+
+        do {
+            let data = try JSONSerialization.data(withJSONObject: raw)
+            try data.write(to: url, options: .atomic)
+        } catch {
+            print("Could not save download manifest: \(error)")
+        }
+    }
+
+    /// Remove the manifest, the partial file and any stray chunks
+    func remove() {
+        let fm = FileManager.default
+        try? fm.removeItem(at: url)
+        try? fm.removeItem(at: partURL)
+        for index in chunks.indices {
+            try? fm.removeItem(at: url(forChunk: index))
+        }
+    }
+
+}
+
+/// Downloads a file as a set of HTTP Range chunks fetched over several connections at once.
+/// Each finished chunk is written into a partial file and recorded in a `DownloadManifest` so
+/// the download resumes from where it got to rather than from zero. Servers that don't accept
+/// ranges get a single chunk covering the whole file.
+///
+/// Chunks are download tasks on the background session so they carry on while the app is
+/// suspended. Everything apart from file writes happens on the main queue.
+class SegmentedDownload {
+
+    /// Size of each chunk in bytes
+    static var chunkSize: Int64 = 16 * 1024 * 1024
+
+    /// Number of chunks fetched at the same time
+    var maxConnections = 4
+
+    /// How many times a chunk is retried before the download fails
+    var maxRetries = 3
+
+    /// Initial delay before retrying a chunk. This doubles with every attempt.
+    var retryDelay: TimeInterval = 2
+
+    /// The file being downloaded
+    let file: File
+
+    /// Called on the main queue as bytes arrive
+    var progress: ((SegmentedDownload) -> Void)?
+
+    /// Called on the main queue once the file is in Documents or the download has failed
+    var completion: ((SegmentedDownload, NSError?) -> Void)?
+
+    /// Bytes received so far, including chunks that are still in flight
+    private(set) var receivedBytes: Int64 = 0
+
+    /// Total size in bytes or -1 if it isn't known yet
+    private(set) var totalBytes: Int64 = -1
+
+    /// Progress between 0 and 1
+    var fractionCompleted: Double {
+        return totalBytes > 0 ? Double(receivedBytes) / Double(totalBytes) : 0
+    }
+
+    /// Session the chunks are downloaded with
+    private let manager: SessionManager
+
+    /// URL of the file on put.io
+    private let url: String
+
+    /// Where the finished file ends up
+    let destination: URL
+
+    private var manifest: DownloadManifest?
+
+    /// Requests for chunks that are in flight keyed by chunk index
+    private var requests: [Int:DownloadRequest] = [:]
+
+    /// Bytes received for chunks that are in flight
+    private var inFlightBytes: [Int:Int64] = [:]
+
+    /// Failed attempts per chunk
+    private var attempts: [Int:Int] = [:]
+
+    /// Chunks waiting out a retry delay
+    private var backingOff = Set<Int>()
+
+    /// Whether the download has completed, failed or been stopped
+    private var isFinished = false
+
+    /// Whether in-flight chunks have been suspended to stay under a bandwidth cap
+    private(set) var isSuspended = false
+
+    /// Serial queue shared by every download that writes chunks into partial files and removes them. Sharing it
+    /// means a cancelled download's files are gone before the same file can be downloaded again.
+    private static let writer = DispatchQueue(label: "uk.co.wearecocoon.fetch.download-writer", qos: .utility)
+
+    init(file: File, manager: SessionManager) {
+        self.file = file
+        self.manager = manager
+
+        let endpoint = (file.has_mp4) ? "mp4/download" : "download"
+        url = "\(Putio.api)files/\(file.id)/\(endpoint)?oauth_token=\(Putio.accessToken!)"
+
+        let documents = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        destination = documents.appendingPathComponent(SegmentedDownload.filename(for: file))
+    }
+
+    /// Key the manifest is stored under
+    private var key: String {
+        return SegmentedDownload.key(for: file)
+    }
+
+    /// Key the manifest for a file is stored under. The MP4 and original are different files.
+    class func key(for file: File) -> String {
+        return "\(file.id)-\(file.has_mp4 ? "mp4" : "original")"
+    }
+
+    /**
+     Throw away a partial download of a file that isn't currently downloading
+
+     - parameter file: The file that was being downloaded
+     */
+    class func discard(_ file: File) {
+        let key = self.key(for: file)
+        writer.sync {
+            DownloadManifest.load(key: key)?.remove()
+        }
+    }
+
+    /**
+     Name the file is saved under in Documents
+
+     - parameter file: The file being downloaded
+
+     - returns: The file name, with an mp4 extension if we're downloading the converted version
+     */
+    class func filename(for file: File) -> String {
+        let name = (file.name ?? "\(file.id)") as NSString
+        guard file.has_mp4 && name.pathExtension.lowercased() != "mp4" else {
+            return name as String
+        }
+        return name.deletingPathExtension + ".mp4"
+    }
+
+
+    // MARK: - Downloading
+
+    /// Find out how big the file is and start fetching chunks, reusing a previous attempt if there is one
+    func start() {
+        Alamofire.request(url, method: .head).response { response in
+            guard !self.isFinished else {
+                return
+            }
+
+            guard let http = response.response, http.statusCode < 400 else {
+                self.fail(response.error as NSError? ?? NSError(domain: NSURLErrorDomain, code: NSURLErrorBadServerResponse, userInfo: nil))
+                return
+            }
+
+            let acceptsRanges = (http.allHeaderFields["Accept-Ranges"] as? String)?.lowercased() == "bytes"
+            let length = acceptsRanges ? http.expectedContentLength : -1
+            let validator = (http.allHeaderFields["ETag"] ?? http.allHeaderFields["Last-Modified"]) as? String
+
+            self.prepare(length: length, validator: validator)
+        }
+    }
+
+    /// Load or create the manifest and the partial file
+    private func prepare(length: Int64, validator: String?) {
+        if let previous = DownloadManifest.load(key: key) {
+            if previous.isSegmented && previous.length == length && previous.validator == validator && FileManager.default.fileExists(atPath: previous.partURL.path) {
+                manifest = previous
+            } else {
+                previous.remove()
+            }
+        }
+
+        if manifest == nil {
+            let fresh = DownloadManifest(key: key, length: length, validator: validator, chunkSize: SegmentedDownload.chunkSize)
+
+            if fresh.isSegmented {
+                FileManager.default.createFile(atPath: fresh.partURL.path, contents: nil, attributes: nil)
+                if let handle = try? FileHandle(forWritingTo: fresh.partURL) {
+                    handle.truncateFile(atOffset: UInt64(length))
+                    handle.closeFile()
+                }
+            }
+
+            fresh.save()
+            manifest = fresh
+        }
+
+        totalBytes = length
+        updateProgress()
+        schedule()
+    }
+
+    /// Fill any free connections with chunks that still need fetching
+    private func schedule() {
+        guard !isFinished && !isSuspended, let manifest = manifest else {
+            return
+        }
+
+        for (index, chunk) in manifest.chunks.enumerated() where !chunk.isComplete && requests[index] == nil && !backingOff.contains(index) {
+            guard requests.count < maxConnections else {
+                break
+            }
+            fetch(index)
+        }
+
+        if requests.isEmpty && backingOff.isEmpty && !manifest.chunks.contains(where: { !$0.isComplete }) {
+            finish()
+        }
+    }
+
+    private func fetch(_ index: Int) {
+        guard let manifest = manifest else {
+            return
+        }
+
+        let chunk = manifest.chunks[index]
+        var headers: HTTPHeaders = [:]
+
+        if manifest.isSegmented {
+            headers["Range"] = "bytes=\(chunk.start)-\(chunk.end)"
+            if let validator = manifest.validator {
+                headers["If-Range"] = validator
+            }
+        }
+
+        let chunkURL = manifest.url(forChunk: index)
+        let destination: DownloadRequest.DownloadFileDestination = { _, _ in
+            return (chunkURL, [.removePreviousFile, .createIntermediateDirectories])
+        }
+
+        requests[index] = manager.download(url, headers: headers, to: destination)
+            .downloadProgress { progress in
+                self.inFlightBytes[index] = progress.completedUnitCount
+                if !manifest.isSegmented {
+                    self.totalBytes = progress.totalUnitCount
+                }
+                self.updateProgress()
+            }
+            .response { response in
+                self.chunkFinished(index, response: response)
+            }
+    }
+
+    private func chunkFinished(_ index: Int, response: DefaultDownloadResponse) {
+        requests[index] = nil
+        inFlightBytes[index] = nil
+
+        guard !isFinished, let manifest = manifest else {
+            return
+        }
+
+        if let error = response.error {
+            retry(index, error: error as NSError)
+            return
+        }
+
+        let status = response.response?.statusCode ?? 0
+
+        // A 200 to a ranged request means If-Range didn't match and the file on put.io has changed
+        if manifest.isSegmented && status == 200 {
+            requests.values.forEach { $0.cancel() }
+            requests = [:]
+            self.manifest = nil
+
+            // Wait for chunks that are still being written, as cancel() does
+            SegmentedDownload.writer.sync {
+                manifest.remove()
+            }
+
+            fail(NSError(domain: NSURLErrorDomain, code: NSURLErrorDataLengthExceedsMaximum, userInfo: [NSLocalizedDescriptionKey: "The file changed while it was downloading."]))
+            return
+        }
+
+        guard 200..<300 ~= status else {
+            retry(index, error: NSError(domain: NSURLErrorDomain, code: NSURLErrorBadServerResponse, userInfo: nil))
+            return
+        }
+
+        let chunk = manifest.chunks[index]
+        let chunkURL = manifest.url(forChunk: index)
+
+        SegmentedDownload.writer.async {
+            let written = SegmentedDownload.write(chunkURL, chunk: chunk, into: manifest)
+
+            DispatchQueue.main.async {
+                guard !self.isFinished else {
+                    return
+                }
+
+                guard written else {
+                    self.retry(index, error: NSError(domain: NSURLErrorDomain, code: NSURLErrorCannotWriteToFile, userInfo: nil))
+                    return
+                }
+
+                self.manifest?.chunks[index].isComplete = true
+                self.manifest?.save()
+                self.attempts[index] = nil
+                self.updateProgress()
+                self.schedule()
+            }
+        }
+    }
+
+    /**
+     Copy a downloaded chunk into the partial file. This runs on the writer queue.
+
+     - returns: Whether the chunk was the expected length and was written
+     */
+    private class func write(_ chunkURL: URL, chunk: DownloadChunk, into manifest: DownloadManifest) -> Bool {
+        defer {
+            try? FileManager.default.removeItem(at: chunkURL)
+        }
+
+        guard manifest.isSegmented else {
+            try? FileManager.default.removeItem(at: manifest.partURL)
+            return (try? FileManager.default.moveItem(at: chunkURL, to: manifest.partURL)) != nil
+        }
+
+        guard let data = try? Data(contentsOf: chunkURL, options: .alwaysMapped), Int64(data.count) == chunk.length, let handle = try? FileHandle(forWritingTo: manifest.partURL) else {
+            return false
+        }
+
+        handle.seek(toFileOffset: UInt64(chunk.start))
+        handle.write(data)
+        handle.closeFile()
+        return true
+    }
+
+    /// Try a chunk again after a delay or give up on the download once it's used up its retries
+    private func retry(_ index: Int, error: NSError) {
+        let attempt = (attempts[index] ?? 0) + 1
+
+        guard attempt <= maxRetries else {
+            fail(error)
+            return
+        }
+
+        attempts[index] = attempt
+        backingOff.insert(index)
+
+        DispatchQueue.main.asyncAfter(deadline: .now() + retryDelay * pow(2, Double(attempt - 1))) {
+            self.backingOff.remove(index)
+            self.schedule()
+        }
+    }
+
+    private func updateProgress() {
+        receivedBytes = (manifest?.received ?? 0) + inFlightBytes.values.reduce(0, +)
+        progress?(self)
+    }
+
+
+    // MARK: - Finishing
+
+    /// Move the finished file into Documents
+    private func finish() {
+        guard let manifest = manifest else {
+            return
+        }
+
+        isFinished = true
+        let destination = self.destination
+
+        SegmentedDownload.writer.async {
+            var error: NSError?
+
+            do {
+                try? FileManager.default.removeItem(at: destination)
+                try FileManager.default.moveItem(at: manifest.partURL, to: destination)
+                manifest.remove()
+            } catch let e as NSError {
+                error = e
+            }
+
+            DispatchQueue.main.async {
+                self.completion?(self, error)
+            }
+        }
+    }
+
+    /// Stop the download but keep what we've got so it can be resumed
+    private func fail(_ error: NSError) {
+        guard !isFinished else {
+            return
+        }
+
+        isFinished = true
+        requests.values.forEach { $0.cancel() }
+        requests = [:]
+        completion?(self, error)
+    }
+
+    /// Stop the download but keep the partial file so a new download of the same file resumes it.
+    /// The completion handler isn't called.
+    func stop() {
+        guard !isFinished else {
+            return
+        }
+
+        isFinished = true
+        requests.values.forEach { $0.cancel() }
+        requests = [:]
+    }
+
+    /// Stop the download and throw away the partial file. The completion handler isn't called.
+    func cancel() {
+        guard !isFinished else {
+            return
+        }
+
+        stop()
+
+        // Wait for chunks that are still being written, so none can land after the files are removed
+        let key = self.key
+        SegmentedDownload.writer.sync {
+            DownloadManifest.load(key: key)?.remove()
+        }
+    }
+
+
+    // MARK: - Throttling
+
+    /// Pause the chunks that are in flight without dropping their connections
+    func suspend() {
+        guard !isFinished && !isSuspended else {
+            return
+        }
+
+        isSuspended = true
+        requests.values.forEach { $0.suspend() }
+    }
+
+    /// Carry on after `suspend()`
+    func resume() {
+        guard isSuspended else {
+            return
+        }
+
+        isSuspended = false
+        requests.values.forEach { $0.resume() }
+        schedule()
+    }
+
+}
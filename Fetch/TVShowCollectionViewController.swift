@@ -37,7 +37,7 @@ class TVShowCollectionViewController: UICollectionViewController, UICollectionVi
      Match the seasons to episodes
      */
     func matchSeasonsIfRequired() {
-        if show.seasons.isEmpty {
+        if show.hasUnresolvedSeasons {
             loadingView.label.text = "Matching Episode Metadata..."
             loadingView.isHidden = false
             show.delegate = self
@@ -89,7 +89,7 @@ class TVShowCollectionViewController: UICollectionViewController, UICollectionVi
         
             let view = collectionView.dequeueReusableSupplementaryView(ofKind: kind, withReuseIdentifier: "seasonHeader", for: indexPath) as! SeasonSectionHeaderCollectionReusableView
             
-            let season = show.seasons.sorted(byKeyPath: "number")[indexPath.section]
+            let season = show.listedSeasons[indexPath.section]
             
             if season.number > 0 {
                 view.label.text = "SEASON \(season.number)"
@@ -108,17 +108,17 @@ class TVShowCollectionViewController: UICollectionViewController, UICollectionVi
     // MARK: UICollectionViewDataSource
 
     override func numberOfSections(in collectionView: UICollectionView) -> Int {
-        return show.seasons.sorted(byKeyPath: "number").count
+        return show.listedSeasons.count
     }
 
     override func collectionView(_ collectionView: UICollectionView, numberOfItemsInSection section: Int) -> Int {
-        return show.seasons.sorted(byKeyPath: "number")[section].episodes.sorted(byKeyPath: "episodeNo").count
+        return show.listedSeasons[section].episodes.sorted(byKeyPath: "episodeNo").count
     }
 
     override func collectionView(_ collectionView: UICollectionView, cellForItemAt indexPath: IndexPath) -> UICollectionViewCell {
         let cell = collectionView.dequeueReusableCell(withReuseIdentifier: "show", for: indexPath) as! TVShowCollectionViewCell
 
-        let ep = show.seasons.sorted(byKeyPath: "number")[indexPath.section].episodes.sorted(byKeyPath: "episodeNo")[indexPath.item]
+        let ep = show.listedSeasons[indexPath.section].episodes.sorted(byKeyPath: "episodeNo")[indexPath.item]
         
         if let title = ep.title {
             cell.titleLabel.text = "\(ep.episodeNo). \(title)"
@@ -155,7 +155,7 @@ class TVShowCollectionViewController: UICollectionViewController, UICollectionVi
         
         let castHandler = CastHandler.sharedInstance
         
-        if let file = show.seasons.sorted(byKeyPath: "number")[indexPath.section].episodes.sorted(byKeyPath: "episodeNo")[indexPath.item].file {
+        if let file = show.listedSeasons[indexPath.section].episodes.sorted(byKeyPath: "episodeNo")[indexPath.item].file {
             
             if castHandler.device != nil {
                 castHandler.sendFile(file: file) {
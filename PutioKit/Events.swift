@@ -7,71 +7,80 @@
 //
 
 import Foundation
+import SwiftyJSON
 
 public class Events {
     
+    /// Fetch the events list. Events are mapped and grouped by day off the main queue.
     public class func get(callback: @escaping ([Date:[Event]], NSError?) -> Void) {
         
-        Putio.get("events/list") { json, error in
-            
-            var sorted = [Date:[Event]]()
-            if let j = json {
+        Putio.get("events/list", decode: Events.sortedEvents) { sorted, error in
+            callback(sorted ?? [:], error)
+        }
+        
+    }
+    
+    /**
+     Map the raw events and group them by the day they were created on
+     
+     - parameter j: The events/list response
+     
+     - returns: Events keyed by day
+     */
+    class func sortedEvents(_ j: JSON) -> [Date:[Event]] {
+        
+        var sorted = [Date:[Event]]()
+        
+        if let rawEvents = j["events"].array {
+            let events: [Event] = rawEvents.map { e in
+                let event = Event()
                 
-                if let rawEvents = j["events"].array {
-                    let events: [Event] = rawEvents.map { e in
-                        let event = Event()
-                        
-                        if let type = e["type"].string {
-                            switch type {
-                                case "zip_created":
-                                    event.name = "You requested we zip some files and they are ready"
-                                    event.type = .ZipCreated
-                                    event.fileID = e["file_id"].int32
-                                case "transfer_from_rss_error":
-                                    event.name = e["transfer_name"].string
-                                    event.type = .TransferFromRSSError
-                                case "file_shared":
-                                    event.name = e["file_name"].string
-                                    event.type = .FileShared
-                                    event.fileID = e["file_id"].int32
-                                default:
-                                    event.name = e["transfer_name"].string
-                                    event.type = .TransferCompleted
-                                    event.fileID = e["file_id"].int32
-                            }
-                        } else {
+                if let type = e["type"].string {
+                    switch type {
+                        case "zip_created":
+                            event.name = "You requested we zip some files and they are ready"
+                            event.type = .ZipCreated
+                            event.fileID = e["file_id"].int32
+                        case "transfer_from_rss_error":
                             event.name = e["transfer_name"].string
                             event.type = .TransferFromRSSError
-                        }
-                        
-                        event.createdAt = e["created_at"].string
-                        
-                        return event
-                    }
-                    
-                    
-                    let formatter = DateFormatter()
-                    formatter.dateFormat = "dd/MM/yyyy"
-                    for event in events {
-                        if let date = event.date {
-                            let dateString = formatter.string(from: date as Date)
-                            let newDate = formatter.date(from: dateString)!
-                            if sorted[newDate] == nil {
-                                sorted[newDate] = []
-                            }
-                            sorted[newDate]!.append(event)
-                        }
+                        case "file_shared":
+                            event.name = e["file_name"].string
+                            event.type = .FileShared
+                            event.fileID = e["file_id"].int32
+                        default:
+                            event.name = e["transfer_name"].string
+                            event.type = .TransferCompleted
+                            event.fileID = e["file_id"].int32
                     }
-                    
+                } else {
+                    event.name = e["transfer_name"].string
+                    event.type = .TransferFromRSSError
                 }
                 
-                callback(sorted, nil)
+                event.createdAt = e["created_at"].string
+                
+                return event
+            }
+            
             
-            } else {
-                callback(sorted, error)
+            let formatter = DateFormatter()
+            formatter.dateFormat = "dd/MM/yyyy"
+            for event in events {
+                if let date = event.date {
+                    let dateString = formatter.string(from: date as Date)
+                    let newDate = formatter.date(from: dateString)!
+                    if sorted[newDate] == nil {
+                        sorted[newDate] = []
+                    }
+                    sorted[newDate]!.append(event)
+                }
             }
+            
         }
         
+        return sorted
+        
     }
     
     public class func clear(callback: @escaping () -> Void) {
@@ -7,32 +7,38 @@
 //
 
 import UIKit
+import SwiftyJSON
 
 public class Feeds {
     
+    /// Fetch the RSS feeds. The response is mapped off the main queue.
     public class func get(callback: @escaping ([Feed], NSError?) -> Void) {
         
-        Putio.get("rss/list") { json, error in
-            if let j = json {
-                if let rawFeeds = j["feeds"].array {
-                    
-                    // Map the raw JSON to lovely models
-                    let feeds: [Feed] = rawFeeds.map {
-                        let json = $0.dictionary! // Forcing this so we don't get annoying optional values
-                        
-                        let feed = Feed()
-                        feed.id = json["id"]?.int
-                        feed.title = json["title"]?.string
-                        feed.paused = json["paused"]?.bool
-                        return feed
-                    }
-                    
-                    callback(feeds, nil)
-                    
-                }
-            } else {
-                callback([], error)
+        Putio.get("rss/list", decode: Feeds.feeds) { feeds, error in
+            callback(feeds ?? [], error)
+        }
+        
+    }
+    
+    /**
+     Map the raw JSON to lovely models
+     
+     - parameter j: The rss/list response
+     
+     - returns: The feeds
+     */
+    class func feeds(_ j: JSON) -> [Feed] {
+        
+        return j["feeds"].arrayValue.flatMap {
+            guard let json = $0.dictionary else {
+                return nil
             }
+            
+            let feed = Feed()
+            feed.id = json["id"]?.int
+            feed.title = json["title"]?.string
+            feed.paused = json["paused"]?.bool
+            return feed
         }
         
     }
@@ -28,6 +28,7 @@ public class File: Object {
     public dynamic var parent: File?
     public dynamic var type: String?
     public dynamic var created_at: String?
+    public dynamic var updated_at: String?
     
     override public static func primaryKey() -> String? {
         return "id"
@@ -147,31 +148,11 @@ public class File: Object {
         let params = ["oauth_token": "\(Putio.accessToken!)", "start_from": "1"]
         
         Alamofire.request("\(Putio.api)files/\(id)", method: .get, parameters: params)
-            .responseJSON { response in
-                if response.result.isSuccess {
-                    let json = JSON(response.result.value!)
-                    
-                    let subtitles = ""
-                    let accessed = ( json["file"]["first_accessed_at"].null != nil ) ? false : true
-                    let start_from = ( json["file"]["start_from"].null != nil ) ? 0 : json["file"]["start_from"].double!
-                    let has_mp4 = (json["file"]["is_mp4_available"].bool != nil) ? json["file"]["is_mp4_available"].bool! : false
-                    
-                    let file = File()
-                    file.id = json["file"]["id"].int!
-                    file.name = json["file"]["name"].string!
-                    file.size = json["file"]["size"].int64!
-                    file.icon = json["file"]["icon"].string!
-                    file.content_type =  json["file"]["content_type"].string!
-                    file.has_mp4 = has_mp4
-                    file.parent_id = json["file"]["parent_id"].int!
-                    file.subtitles = subtitles
-                    file.accessed = accessed
-                    file.screenshot = json["file"]["screenshot"].string
-                    file.is_shared = json["file"]["is_shared"].bool!
-                    file.start_from = start_from
-                    file.created_at = json["file"]["created_at"].string
-                    callback(file)
-                    
+            .responseData(queue: Putio.decodingQueue) { response in
+                if let data = response.result.value, let file = FileDecoder.file(from: data) {
+                    DispatchQueue.main.async {
+                        callback(file)
+                    }
                 }
             }
     }
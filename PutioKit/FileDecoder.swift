@@ -0,0 +1,177 @@
+//
+//  FileDecoder.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+
+/// A put.io file exactly as the API describes it. Records are plain values so they can be
+/// decoded on any queue and handed across to the main queue without copying.
+public struct FileRecord {
+
+    public let id: Int
+    public let name: String
+    public let size: Int64
+    public let icon: String?
+    public let contentType: String
+    public let hasMP4: Bool
+    public let parentID: Int
+    public let subtitles: String
+    public let accessed: Bool
+    public let screenshot: String?
+    public let isShared: Bool
+    public let startFrom: Float64
+    public let createdAt: String?
+    public let updatedAt: String?
+
+    /**
+     Decode a record from a deserialized JSON object. Every key is read exactly once.
+
+     - parameter raw: A single entry from a `files` array
+
+     - returns: The record or nil if the entry is missing an ID, name or content type
+     */
+    public init?(_ raw: [String:Any]) {
+        guard let id = raw["id"] as? Int, let name = raw["name"] as? String, let contentType = raw["content_type"] as? String else {
+            return nil
+        }
+
+        self.id = id
+        self.name = name
+        self.contentType = contentType
+        size = (raw["size"] as? NSNumber)?.int64Value ?? 0
+        icon = raw["icon"] as? String
+        hasMP4 = raw["is_mp4_available"] as? Bool ?? false
+        parentID = raw["parent_id"] as? Int ?? 0
+        subtitles = raw["opensubtitles_hash"] as? String ?? ""
+        accessed = raw["first_accessed_at"].map { !($0 is NSNull) } ?? false
+        screenshot = raw["screenshot"] as? String
+        isShared = raw["is_shared"] as? Bool ?? false
+        startFrom = (raw["start_from"] as? NSNumber)?.doubleValue ?? 0
+        createdAt = raw["created_at"] as? String
+        updatedAt = raw["updated_at"] as? String
+    }
+
+    /// Whether this is a folder
+    public var isFolder: Bool {
+        return contentType == "application/x-directory"
+    }
+
+    /// Whether this can be streamed as an MP4
+    public var isPlayable: Bool {
+        return hasMP4 || contentType == "video/mp4"
+    }
+
+    /**
+     Predicate for folders that we own
+
+     - parameter ids: IDs of folders to leave out
+
+     - returns: A predicate for `FileDecoder`
+     */
+    public static func folders(excluding ids: [Int]) -> (FileRecord) -> Bool {
+        return { $0.isFolder && !$0.isShared && !ids.contains($0.id) }
+    }
+
+}
+
+extension File {
+
+    /// Create an unmanaged file from a decoded record
+    public convenience init(record: FileRecord) {
+        self.init()
+        id = record.id
+        name = record.name
+        size = record.size
+        icon = record.icon
+        content_type = record.contentType
+        has_mp4 = record.hasMP4
+        parent_id = record.parentID
+        subtitles = record.subtitles
+        accessed = record.accessed
+        screenshot = record.screenshot
+        is_shared = record.isShared
+        start_from = record.startFrom
+        created_at = record.createdAt
+        updated_at = record.updatedAt
+    }
+
+}
+
+/// Decodes put.io file listings in a single pass over the deserialized JSON. An optional
+/// predicate is checked against each record so rejected entries never become a `File`.
+/// This is meant to be run on `Putio.decodingQueue` with only the finished array handed back
+/// to the UI.
+public class FileDecoder {
+
+    /**
+     Decode the records in a listing
+
+     - parameter data:       The raw response body
+     - parameter key:        The key holding the array of files
+     - parameter isIncluded: Which entries to keep. Everything is kept if this is nil.
+
+     - returns: Every valid, included record in the order the API returned them
+     */
+    public class func records(from data: Data, key: String = "files", where isIncluded: ((FileRecord) -> Bool)? = nil) -> [FileRecord] {
+        guard let object = try? JSONSerialization.jsonObject(with: data), let root = object as? [String:Any], let entries = root[key] as? [[String:Any]] else {
+            return []
+        }
+
+        return records(from: entries, where: isIncluded)
+    }
+
+    /**
+     Decode records from entries that have already been deserialized
+
+     - parameter entries:    Entries from a `files` array
+     - parameter isIncluded: Which entries to keep. Everything is kept if this is nil.
+
+     - returns: Every valid, included record in order
+     */
+    public class func records(from entries: [[String:Any]], where isIncluded: ((FileRecord) -> Bool)? = nil) -> [FileRecord] {
+        var records: [FileRecord] = []
+        records.reserveCapacity(entries.count)
+
+        for entry in entries {
+            if let record = FileRecord(entry), isIncluded?(record) ?? true {
+                records.append(record)
+            }
+        }
+
+        return records
+    }
+
+    /**
+     Decode a listing into unmanaged files
+
+     - parameter data:       The raw response body
+     - parameter key:        The key holding the array of files
+     - parameter isIncluded: Which entries to keep. Everything is kept if this is nil.
+
+     - returns: Files in the order the API returned them
+     */
+    public class func files(from data: Data, key: String = "files", where isIncluded: ((FileRecord) -> Bool)? = nil) -> [File] {
+        return records(from: data, key: key, where: isIncluded).map(File.init(record:))
+    }
+
+    /**
+     Decode a single file response such as files/{id}
+
+     - parameter data: The raw response body
+     - parameter key:  The key holding the file
+
+     - returns: An unmanaged file or nil if it couldn't be decoded
+     */
+    public class func file(from data: Data, key: String = "file") -> File? {
+        guard let object = try? JSONSerialization.jsonObject(with: data), let root = object as? [String:Any], let entry = root[key] as? [String:Any] else {
+            return nil
+        }
+
+        return FileRecord(entry).map(File.init(record:))
+    }
+
+}
@@ -0,0 +1,116 @@
+//
+//  FileTreeSnapshot.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+
+/// A persisted picture of the put.io folder tree. Every folder is stored with the size,
+/// created_at and updated_at it had when it was last listed alongside the raw JSON of its
+/// children. put.io folder sizes change whenever anything is added or removed beneath them and
+/// updated_at changes when a child is renamed, so a folder that still matches its snapshot can be
+/// rebuilt without listing it again.
+public struct FileTreeSnapshot {
+
+    /// A folder as it was when it was listed
+    struct Folder {
+        let size: Int64
+        let createdAt: String?
+        let updatedAt: String?
+        let children: [[String:Any]]
+    }
+
+    /// Listed folders keyed by their ID. The root folder is 0.
+    fileprivate(set) var folders: [Int:Folder] = [:]
+
+    /// Where the snapshot is stored on disk
+    public static var url: URL {
+        let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        return caches.appendingPathComponent("FileTreeSnapshot.json")
+    }
+
+    public init() {}
+
+    /// Number of folders in the snapshot
+    public var count: Int {
+        return folders.count
+    }
+
+    /**
+     The children of a folder, providing it hasn't changed since the snapshot was taken
+
+     - parameter folder: The folder as it has just been listed by its parent
+
+     - returns: Raw JSON for each child or nil if the folder needs listing again
+     */
+    func children(of folder: File) -> [[String:Any]]? {
+        guard let cached = folders[folder.id], cached.size == folder.size, cached.createdAt == folder.created_at, cached.updatedAt == folder.updated_at else {
+            return nil
+        }
+        return cached.children
+    }
+
+    /**
+     Record the listing of a folder
+
+     - parameter folder:   The folder that was listed or nil for the root
+     - parameter children: Raw JSON for each child
+     */
+    mutating func record(_ folder: File?, children: [[String:Any]]) {
+        folders[folder?.id ?? 0] = Folder(size: folder?.size ?? 0, createdAt: folder?.created_at, updatedAt: folder?.updated_at, children: children)
+    }
+
+
+    // MARK: - Persistence
+
+    /**
+     Load the snapshot from disk
+
+     - returns: The snapshot or nil if one hasn't been saved
+     */
+    public static func load() -> FileTreeSnapshot? {
+        guard let data = try? Data(contentsOf: url), let object = try? JSONSerialization.jsonObject(with: data), let raw = (object as? [String:Any])?["folders"] as? [String:[String:Any]] else {
+            return nil
+        }
+
+        var snapshot = FileTreeSnapshot()
+        for (key, folder) in raw {
+            if let id = Int(key), let size = folder["size"] as? NSNumber {
+                snapshot.folders[id] = Folder(size: size.int64Value, createdAt: folder["created_at"] as? String, updatedAt: folder["updated_at"] as? String, children: folder["children"] as? [[String:Any]] ?? [])
+            }
+        }
+
+        return snapshot
+    }
+
+    /// Write the snapshot to disk
+    public func save() {
+        var raw: [String:Any] = [:]
+        for (id, folder) in folders {
+            var entry: [String:Any] = ["size": NSNumber(value: folder.size), "children": folder.children]
+            if let createdAt = folder.createdAt {
+                entry["created_at"] = createdAt
+            }
+            if let updatedAt = folder.updatedAt {
+                entry["updated_at"] = updatedAt
+            }
+            raw["\(id)"] = entry
+        }
+
+        do {
+            let data = try JSONSerialization.data(withJSONObject: ["folders": raw])
+            try data.write(to: FileTreeSnapshot.url, options: .atomic)
+        } catch {
+            print("Could not save file tree snapshot: \(error)")
+        }
+    }
+
+    /// Remove the snapshot from disk
+    public static func remove() {
+        try? FileManager.default.removeItem(at: url)
+    }
+
+}
@@ -8,287 +8,75 @@
 
 import UIKit
 import Alamofire
-import SwiftyJSON
 
 public class Files {
     
     
-    /// Fetch an array of files from a specific URL
+    /// Fetch an array of files from a specific URL. The listing is decoded off the main queue.
     public class func fetchWithURL(_ url: String, params: [String:String], sender: UIViewController, callback: @escaping ([File]) -> Void) {
-        
-        Putio.networkActivityIndicatorVisible(true)
-        
-        Alamofire.request(url, method: .get, parameters: params)
-            .responseJSON { response in
-                
-                Putio.networkActivityIndicatorVisible(false)
-                
-                if(response.response!.statusCode >= 400 && response.response!.statusCode < 500) {
-                    Putio.sharedInstance.delegate?.error400Received()
-                    return
-                }
-                
-                var files: [File] = []
-                
-                if let error = response.result.error {
-                    print(error)
-                } else {
-                    var json = JSON(response.result.value!)
-                    
-                    for (_, jFile): (String, JSON) in json["files"] {
-                        
-                        let subtitles = ( jFile["opensubtitles_hash"].null != nil ) ? "" : jFile["opensubtitles_hash"].string!
-                        let accessed = ( jFile["first_accessed_at"].null != nil ) ? false : true
-                        let start_from = ( jFile["start_from"].null != nil ) ? 0 : jFile["start_from"].double!
-                        let has_mp4 = (jFile["is_mp4_available"].bool != nil) ? jFile["is_mp4_available"].bool! : false
-                        
-                        let file = File()
-                        file.id = jFile["id"].int!
-                        file.name = jFile["name"].string!
-                        file.size = jFile["size"].int64!
-                        file.icon = jFile["icon"].string!
-                        file.content_type = jFile["content_type"].string!
-                        file.has_mp4 = has_mp4
-                        file.parent_id = jFile["parent_id"].int!
-                        file.subtitles = subtitles
-                        file.accessed = accessed
-                        file.screenshot = jFile["screenshot"].string
-                        file.is_shared = jFile["is_shared"].bool!
-                        file.start_from = start_from
-                        file.created_at = jFile["created_at"].string
-                        files.append(file)
-                        
-                    }
-
-                }
-                
-                callback(files)
-                
-            }
-    
+        fetchFromURL(url, params: params, handle400: true, callback: callback)
     }
     
+    /// Fetch folders and anything that can be played from a specific URL
     public class func fetchMoviesFromURL(_ url: String, params: [String:String], sender: UIViewController, callback: @escaping ([File]) -> Void) {
-        
-        Putio.networkActivityIndicatorVisible(true)
-        
-        Alamofire.request(url, method: .get, parameters: params)
-            .responseJSON { response in
-                
-                Putio.networkActivityIndicatorVisible(false)
-                
-                if(response.response!.statusCode >= 400 && response.response!.statusCode < 500) {
-                    Putio.sharedInstance.delegate?.error400Received()
-                    return
-                }
-                
-                var files: [File] = []
-                
-                if let error = response.result.error {
-                    print(error)
-                } else {
-                    var json = JSON(response.result.value!)
-                    
-                    for (_, jFile): (String, JSON) in json["files"] {
-                       
-                        
-                        let subtitles = ( jFile["opensubtitles_hash"].null != nil ) ? "" : jFile["opensubtitles_hash"].string!
-                        let accessed = ( jFile["first_accessed_at"].null != nil ) ? false : true
-                        let start_from = ( jFile["start_from"].null != nil ) ? 0 : jFile["start_from"].double!
-                        let has_mp4 = (jFile["is_mp4_available"].bool != nil) ? jFile["is_mp4_available"].bool! : false
-                        
-                        if !has_mp4 && jFile["content_type"] != "application/x-directory" && jFile["content_type"] != "video/mp4"  {
-                            continue
-                        }
-                        
-                        
-                        let file = File()
-                        file.id = jFile["id"].int!
-                        file.name = jFile["name"].string!
-                        file.size = jFile["size"].int64!
-                        file.icon = jFile["icon"].string!
-                        file.content_type = jFile["content_type"].string!
-                        file.has_mp4 = has_mp4
-                        file.parent_id = jFile["parent_id"].int!
-                        file.subtitles = subtitles
-                        file.accessed = accessed
-                        file.screenshot = jFile["screenshot"].string
-                        file.is_shared = jFile["is_shared"].bool!
-                        file.start_from = start_from
-                        file.created_at = jFile["created_at"].string
-                        files.append(file)
-                        
-                    }
-                    
-                }
-                
-                callback(files)
-                
-        }
-        
+        fetchFromURL(url, params: params, handle400: true, where: { $0.isFolder || $0.isPlayable }, callback: callback)
     }
     
-    
     /// Fetch an array of folders from a specific URL
     public class func fetchFoldersFromURL(_ url: String, params: [String:String], callback: @escaping ([File]) -> Void) {
-        
-        Putio.networkActivityIndicatorVisible(true)
-        
-        Alamofire.request(url, method: .get, parameters: params)
-            .responseJSON { response in
-                
-                Putio.networkActivityIndicatorVisible(false)
-                
-                var files: [File] = []
-                
-                if let error = response.result.error {
-                    print(error)
-                } else {
-                    var json = JSON(response.result.value!)
-                    
-                    for (_, jFile): (String, JSON) in json["files"] {
-                        
-                        if jFile["content_type"].string! != "application/x-directory" || jFile["is_shared"].bool! {
-                            continue
-                        }
-                        
-                        let subtitles = ( jFile["opensubtitles_hash"].null != nil ) ? "" : jFile["opensubtitles_hash"].string!
-                        let accessed = ( jFile["first_accessed_at"].null != nil ) ? false : true
-                        let start_from = ( jFile["start_from"].null != nil ) ? 0 : jFile["start_from"].double!
-                        let has_mp4 = (jFile["is_mp4_available"].bool != nil) ? jFile["is_mp4_available"].bool! : false
-                        
-                        let file = File()
-                        file.id = jFile["id"].int!
-                        file.name = jFile["name"].string!
-                        file.size = jFile["size"].int64!
-                        file.icon = jFile["icon"].string!
-                        file.content_type = jFile["content_type"].string!
-                        file.has_mp4 = has_mp4
-                        file.parent_id = jFile["parent_id"].int!
-                        file.subtitles = subtitles
-                        file.accessed = accessed
-                        file.screenshot = jFile["screenshot"].string
-                        file.is_shared = jFile["is_shared"].bool!
-                        file.start_from = start_from
-                        file.created_at = jFile["created_at"].string
-                        files.append(file)
-                        
-                    }
-                }
-                
-                callback(files)
-                
-            }
-        
+        fetchFromURL(url, params: params, where: FileRecord.folders(excluding: []), callback: callback)
     }
     
+    /// Fetch an array of folders from a specific URL but exclude some IDs
     public class func fetchFoldersWithExclusionFromURL(_ url: String, params: [String:String], exclude: [Int] = [], callback: @escaping ([File]) -> Void) {
-        
-        Putio.networkActivityIndicatorVisible(true)
-        
-        Alamofire.request(url, method: .get, parameters: params)
-            .responseJSON { response in
-                
-                Putio.networkActivityIndicatorVisible(false)
-                
-                var files: [File] = []
-                
-                if let error = response.result.error {
-                    print(error)
-                } else {
-                    var json = JSON(response.result.value!)
-                    
-                    for (_, jFile): (String, JSON) in json["files"] {
-                        
-                        if jFile["content_type"].string! != "application/x-directory" || jFile["is_shared"].bool! || exclude.contains(jFile["id"].int!) {
-                            continue
-                        }
-                        
-                        let subtitles = ( jFile["opensubtitles_hash"].null != nil ) ? "" : jFile["opensubtitles_hash"].string!
-                        let accessed = ( jFile["first_accessed_at"].null != nil ) ? false : true
-                        let start_from = ( jFile["start_from"].null != nil ) ? 0 : jFile["start_from"].double!
-                        let has_mp4 = (jFile["is_mp4_available"].bool != nil) ? jFile["is_mp4_available"].bool! : false
-                        
-                        let file = File()
-                        file.id = jFile["id"].int!
-                        file.name = jFile["name"].string!
-                        file.size = jFile["size"].int64!
-                        file.icon = jFile["icon"].string!
-                        file.content_type = jFile["content_type"].string!
-                        file.has_mp4 = has_mp4
-                        file.parent_id = jFile["parent_id"].int!
-                        file.subtitles = subtitles
-                        file.accessed = accessed
-                        file.screenshot = jFile["screenshot"].string
-                        file.is_shared = jFile["is_shared"].bool!
-                        file.start_from = start_from
-                        file.created_at = jFile["created_at"].string
-                        files.append(file)
-                        
-                    }
-                    
-                }
-                
-                
-                callback(files)
-                
-        }
-        
+        fetchFromURL(url, params: params, where: FileRecord.folders(excluding: exclude), callback: callback)
     }
     
     /// Fetch an array of folders from a specific URL but exclude a file
     public class func fetchFoldersWithExclusionFromURL(_ url: String, params: [String:String], exclude: File?, callback: @escaping ([File]) -> Void) {
+        fetchFromURL(url, params: params, where: FileRecord.folders(excluding: exclude.map { [$0.id] } ?? []), callback: callback)
+    }
+    
+    /**
+     Fetch a listing and decode it off the main queue. Entries rejected by the predicate are
+     skipped before a `File` is ever created for them.
+     
+     - parameter url:        The URL to fetch
+     - parameter params:     Query parameters
+     - parameter handle400:  Whether a 4xx should be reported to the Putio delegate instead of calling back
+     - parameter isIncluded: Which entries to keep. Everything is kept if this is nil.
+     - parameter callback:   Called on the main queue with the files
+     */
+    private class func fetchFromURL(_ url: String, params: [String:String], handle400: Bool = false, where isIncluded: ((FileRecord) -> Bool)? = nil, callback: @escaping ([File]) -> Void) {
         
         Putio.networkActivityIndicatorVisible(true)
         
         Alamofire.request(url, method: .get, parameters: params)
-            .responseJSON { response in
-                
-                Putio.networkActivityIndicatorVisible(false)
+            .responseData(queue: Putio.decodingQueue) { response in
                 
                 var files: [File] = []
                 
                 if let error = response.result.error {
                     print(error)
-                } else {
-                    var json = JSON(response.result.value!)
+                } else if let data = response.result.value {
+                    files = FileDecoder.files(from: data, where: isIncluded)
+                }
+                
+                DispatchQueue.main.async {
+                    
+                    Putio.networkActivityIndicatorVisible(false)
                     
-                    for (_, jFile): (String, JSON) in json["files"] {
-                        
-                        if jFile["content_type"].string! != "application/x-directory" || jFile["is_shared"].bool! || (exclude != nil && jFile["id"].int! == exclude!.id) {
-                            continue
-                        }
-                        
-                        let subtitles = ( jFile["opensubtitles_hash"].null != nil ) ? "" : jFile["opensubtitles_hash"].string!
-                        let accessed = ( jFile["first_accessed_at"].null != nil ) ? false : true
-                        let start_from = ( jFile["start_from"].null != nil ) ? 0 : jFile["start_from"].double!
-                        let has_mp4 = (jFile["is_mp4_available"].bool != nil) ? jFile["is_mp4_available"].bool! : false
-                        
-                        let file = File()
-                        file.id = jFile["id"].int!
-                        file.name = jFile["name"].string!
-                        file.size = jFile["size"].int64!
-                        file.icon = jFile["icon"].string!
-                        file.content_type = jFile["content_type"].string!
-                        file.has_mp4 = has_mp4
-                        file.parent_id = jFile["parent_id"].int!
-                        file.subtitles = subtitles
-                        file.accessed = accessed
-                        file.screenshot = jFile["screenshot"].string
-                        file.is_shared = jFile["is_shared"].bool!
-                        file.start_from = start_from
-                        file.created_at = jFile["created_at"].string
-                        files.append(file)
-                        
+                    if let code = response.response?.statusCode, handle400 && code >= 400 && code < 500 {
+                        Putio.sharedInstance.delegate?.error400Received()
+                        return
                     }
-
+                    
+                    callback(files)
+                    
                 }
                 
-                
-                callback(files)
-                
-        }
-        
+            }
+    
     }
     
     public class func moveFiles(_ files: [File], parent: Int) {
@@ -0,0 +1,329 @@
+//
+//  FolderCrawler.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+import Alamofire
+
+/// Throughput numbers collected while crawling the put.io file tree
+public struct CrawlStats {
+
+    /// Number of folders that have been listed
+    public var folders = 0
+
+    /// Number of unchanged folders rebuilt from the previous snapshot
+    public var reused = 0
+
+    /// Number of files (including folders) found
+    public var files = 0
+
+    /// Bytes of JSON received and parsed
+    public var bytes = 0
+
+    /// Number of requests that had to be retried
+    public var retries = 0
+
+    /// Number of folders we gave up on after running out of retries or that put.io rejected
+    public var failures = 0
+
+    /// Whether the crawl was stopped early because put.io rejected a listing or we were logged out
+    public var cancelled = false
+
+    /// The highest number of requests that were in-flight at once
+    public var peakInFlight = 0
+
+    /// When the crawl was started
+    public var startedAt: Date?
+
+    /// When the crawl finished
+    public var finishedAt: Date?
+
+    /// Seconds since the crawl was started
+    public var elapsed: TimeInterval {
+        guard let start = startedAt else { return 0 }
+        return (finishedAt ?? Date()).timeIntervalSince(start)
+    }
+
+    /// Folders listed per second
+    public var foldersPerSecond: Double {
+        return elapsed > 0 ? Double(folders) / elapsed : 0
+    }
+
+    /// Bytes of JSON parsed per second
+    public var bytesPerSecond: Double {
+        return elapsed > 0 ? Double(bytes) / elapsed : 0
+    }
+
+}
+
+extension CrawlStats: CustomStringConvertible {
+
+    public var description: String {
+        return String(format: "%d folders (%d reused), %d files, %d bytes in %.2fs (%.1f folders/sec, %.0f bytes/sec, %d retries, %d failures, %d peak in-flight)", folders, reused, files, bytes, elapsed, foldersPerSecond, bytesPerSecond, retries, failures, peakInFlight)
+    }
+
+}
+
+/// Breadth-first crawler for the put.io file tree. Folders are pulled from a FIFO work queue
+/// and listed with at most `maxConcurrentRequests` requests in-flight. All state lives on a
+/// private serial queue so completion is only ever signalled once. When given a previous
+/// snapshot, folders whose parent was just listed and shows them unchanged are rebuilt from it
+/// instead of being listed. Their subfolders are listed again, so a rename at any depth is seen.
+public class FolderCrawler {
+
+    /// The API to crawl. Point this at a local mock to tune the crawler.
+    public var api = Putio.api
+
+    /// Maximum number of `files/list` requests in-flight at once
+    public var maxConcurrentRequests = 4
+
+    /// How many times a failed listing will be retried
+    public var maxRetries = 3
+
+    /// Delay before the first retry. This is doubled for every subsequent attempt.
+    public var retryDelay: TimeInterval = 1
+
+    /// Called on the main queue every time a folder has been listed
+    public var progress: ((CrawlStats) -> Void)?
+
+    /// Which entries become files. Folders are always crawled whether they're included or not.
+    public var isIncluded: ((FileRecord) -> Bool)?
+
+    /// Serial queue that owns all of the crawler's state
+    private let queue = DispatchQueue(label: "uk.co.wearecocoon.fetch.crawler")
+
+    /// Folders waiting to be listed, how many times we've tried them and whether they were found in
+    /// a reused listing. A reused folder's subfolders carry the size and updated_at they had last
+    /// time, so they can't be checked against the snapshot and are always listed again.
+    private var pending: [(folder: File?, attempt: Int, stale: Bool)] = []
+
+    /// Number of requests currently in-flight
+    private var inFlight = 0
+
+    /// Everything found so far
+    private var found: [File] = []
+
+    /// The snapshot we're reusing unchanged folders from
+    private var previous: FileTreeSnapshot?
+
+    /// The snapshot being built by this crawl
+    private var snapshot = FileTreeSnapshot()
+
+    private var stats = CrawlStats()
+
+    private var running = false
+
+    /// Everyone waiting on the current crawl. A crawl started while one is running waits for it.
+    private var completions: [([File], FileTreeSnapshot, CrawlStats) -> Void] = []
+
+    public init() {}
+
+    /// Whether a crawl is currently running
+    public var isCrawling: Bool {
+        return queue.sync { running }
+    }
+
+    /**
+     Crawl the whole tree starting at the root folder
+
+     - parameter previous: Snapshot from the last crawl. Unchanged folders will be taken from it.
+     - parameter callback: Called on the main queue with every file found, a snapshot of the tree and the crawl stats. If a crawl is already running this is called when it finishes.
+     */
+    public func crawl(reusing previous: FileTreeSnapshot? = nil, callback: @escaping ([File], FileTreeSnapshot, CrawlStats) -> Void) {
+        queue.async {
+            self.completions.append(callback)
+
+            guard !self.running else {
+                print("already crawling")
+                return
+            }
+
+            self.running = true
+            self.found = []
+            self.previous = previous
+            self.snapshot = FileTreeSnapshot()
+            self.stats = CrawlStats()
+            self.stats.startedAt = Date()
+            self.pending = [(nil, 0, false)]
+            self.inFlight = 0
+
+            DispatchQueue.main.async {
+                Putio.networkActivityIndicatorVisible(true)
+            }
+
+            self.drain()
+        }
+    }
+
+    // MARK: - Queue
+
+    /// Start requests until we hit the in-flight limit or run out of work
+    private func drain() {
+        while !pending.isEmpty {
+            let next = pending[0]
+
+            if !next.stale, let folder = next.folder, let children = previous?.children(of: folder) {
+                pending.removeFirst()
+                stats.reused += 1
+                add(children, folder: folder, reused: true)
+                continue
+            }
+
+            guard inFlight < maxConcurrentRequests else {
+                break
+            }
+
+            pending.removeFirst()
+            inFlight += 1
+            stats.peakInFlight = max(stats.peakInFlight, inFlight)
+            list(next.folder, attempt: next.attempt)
+        }
+
+        if inFlight == 0 && pending.isEmpty {
+            finish()
+        }
+    }
+
+    /// List a single folder. `nil` is the root folder.
+    private func list(_ folder: File?, attempt: Int) {
+        guard let token = Putio.accessToken else {
+            print("Logged out")
+            stats.cancelled = true
+            pending = []
+            inFlight -= 1
+            return
+        }
+
+        var params = ["oauth_token": token, "start_from": "1"]
+        if let folder = folder {
+            params["parent_id"] = "\(folder.id)"
+        }
+
+        Alamofire.request("\(api)files/list", method: .get, parameters: params)
+            .validate(statusCode: 200..<300)
+            .responseData(queue: queue) { response in
+
+                self.inFlight -= 1
+
+                // Whatever was still in-flight when the crawl was cancelled is ignored
+                guard !self.stats.cancelled else {
+                    self.drain()
+                    return
+                }
+
+                if let code = response.response?.statusCode, case 400..<404 = code {
+                    self.cancel()
+                } else if response.result.isFailure {
+                    self.retry(folder, attempt: attempt)
+                } else if let data = response.result.value {
+                    self.parse(data, folder: folder)
+                }
+
+                self.drain()
+
+            }
+    }
+
+    /// Re-queue a folder after backing off, or give up on it
+    private func retry(_ folder: File?, attempt: Int) {
+        guard attempt < maxRetries else {
+            print("Giving up on folder \(folder?.id ?? 0)")
+            stats.failures += 1
+            return
+        }
+
+        stats.retries += 1
+
+        // Hold an in-flight slot while we wait so we don't finish early
+        inFlight += 1
+        let delay = retryDelay * pow(2, Double(attempt))
+        queue.asyncAfter(deadline: .now() + delay) {
+            self.inFlight -= 1
+            if !self.stats.cancelled {
+                self.pending.append((folder, attempt + 1, false))
+            }
+            self.drain()
+        }
+    }
+
+    /// Stop crawling after put.io rejected a listing, most likely because the token was revoked.
+    /// Nothing more is listed and the delegate is only told once.
+    private func cancel() {
+        print("Listing rejected, cancelling crawl")
+        stats.failures += 1
+        stats.cancelled = true
+        pending = []
+
+        DispatchQueue.main.async {
+            Putio.sharedInstance.delegate?.error400Received()
+        }
+    }
+
+    /// Parse a listing from the API
+    private func parse(_ data: Data, folder: File?) {
+        stats.bytes += data.count
+        stats.folders += 1
+
+        let object = try? JSONSerialization.jsonObject(with: data)
+        add((object as? [String:Any])?["files"] as? [[String:Any]] ?? [], folder: folder, reused: false)
+    }
+
+    /// Map the children of a folder, record them and queue any subfolders. `reused` is whether the
+    /// children came from the previous snapshot rather than a fresh listing.
+    private func add(_ children: [[String:Any]], folder: File?, reused: Bool) {
+        snapshot.record(folder, children: children)
+
+        var files: [File] = []
+        for record in FileDecoder.records(from: children) {
+            let isFolder = record.isFolder && !record.isShared
+            guard isFolder || (isIncluded?(record) ?? true) else {
+                continue
+            }
+
+            let file = File(record: record)
+            file.parent = folder
+            files.append(file)
+
+            if isFolder {
+                pending.append((file, 0, reused))
+            }
+        }
+
+        found.append(contentsOf: files)
+        stats.files += files.count
+
+        if let progress = progress {
+            let snapshot = stats
+            DispatchQueue.main.async {
+                progress(snapshot)
+            }
+        }
+    }
+
+    private func finish() {
+        guard running else { return }
+
+        running = false
+        stats.finishedAt = Date()
+
+        let files = found
+        let snapshot = self.snapshot
+        let stats = self.stats
+        let callbacks = completions
+        completions = []
+        found = []
+        previous = nil
+
+        DispatchQueue.main.async {
+            Putio.networkActivityIndicatorVisible(false)
+            for callback in callbacks {
+                callback(files, snapshot, stats)
+            }
+        }
+    }
+
+}
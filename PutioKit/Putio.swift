@@ -24,7 +24,26 @@ public class Putio {
     public static let keychain = Keychain(service: "uk.co.wearecocoon.fetch")
     
     /// The shared realm instance
-    public static let realm = try! Realm()
+    public static let realm: Realm = {
+        Realm.Configuration.defaultConfiguration = Realm.Configuration(schemaVersion: 2, migrationBlock: { migration, oldSchemaVersion in
+            
+            // 1: Episodes keep every file rather than just one
+            if oldSchemaVersion < 1 {
+                migration.enumerateObjects(ofType: TVEpisode.className()) { old, new in
+                    if let file = old?["file"] as? MigrationObject {
+                        new?.dynamicList("files").append(file)
+                    }
+                }
+            }
+            
+            // 2: Files gain updated_at, which Realm adds by itself
+            
+        })
+        return try! Realm()
+    }()
+    
+    /// Responses are deserialized and mapped to models on this queue rather than the main queue
+    public static let decodingQueue = DispatchQueue(label: "uk.co.wearecocoon.fetch.decoding", qos: .userInitiated, attributes: .concurrent)
     
     /// The access token stored in keychain after we logged in
     public static var accessToken: String? {
@@ -63,6 +82,18 @@ public class Putio {
     - parameter callback: Optional callback
     */
     public class func get(_ endpoint: String, parameters: [String:Any] = [:], callback: ((JSON?, NSError?) -> Void)?) {
+        self.get(endpoint, parameters: parameters, decode: { $0 }, callback: callback)
+    }
+    
+    /**
+     Run a GET request to Put.io and map the response to a model. The response is deserialized
+     and decoded on `decodingQueue` so only the finished model reaches the main queue.
+     
+     - parameter endpoint: The endpoint to call
+     - parameter decode:   Maps the JSON to a model. This is not called on the main queue.
+     - parameter callback: Optional callback, called on the main queue
+     */
+    public class func get<T>(_ endpoint: String, parameters: [String:Any] = [:], decode: @escaping (JSON) -> T, callback: ((T?, NSError?) -> Void)?) {
         
         self.networkActivityIndicatorVisible(true)
         
@@ -71,25 +102,30 @@ public class Putio {
         
         Alamofire.request("\(self.api)\(endpoint)", method: .get, parameters: params)
             .validate(statusCode: 200..<300)
-            .responseJSON { response in
+            .responseJSON(queue: decodingQueue) { response in
                 
-                self.networkActivityIndicatorVisible(false)
+                let decoded = response.result.value.map { decode(JSON($0)) }
                 
-                if let code = response.response?.statusCode, response.result.isFailure {
-                    if case 400..<404 = code {
-                        Putio.sharedInstance.delegate?.error400Received()
+                DispatchQueue.main.async {
+                    
+                    self.networkActivityIndicatorVisible(false)
+                    
+                    if let code = response.response?.statusCode, response.result.isFailure {
+                        if case 400..<404 = code {
+                            Putio.sharedInstance.delegate?.error400Received()
+                        }
                     }
-                }
-                
-                if let cb = callback {
-                    if response.result.error != nil {
-                        cb(nil, response.result.error as NSError?)
-                    } else if let data = response.result.value {
-                        let json = JSON(data)
-                        cb(json, nil)
-                    } else {
-                        cb(nil, nil)
+                    
+                    if let cb = callback {
+                        if response.result.error != nil {
+                            cb(nil, response.result.error as NSError?)
+                        } else if let value = decoded {
+                            cb(value, nil)
+                        } else {
+                            cb(nil, nil)
+                        }
                     }
+                    
                 }
 
             }
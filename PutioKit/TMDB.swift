@@ -21,8 +21,8 @@ class TMDB {
     /// The sharedInstance
     static let sharedInstance = TMDB()
     
-    /// The current number of requests
-    var requests = 0
+    /// Every request goes through the scheduler so we stay inside the API quota
+    let scheduler = TMDBScheduler.sharedInstance
     
 
     
@@ -31,11 +31,17 @@ class TMDB {
     /**
      Search TMDB for tv with a string
      
-     - parameter string: The term to search the databse with
+     - parameter string:   The term to search the databse with
+     - parameter priority: How urgently the result is needed
      */
-    class func searchTVWithString(_ string: String, year: String?, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
+    class func searchTVWithString(_ string: String, year: String?, priority: TMDBPriority = .background, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
         
-        TMDB.sharedInstance.requests += 1
+        if let cached = TMDBCache.sharedInstance.lookup(string, year: year, type: "tv") {
+            DispatchQueue.main.async {
+                callback(TMDB.sharedInstance.mediaFromResult(cached, type: "tv"))
+            }
+            return
+        }
         
         var params = [
             "api_key" : TMDB.key,
@@ -46,10 +52,8 @@ class TMDB {
             params["first_air_date_year"] = year!
         }
         
-        DispatchQueue.main.asyncAfter(deadline: .now() + Double(TMDB.sharedInstance.requests / 4)) {
-            TMDB.sharedInstance.searchWithParams(params, type: "tv") { response in
-                callback(response)
-            }
+        TMDB.sharedInstance.searchWithParams(params, type: "tv", priority: priority) { response in
+            callback(response)
         }
         
     }
@@ -57,11 +61,17 @@ class TMDB {
     /**
      Search TMDB for movies with a string
      
-     - parameter string: The term to search the databse with
+     - parameter string:   The term to search the databse with
+     - parameter priority: How urgently the result is needed
      */
-    class func searchMoviesWithString(_ string: String, year: String?, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
+    class func searchMoviesWithString(_ string: String, year: String?, priority: TMDBPriority = .background, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
         
-        TMDB.sharedInstance.requests += 1
+        if let cached = TMDBCache.sharedInstance.lookup(string, year: year, type: "movie") {
+            DispatchQueue.main.async {
+                callback(TMDB.sharedInstance.mediaFromResult(cached, type: "movie"))
+            }
+            return
+        }
         
         var params = [
             "api_key" : TMDB.key,
@@ -72,74 +82,94 @@ class TMDB {
             params["year"] = year!
         }
         
-        DispatchQueue.main.asyncAfter(deadline: .now() + Double(TMDB.sharedInstance.requests / 4)) {
-            TMDB.sharedInstance.searchWithParams(params, type: "movie") { response in
-                callback(response)
-            }
+        TMDB.sharedInstance.searchWithParams(params, type: "movie", priority: priority) { response in
+            callback(response)
         }
-
         
     }
     
     /**
-     Search TMDB for movies with a string
+     Search TMDB for movies with a string. Successful searches are stored in the cache,
+     including those that found nothing.
      
-     - parameter params: The parameters to use with Alamofire
+     - parameter params:   The parameters to use with Alamofire
+     - parameter priority: How urgently the result is needed
      */
-    func searchWithParams(_ params: [String:String], type: String, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
+    func searchWithParams(_ params: [String:String], type: String, priority: TMDBPriority = .background, callback: @escaping ((movie: Movie?, tvshow: TVShow?)) -> Void) {
+        
+        let year = params["year"] ?? params["first_air_date_year"]
         
-        Alamofire.request("\(TMDB.api)search/\(type)", method: .get, parameters: params)
-            .responseJSON { response in
+        scheduler.request("\(TMDB.api)search/\(type)", parameters: params, priority: priority) { response in
+            
+            if response.result.isSuccess {
                 
-                if response.result.isSuccess {
+                let json = JSON(response.result.value!)
+                if let results = json["results"].array {
+                    
+                    let result = results.first
+                    TMDBCache.sharedInstance.store(result, for: params["query"]!, year: year, type: type)
                     
-                    let json = JSON(response.result.value!)
-                    if let results = json["results"].array {
-                        
-                        if results.count > 0 && type == "movie" {
-                            
-                            let movie = Movie()
-                            movie.id = results[0]["id"].int!
-                            movie.title = results[0]["title"].string
-                            movie.backdropURL = results[0]["backdrop_path"].string
-                            movie.posterURL = results[0]["poster_path"].string
-                            movie.overview = results[0]["overview"].string
-                            if let date = results[0]["release_date"].string {
-                                let formatter = DateFormatter()
-                                formatter.dateFormat = "yyyy-MM-dd"
-                                if let parsed = formatter.date(from: date) {
-                                    let calendar = Calendar.current
-                                    let year = calendar.component(.year, from: parsed)
-                                    movie.releaseDate = "\(year)"
-                                }
-                            }
-                            
-                            callback((movie, nil))
-                            return
-                            
-                        } else if results.count > 0 && type == "tv" {
-                            
-                            let tv = TVShow()
-                            if let id = results[0]["id"].int {
-                                tv.id = id
-                            }
-                            tv.title = results[0]["name"].string
-                            tv.posterURL = results[0]["poster_path"].string
-                            tv.overview = results[0]["overview"].string
-                            
-                            callback((nil, tv))
-                            return
-                            
-                        }
-                        
-                    }
+                    callback(self.mediaFromResult(result ?? JSON.null, type: type))
+                    return
                     
                 }
                 
-                // should add some kinda retry in
-                callback((nil, nil))
-                
+            }
+            
+            // should add some kinda retry in
+            callback((nil, nil))
+            
+        }
+    }
+    
+    /**
+     Map a TMDB search result to a movie or tv show
+     
+     - parameter result: The raw result. `.null` means the search found nothing.
+     - parameter type:   "movie" or "tv"
+     */
+    func mediaFromResult(_ result: JSON, type: String) -> (movie: Movie?, tvshow: TVShow?) {
+        
+        if result.type == .null {
+            return (nil, nil)
+        }
+        
+        if type == "movie" {
+            
+            guard let id = result["id"].int else {
+                return (nil, nil)
+            }
+            
+            let movie = Movie()
+            movie.id = id
+            movie.title = result["title"].string
+            movie.backdropURL = result["backdrop_path"].string
+            movie.posterURL = result["poster_path"].string
+            movie.overview = result["overview"].string
+            if let date = result["release_date"].string {
+                let formatter = DateFormatter()
+                formatter.dateFormat = "yyyy-MM-dd"
+                if let parsed = formatter.date(from: date) {
+                    let calendar = Calendar.current
+                    let year = calendar.component(.year, from: parsed)
+                    movie.releaseDate = "\(year)"
+                }
+            }
+            
+            return (movie, nil)
+            
         }
+        
+        let tv = TVShow()
+        if let id = result["id"].int {
+            tv.id = id
+        }
+        tv.title = result["name"].string
+        tv.posterURL = result["poster_path"].string
+        tv.overview = result["overview"].string
+        
+        return (nil, tv)
+        
     }
     
     
@@ -147,52 +177,57 @@ class TMDB {
     // MARK: - TV Shows
     
     /**
-    Fetch the TV Season from TMDB
-    
-    - parameter season:   The season on the tv show
-    - parameter episode:  The episode on the tv show
-    - parameter showId:   ID of the TV Show
-    - parameter callback: Called when TV Season is fetched
-    */
-    class func fetchEpisodeForSeason(_ season: String, episode: String, showId: Int, callback: @escaping (TVEpisode?) -> Void) {
-        
-        TMDB.sharedInstance.requests += 1
+     Fetch every episode in a TV season from TMDB with a single request
+     
+     - parameter season:   The season number
+     - parameter showId:   ID of the TV Show
+     - parameter priority: How urgently the season is needed
+     - parameter callback: Called with the episodes in the season, or nil if the request failed
+     */
+    class func fetchSeason(_ season: Int, showId: Int, priority: TMDBPriority = .interactive, callback: @escaping ([TVEpisode]?) -> Void) {
         
         let params = [
             "api_key" : TMDB.key
         ]
         
-        DispatchQueue.main.asyncAfter(deadline: .now() + Double(TMDB.sharedInstance.requests / 4)) {
+        TMDB.sharedInstance.scheduler.request("\(TMDB.api)tv/\(showId)/season/\(season)", parameters: params, priority: priority) { response in
             
-            Alamofire.request("\(TMDB.api)tv/\(showId)/season/\(season)/episode/\(episode)", method: .get, parameters: params)
-                .responseJSON { response in
-                    
-                    if response.result.isSuccess {
-                        let json = JSON(response.result.value!)
-                        
-                        let ep = TVEpisode()
-                        if let season = json["season_number"].int {
-                            ep.seasonNo = season
-                        }
-                        if let episode = json["episode_number"].int {
-                            ep.episodeNo = episode
-                        }
-                        ep.title = json["name"].string
-                        ep.overview = json["overview"].string
-                        ep.stillURL = json["still_path"].string
-                        if let id = json["id"].int {
-                            ep.id = id
-                        }
-                        ep.airDate = json["air_date"].string
-                        callback(ep)
-                        return
-                    }
-                    
-                    callback(nil)
-                    
+            if response.result.isSuccess {
+                let json = JSON(response.result.value!)
+                callback(json["episodes"].arrayValue.map(TMDB.episodeFromJSON))
+                return
             }
             
+            callback(nil)
+            
+        }
+        
+    }
+    
+    /**
+     Map TMDB episode JSON to an episode
+     
+     - parameter json: The episode JSON
+     
+     - returns: The episode
+     */
+    class func episodeFromJSON(_ json: JSON) -> TVEpisode {
+        
+        let ep = TVEpisode()
+        if let season = json["season_number"].int {
+            ep.seasonNo = season
+        }
+        if let episode = json["episode_number"].int {
+            ep.episodeNo = episode
+        }
+        ep.title = json["name"].string
+        ep.overview = json["overview"].string
+        ep.stillURL = json["still_path"].string
+        if let id = json["id"].int {
+            ep.id = id
         }
+        ep.airDate = json["air_date"].string
+        return ep
         
     }
     
@@ -0,0 +1,174 @@
+//
+//  TMDBCache.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+import SwiftyJSON
+
+/// On-disk cache of TMDB search results keyed by the normalized title, year and media type.
+/// Searches that found nothing are cached too so they aren't repeated on every sync.
+class TMDBCache {
+
+    /// The shared cache
+    static let sharedInstance = TMDBCache()
+
+    /// How long a result is trusted for
+    var ttl: TimeInterval = 60 * 60 * 24 * 30
+
+    /// How long a search that found nothing is trusted for
+    var negativeTTL: TimeInterval = 60 * 60 * 24 * 3
+
+    /// Lookups answered with a result
+    private(set) var hits = 0
+
+    /// Lookups answered with "no result"
+    private(set) var negativeHits = 0
+
+    /// Lookups that had to go to the network
+    private(set) var misses = 0
+
+    /// Where the cache is stored. This lives outside of caches so it survives Realm being wiped.
+    static var url: URL {
+        let support = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask)[0]
+        return support.appendingPathComponent("TMDBCache.json")
+    }
+
+    /// Cached entries keyed by `key(for:year:type:)`
+    private lazy var entries: [String:JSON] = TMDBCache.load()
+
+    /// Whether a save has already been scheduled
+    private var saveScheduled = false
+
+    /// Saves are written one at a time so they land in the order they were taken
+    private let saveQueue = DispatchQueue(label: "uk.co.wearecocoon.fetch.tmdb-cache", qos: .utility)
+
+
+    // MARK: - Lookup
+
+    /**
+     Normalize a title so that "The.Office", "the office" and "The Office " share a key
+
+     - parameter title: The title parsed by Downpour
+
+     - returns: Lowercased title without diacritics, punctuation or repeated whitespace
+     */
+    class func normalize(_ title: String) -> String {
+        let folded = title.folding(options: [.caseInsensitive, .diacriticInsensitive], locale: nil)
+        let words = folded.components(separatedBy: CharacterSet.alphanumerics.inverted).filter { !$0.isEmpty }
+        return words.joined(separator: " ")
+    }
+
+    /**
+     The key an entry is stored under
+
+     - parameter title: The search term
+     - parameter year:  The year, if Downpour found one
+     - parameter type:  "movie" or "tv"
+     */
+    class func key(for title: String, year: String?, type: String) -> String {
+        return "\(type)|\(normalize(title))|\(year ?? "")"
+    }
+
+    /**
+     Look up a search in the cache
+
+     - returns: nil on a miss, `.null` if the search is known to find nothing or the raw TMDB result
+     */
+    func lookup(_ title: String, year: String?, type: String) -> JSON? {
+        let key = TMDBCache.key(for: title, year: year, type: type)
+
+        guard let entry = entries[key], let cachedAt = entry["cached_at"].double else {
+            misses += 1
+            return nil
+        }
+
+        let result = entry["result"]
+        let age = Date().timeIntervalSince1970 - cachedAt
+
+        if age > (result.type == .null ? negativeTTL : ttl) {
+            entries[key] = nil
+            misses += 1
+            return nil
+        }
+
+        if result.type == .null {
+            negativeHits += 1
+        } else {
+            hits += 1
+        }
+
+        return result
+    }
+
+    /**
+     Store the result of a search
+
+     - parameter result: The first TMDB result or nil if the search found nothing
+     */
+    func store(_ result: JSON?, for title: String, year: String?, type: String) {
+        var entry: [String:Any] = ["cached_at": Date().timeIntervalSince1970]
+        if let result = result {
+            entry["result"] = result.object
+        }
+
+        entries[TMDBCache.key(for: title, year: year, type: type)] = JSON(entry)
+        scheduleSave()
+    }
+
+    /// Forget everything
+    func clear() {
+        entries = [:]
+        hits = 0
+        negativeHits = 0
+        misses = 0
+        try? FileManager.default.removeItem(at: TMDBCache.url)
+    }
+
+    /// Summary of the hit/miss counters
+    var stats: String {
+        return "\(hits) hits, \(negativeHits) negative hits, \(misses) misses"
+    }
+
+
+    // MARK: - Persistence
+
+    private class func load() -> [String:JSON] {
+        guard let data = try? Data(contentsOf: url) else {
+            return [:]
+        }
+        return JSON(data: data).dictionaryValue
+    }
+
+    /// Batch up writes so a sync doesn't rewrite the file for every search
+    private func scheduleSave() {
+        guard !saveScheduled else {
+            return
+        }
+
+        saveScheduled = true
+
+        DispatchQueue.main.asyncAfter(deadline: .now() + 2) {
+            self.saveScheduled = false
+
+            var raw: [String:Any] = [:]
+            for (key, entry) in self.entries {
+                raw[key] = entry.object
+            }
+
+            self.saveQueue.async {
+                do {
+                    try FileManager.default.createDirectory(at: TMDBCache.url.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
+                    let data = try JSONSerialization.data(withJSONObject: raw)
+                    try data.write(to: TMDBCache.url, options: .atomic)
+                } catch {
+                    print("Could not save TMDB cache: \(error)")
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,206 @@
+//
+//  TMDBScheduler.swift
+//  Fetch
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+import Alamofire
+
+/// How urgently a TMDB request is needed
+enum TMDBPriority: Int {
+
+    /// Something the user is looking at right now, such as an opened show
+    case interactive = 0
+
+    /// Library syncing
+    case background = 1
+
+}
+
+/// Queue depth and wait time numbers for the scheduler
+struct TMDBSchedulerStats {
+
+    /// Requests sent, including retries
+    var sent = 0
+
+    /// Responses that came back as 429 Too Many Requests
+    var throttled = 0
+
+    /// Requests currently waiting for a token
+    var queueDepth = 0
+
+    /// The deepest the queue has been
+    var peakQueueDepth = 0
+
+    /// Total time requests spent waiting for a token
+    var totalWait: TimeInterval = 0
+
+    /// The longest any request waited for a token
+    var maxWait: TimeInterval = 0
+
+    /// Average time a request waited for a token
+    var averageWait: TimeInterval {
+        return sent > 0 ? totalWait / Double(sent) : 0
+    }
+
+}
+
+extension TMDBSchedulerStats: CustomStringConvertible {
+
+    var description: String {
+        return String(format: "%d sent, %d throttled, %d queued (peak %d), %.2fs average wait, %.2fs max wait", sent, throttled, queueDepth, peakQueueDepth, averageWait, maxWait)
+    }
+
+}
+
+/// Schedules every request to TMDB through a token bucket sized to the API quota. Requests are
+/// queued by priority and anything that comes back with a 429 is retried after Retry-After.
+/// Everything happens on the main queue, same as the callbacks.
+class TMDBScheduler {
+
+    /// A queued request
+    private struct Job {
+        let url: String
+        let parameters: [String:String]
+        let priority: TMDBPriority
+        let attempt: Int
+        let enqueuedAt: Date
+        let completion: (DataResponse<Any>) -> Void
+    }
+
+    /// The shared scheduler
+    static let sharedInstance = TMDBScheduler()
+
+    /// Maximum burst size. TMDB allows 40 requests every 10 seconds.
+    var capacity: Double = 40
+
+    /// Tokens added every second
+    var refillRate: Double = 4
+
+    /// How many times a throttled request will be retried
+    var maxRetries = 5
+
+    /// Delay used when a 429 doesn't come with a Retry-After header
+    var defaultRetryAfter: TimeInterval = 10
+
+    /// Current queue and wait time numbers
+    private(set) var stats = TMDBSchedulerStats()
+
+    /// Tokens currently available. Starts full with whatever capacity is set before the first request.
+    private lazy var tokens: Double = self.capacity
+
+    /// When tokens were last added
+    private var lastRefill = Date()
+
+    /// Nothing is sent before this date after a 429
+    private var pausedUntil = Date.distantPast
+
+    /// One FIFO per priority, indexed by the priority's raw value
+    private var queues: [[Job]] = [[], []]
+
+    /// Whether a pump is already scheduled
+    private var pumpScheduled = false
+
+
+    // MARK: - Requests
+
+    /**
+     Queue a GET request to TMDB
+
+     - parameter url:        The URL to request
+     - parameter parameters: Query parameters
+     - parameter priority:   How urgently the response is needed
+     - parameter completion: Called on the main queue with the response
+     */
+    func request(_ url: String, parameters: [String:String], priority: TMDBPriority, completion: @escaping (DataResponse<Any>) -> Void) {
+        enqueue(Job(url: url, parameters: parameters, priority: priority, attempt: 0, enqueuedAt: Date(), completion: completion))
+        pump()
+    }
+
+    private func enqueue(_ job: Job, atFront: Bool = false) {
+        if atFront {
+            queues[job.priority.rawValue].insert(job, at: 0)
+        } else {
+            queues[job.priority.rawValue].append(job)
+        }
+
+        stats.queueDepth += 1
+        stats.peakQueueDepth = max(stats.peakQueueDepth, stats.queueDepth)
+    }
+
+    /// Take the next job, highest priority first
+    private func dequeue() -> Job? {
+        for index in queues.indices where !queues[index].isEmpty {
+            stats.queueDepth -= 1
+            return queues[index].removeFirst()
+        }
+        return nil
+    }
+
+
+    // MARK: - Token Bucket
+
+    private func refill() {
+        let now = Date()
+        tokens = min(capacity, tokens + now.timeIntervalSince(lastRefill) * refillRate)
+        lastRefill = now
+    }
+
+    /// Send as many jobs as we have tokens for, then wait for the next token
+    private func pump() {
+        refill()
+
+        let now = Date()
+
+        if now >= pausedUntil {
+            while tokens >= 1, let job = dequeue() {
+                tokens -= 1
+                send(job)
+            }
+        }
+
+        guard stats.queueDepth > 0 && !pumpScheduled else {
+            return
+        }
+
+        let delay = max(pausedUntil.timeIntervalSince(now), (1 - tokens) / refillRate, 0.01)
+        pumpScheduled = true
+        DispatchQueue.main.asyncAfter(deadline: .now() + delay) {
+            self.pumpScheduled = false
+            self.pump()
+        }
+    }
+
+    private func send(_ job: Job) {
+        let wait = Date().timeIntervalSince(job.enqueuedAt)
+        stats.sent += 1
+        stats.totalWait += wait
+        stats.maxWait = max(stats.maxWait, wait)
+
+        Alamofire.request(job.url, method: .get, parameters: job.parameters)
+            .responseJSON { response in
+
+                guard response.response?.statusCode == 429 && job.attempt < self.maxRetries else {
+                    job.completion(response)
+                    return
+                }
+
+                self.stats.throttled += 1
+
+                // Back off everything, not just this request, and go again once TMDB is ready
+                let header = response.response?.allHeaderFields["Retry-After"] as? String
+                let retryAfter = header.flatMap { TimeInterval($0) } ?? self.defaultRetryAfter
+                self.pausedUntil = max(self.pausedUntil, Date().addingTimeInterval(retryAfter))
+                self.tokens = 0
+
+                let retry = Job(url: job.url, parameters: job.parameters, priority: job.priority, attempt: job.attempt + 1, enqueuedAt: Date(), completion: job.completion)
+                self.enqueue(retry, atFront: true)
+                self.pump()
+
+        }
+    }
+
+}
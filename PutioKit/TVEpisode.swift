@@ -36,6 +36,9 @@ public class TVEpisode: Object {
     /// the putio file accompanying this tv episode
     public dynamic var file: File?
     
+    /// every putio file for this episode, e.g. when it's been added in more than one quality
+    public let files = List<File>()
+    
     override public static func primaryKey() -> String? {
         return "id"
     }
@@ -35,7 +35,7 @@ public class TVShow: Object, MediaType {
     /// Putio Files
     public let files = List<File>()
     
-    /// TV Seasons
+    /// TV Seasons. A season that was fetched but matched none of the files is kept empty so it isn't fetched again.
     public let seasons = List<TVSeason>()
     
     override public static func primaryKey() -> String? {
@@ -46,7 +46,7 @@ public class TVShow: Object, MediaType {
     // MARK: - Non-Realm Properties
     
     override public static func ignoredProperties() -> [String] {
-        return ["poster", "delegate", "requests", "completed"]
+        return ["poster", "delegate", "requests", "totalRequests", "completed", "groupedFiles"]
     }
     
     /// The poster image
@@ -92,77 +92,126 @@ public class TVShow: Object, MediaType {
     
     var requests = 0
     
+    /// Number of season requests made for the current conversion
+    private var totalRequests = 0
+    
     private var completed = 0
     
     public var completedPercent: Float {
         get {
-            return (Float(self.completed) / Float(self.files.count))
+            return totalRequests > 0 ? (Float(self.completed) / Float(totalRequests)) : 0
         }
     }
     
     
     // MARK: - Methods
     
+    /// The seasons that have episodes, in order
+    public var listedSeasons: Results<TVSeason> {
+        return seasons.filter("episodes.@count > 0").sorted(byKeyPath: "number")
+    }
+    
+    /// The IDs of the files that were last grouped and what they were grouped into
+    private var groupedFiles: (ids: [Int], seasons: [Int:[Int:[File]]])?
+    
+    /// Files grouped by season and episode number. Parsing every name with Downpour is slow, so
+    /// it's only done again when the show's files change.
+    var filesBySeason: [Int:[Int:[File]]] {
+        let ids = files.map { $0.id }
+        
+        if let grouped = groupedFiles, grouped.ids == ids {
+            return grouped.seasons
+        }
+        
+        var filesBySeason: [Int:[Int:[File]]] = [:]
+        for file in files {
+            let d = Downpour(string: file.name!)
+            if let season = d.season.flatMap({ Int($0) }), let episode = d.episode.flatMap({ Int($0) }) {
+                var episodes = filesBySeason[season] ?? [:]
+                episodes[episode] = (episodes[episode] ?? []) + [file]
+                filesBySeason[season] = episodes
+            }
+        }
+        
+        groupedFiles = (ids, filesBySeason)
+        return filesBySeason
+    }
+    
+    /// Files grouped by season and episode number, for seasons that haven't been fetched from TMDB yet.
+    /// A season stays unresolved until its request succeeds, so a failed one is retried next time.
+    var unresolvedFiles: [Int:[Int:[File]]] {
+        var unresolved = filesBySeason
+        for season in seasons {
+            unresolved[season.number] = nil
+        }
+        return unresolved
+    }
+    
+    /// Whether some files are in seasons that still need matching
+    public var hasUnresolvedSeasons: Bool {
+        return !unresolvedFiles.isEmpty
+    }
+    
     /**
-     Convert the files to TV Episodes
+     Convert the files in unresolved seasons to TV Episodes. Each season is fetched from TMDB once, the
+     files are matched to its episodes locally and every season is written in a single transaction.
      */
     public func convertFilesToEpisodes() {
         
-        guard seasons.count == 0 else {
+        // Already converting; the delegate hears when it's done
+        guard requests == 0 else {
+            return
+        }
+        
+        let filesBySeason = unresolvedFiles
+        
+        guard !filesBySeason.isEmpty else {
             self.delegate?.tvEpisodesLoaded()
             return
         }
         
-        TMDB.sharedInstance.requests = 0
+        requests = filesBySeason.count
+        totalRequests = filesBySeason.count
+        completed = 0
         
-        for file in files {
-            
-            requests += 1
+        var resolved: [TVSeason] = []
+        
+        for (number, episodeFiles) in filesBySeason {
             
-            let d = Downpour(string: file.name!)
-            if d.season != nil && d.episode != nil {
+            TMDB.fetchSeason(number, showId: id) { episodes in
+                self.requests -= 1
+                self.completed += 1
+                self.delegate?.percentUpdated()
                 
-                TMDB.fetchEpisodeForSeason(d.season!, episode: d.episode!, showId: id) { episode in
-                    self.requests -= 1
-                    self.completed += 1
-                    self.delegate?.percentUpdated()
-                    
-                    if let ep = episode {
-                        
-                        ep.file = file
-                        
-                        if let season = self.seasons.filter({ $0.number == ep.seasonNo }).first {
-                            if season.episodes.filter({ $0.id == ep.id }).isEmpty {
-                                do {
-                                    try Putio.realm.write {
-                                        season.episodes.append(ep)
-                                    }
-                                } catch {
-                                    print(error)
-                                }
-                            }
-                        } else {
-                            let season = TVSeason()
-                            season.id = Int("\(self.id)\(ep.seasonNo)")!
-                            season.number = ep.seasonNo
-                            season.episodes.append(ep)
-                            do {
-                                try Putio.realm.write {
-                                    self.seasons.append(season)
-                                }
-                            } catch {
-                                print(error)
-                            }
+                let season = TVSeason()
+                season.id = Int("\(self.id)\(number)")!
+                season.number = number
+                
+                for ep in episodes ?? [] {
+                    if let files = episodeFiles[ep.episodeNo] {
+                        ep.file = files.first
+                        ep.files.append(objectsIn: files)
+                        season.episodes.append(ep)
+                    }
+                }
+                
+                // Even with no matches the season is stored, so it isn't fetched every time the show is opened
+                if episodes != nil {
+                    resolved.append(season)
+                }
+                
+                if self.requests == 0 {
+                    do {
+                        try Putio.realm.write {
+                            self.seasons.append(objectsIn: resolved.sorted { $0.number < $1.number })
                         }
-                    
+                    } catch {
+                        print(error)
                     }
                     
-                    if self.requests == 0 {
-                        TMDB.sharedInstance.requests = 0
-                        self.delegate?.tvEpisodesLoaded()
-                    }
-    
+                    self.delegate?.tvEpisodesLoaded()
                 }
+                
             }
             
         }
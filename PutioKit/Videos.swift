@@ -19,12 +19,6 @@ public class Videos {
     /// Parsed tv shows from tmdb
     public var tvShows: [TVShow] = []
     
-    /// New movies just found on TMDB
-    private var newMovies: [Movie] = []
-    
-    /// New TV just found on TMDB
-    private var newTvShows: [TVShow] = []
-    
     /// Movies sorted alphabetically
     public var sortedMovies: [Movie] {
         get {
@@ -51,7 +45,14 @@ public class Videos {
     /// The shared instances of our lovely video class
     public static let sharedInstance = Videos()
     
-    /// Recursive method count
+    /// Breadth-first crawler used to list every folder on put.io
+    public lazy var crawler: FolderCrawler = {
+        let crawler = FolderCrawler()
+        crawler.isIncluded = { $0.isPlayable }
+        return crawler
+    }()
+    
+    /// Outstanding TMDB searches
     private var folderCount = 0
     
     /// Search Terms
@@ -72,8 +73,10 @@ public class Videos {
     
     /**
      Start fetching files and folders from Put.io
+     
+     - parameter incremental: Only list folders that have changed since the last sync and diff the results into Realm. A full sync wipes Realm and searches TMDB for everything.
      */
-    public func fetch() {
+    public func fetch(incremental: Bool = true) {
         
         guard !syncing else {
             print("already syncing")
@@ -93,47 +96,51 @@ public class Videos {
         
         cachedFileCount = UserDefaults.standard.integer(forKey: "fileCount")
         
-        let params = ["oauth_token": "\(Putio.accessToken!)", "start_from": "1"]
+        // We can only diff if there's already a library in Realm
+        let hasLibrary = !Putio.realm.objects(Movie.self).isEmpty || !Putio.realm.objects(TVShow.self).isEmpty
+        let previous = (incremental && hasLibrary) ? FileTreeSnapshot.load() : nil
         
-        Putio.get("files/list", parameters: params) { json, error in
-            if let files = json?["files"].array {
-                self.recursivelyFetchFiles(files.map(self.parseFile))
+        crawler.crawl(reusing: previous) { files, snapshot, stats in
+            print("Crawled put.io: \(stats)")
+            
+            // A cancelled crawl only found part of the tree, so there's nothing to apply.
+            // Put back what we had so the library isn't left empty.
+            guard !stats.cancelled else {
+                UIApplication.shared.isNetworkActivityIndicatorVisible = false
+                self.files = self.oldFiles
+                self.syncing = false
+                NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "TMDBFinished"), object: self) as Notification)
+                return
+            }
+            
+            self.files = files
+            
+            DispatchQueue.global(qos: .utility).async {
+                snapshot.save()
+            }
+            
+            if previous != nil {
+                self.applyChanges(complete: stats.failures == 0)
+            } else {
+                self.finishedFetchingFiles()
             }
         }
         
     }
     
     /**
-     Recursively fetch files from the original root results
-     
-     - parameter files: Files to fetch
+     Called once the crawler has listed every folder
      */
-    private func recursivelyFetchFiles(_ files: [File]) {
-        self.files.append(contentsOf: files)
-        for file in files {
-            
-            if file.is_shared {
-                continue
-            }
-            
-            if file.content_type == "application/x-directory" {
-                folderCount += 1
-                loadSubfolderFromFile(file) { files in
-                    self.folderCount -= 1
-                    self.recursivelyFetchFiles(files)
-                }
-            }
-        }
+    private func finishedFetchingFiles() {
         
+        UIApplication.shared.isNetworkActivityIndicatorVisible = false
         UserDefaults.standard.set(self.files.count, forKey: "fileCount")
         
-        if cachedFileCount == 0 && folderCount == 0 && movies.count == 0 && tvShows.count == 0 { // This is the first run
-            UIApplication.shared.isNetworkActivityIndicatorVisible = false
+        if cachedFileCount == 0 && movies.count == 0 && tvShows.count == 0 { // This is the first run
             print("Finished fetching files")
             NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "PutioFinished"), object: self) as Notification)
             convertToSearchTerms()
-        } else if folderCount == 0 { // This is a refresh
-            UIApplication.shared.isNetworkActivityIndicatorVisible = false
+        } else { // This is a refresh
             print("Finished re-fetching files")
             if self.files.count != cachedFileCount {
                 print("File count changed!")
@@ -147,66 +154,133 @@ public class Videos {
     }
     
     /**
-     Load a subfolder by using the parent_id from the file provided
+     Diff the crawled files against the library in Realm. Removed files are dropped, changed
+     files are updated in place and only new and renamed files are searched for on TMDB, so
+     unchanged movies and shows survive the sync.
      
-     - parameter file:     The folder to fetch
-     - parameter callback: Called when Alamofire has finished
+     - parameter complete: Whether every folder was listed. Nothing is removed if not.
      */
-    private func loadSubfolderFromFile(_ file: File, callback: @escaping ([File]) -> Void) {
-        guard Putio.accessToken != nil else {
-            print("Logged out")
-            return
+    private func applyChanges(complete: Bool) {
+        
+        UIApplication.shared.isNetworkActivityIndicatorVisible = false
+        UserDefaults.standard.set(files.count, forKey: "fileCount")
+        
+        let movies = Array(Putio.realm.objects(Movie.self))
+        let shows = Array(Putio.realm.objects(TVShow.self))
+        
+        var existing: [Int:File] = [:]
+        for file in movies.flatMap({ Array($0.files) }) + shows.flatMap({ Array($0.files) }) {
+            existing[file.id] = file
+        }
+        
+        var current: [Int:File] = [:]
+        for file in files where isVideo(file) {
+            current[file.id] = file
         }
         
-        let params = ["oauth_token": "\(Putio.accessToken!)", "parent_id": "\(file.id)", "start_from": "1"]
-       
-        Putio.get("files/list", parameters: params) { json, error in
-            if let files = json?["files"].array?.map(self.parseFile) {
-                for f in files {
-                    f.parent = file
+        let added = current.values.filter { existing[$0.id] == nil }
+        let removed = complete ? Set(existing.keys).subtracting(current.keys) : []
+        let changed = current.values.filter { file in
+            guard let old = existing[file.id] else { return false }
+            return old.name != file.name || old.size != file.size || old.has_mp4 != file.has_mp4 || old.accessed != file.accessed || old.start_from != file.start_from || old.screenshot != file.screenshot
+        }
+        
+        // A renamed file may be a different movie or episode now, so it's taken out of the library and matched again
+        let renamed = Set(changed.filter { $0.name != existing[$0.id]?.name }.map { $0.id })
+        let detached = removed.union(renamed)
+        
+        print("\(added.count) files added, \(changed.count) changed (\(renamed.count) renamed), \(removed.count) removed")
+        
+        do {
+            try Putio.realm.write {
+                
+                Putio.realm.add(changed, update: true)
+                
+                guard !detached.isEmpty else {
+                    return
                 }
                 
-                callback(files)
-            } else {
-                callback([])
+                for movie in movies {
+                    removeFiles(detached, from: movie.files)
+                    if movie.files.isEmpty {
+                        Putio.realm.delete(movie)
+                    }
+                }
+                
+                for show in shows {
+                    removeFiles(detached, from: show.files)
+                    if show.files.isEmpty {
+                        deleteSeasons(of: show)
+                        Putio.realm.delete(show)
+                    }
+                }
+                
+                for episode in Array(Putio.realm.objects(TVEpisode.self).filter("ANY files.id IN %@", Array(detached))) {
+                    removeFiles(detached, from: episode.files)
+                    episode.file = episode.files.first
+                }
+                Putio.realm.delete(Putio.realm.objects(TVEpisode.self).filter("files.@count == 0"))
+                Putio.realm.delete(Putio.realm.objects(File.self).filter("id IN %@", Array(removed)))
+                
             }
+        } catch {
+            print("Could not apply changes")
         }
+        
+        self.movies = Array(Putio.realm.objects(Movie.self))
+        self.tvShows = Array(Putio.realm.objects(TVShow.self))
+        
+        if added.isEmpty && renamed.isEmpty {
+            syncing = false
+            NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "TMDBFinished"), object: self) as Notification)
+        } else {
+            NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "PutioFinished"), object: self) as Notification)
+            buildSearchTerms(from: files.filter { existing[$0.id] == nil || renamed.contains($0.id) })
+            searchTMDB()
+        }
+        
+    }
+    
+    /**
+     Remove files from a Realm list. Must be called inside a write transaction.
+     
+     - parameter ids:  IDs of the files to remove
+     - parameter list: The list to remove them from
+     */
+    private func removeFiles(_ ids: Set<Int>, from list: List<File>) {
+        for (index, file) in list.enumerated().reversed() where ids.contains(file.id) {
+            list.remove(objectAtIndex: index)
+        }
+    }
+    
+    /**
+     Delete the seasons and episodes of a show so they're resolved again next time it's opened.
+     Must be called inside a write transaction.
+     
+     - parameter show: The TV show
+     */
+    private func deleteSeasons(of show: TVShow) {
+        for season in show.seasons {
+            Putio.realm.delete(season.episodes)
+        }
+        Putio.realm.delete(show.seasons)
     }
     
     /**
-     Map JSON to a file
+     Whether a file is something we can play and look up on TMDB
      
-     - parameter f: JSON to map
+     - parameter file: The file to check
      
-     - returns: File
+     - returns: Whether it's a video
      */
-    private func parseFile(f: JSON) -> File {
-        let subtitles = ""
-        let accessed = ( f["first_accessed_at"].null != nil ) ? false : true
-        let start_from = ( f["start_from"].null != nil ) ? 0 : f["start_from"].double!
-        let has_mp4 = (f["is_mp4_available"].bool != nil) ? f["is_mp4_available"].bool! : false
-        
-        let file = File()
-        file.id = f["id"].int!
-        file.name = f["name"].string!
-        file.size = f["size"].int64!
-        file.icon = f["icon"].string!
-        file.content_type = f["content_type"].string!
-        file.has_mp4 = has_mp4
-        file.parent_id = f["parent_id"].int!
-        file.subtitles = subtitles
-        file.accessed = accessed
-        file.screenshot = f["screenshot"].string
-        file.is_shared = f["is_shared"].bool!
-        file.start_from = start_from
-        file.created_at = f["created_at"].string
-        return file
+    private func isVideo(_ file: File) -> Bool {
+        return file.has_mp4 || file.content_type == "video/mp4"
     }
     
     // MARK: - TMDB
     
     /**
-    Convert names to proper search terms
+    Wipe Realm and convert every file to search terms
     */
     private func convertToSearchTerms() {
         
@@ -218,9 +292,25 @@ public class Videos {
             print("Could not delete all files")
         }
         
+        buildSearchTerms(from: files)
+        
+        print("Searching TMDB")
+        searchTMDB()
+        
+    }
+    
+    /**
+     Convert names to proper search terms
+     
+     - parameter files: The files to search for
+     */
+    private func buildSearchTerms(from files: [File]) {
+        
+        searches = [:]
+        
         for file in files {
             
-            if file.has_mp4 || file.content_type == "video/mp4" {
+            if isVideo(file) {
                 
                 let d = Downpour(string: file.name!)
   
@@ -237,9 +327,6 @@ public class Videos {
 
         }
         
-        print("Searching TMDB")
-        searchTMDB()
-        
     }
     
     /**
@@ -248,9 +335,12 @@ public class Videos {
     func searchTMDB() {
         
         folderCount = 0
-        TMDB.sharedInstance.requests = 0
-        newMovies = []
-        newTvShows = []
+        completed = 0
+        
+        guard !searches.isEmpty else {
+            finishedSearchingTMDB()
+            return
+        }
         
         UIApplication.shared.isNetworkActivityIndicatorVisible = true
         
@@ -265,12 +355,18 @@ public class Videos {
                 NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "TMDBUpdated"), object: self) as Notification)
                 
                 if let tvshow = result.tvshow {
-                    tvshow.files.append(objectsIn: term.1.files)
-                    self.newTvShows.append(tvshow)
-                    
                     do {
                         try Putio.realm.write {
-                            Putio.realm.add(tvshow, update: true)
+                            Putio.realm.add(term.1.files, update: true)
+                            
+                            // Merge into the existing show rather than replacing its files
+                            if let existing = Putio.realm.object(ofType: TVShow.self, forPrimaryKey: tvshow.id) {
+                                existing.files.append(objectsIn: term.1.files)
+                                deleteSeasons(of: existing)
+                            } else {
+                                tvshow.files.append(objectsIn: term.1.files)
+                                Putio.realm.add(tvshow, update: true)
+                            }
                         }
                     } catch {
                         print("Could not write tv shows")
@@ -278,12 +374,16 @@ public class Videos {
                 }
                 
                 if let movie = result.movie {
-                    movie.files.append(objectsIn: term.1.files)
-                    self.newMovies.append(movie)
-                    
                     do {
                         try Putio.realm.write {
-                            Putio.realm.add(movie, update: true)
+                            Putio.realm.add(term.1.files, update: true)
+                            
+                            if let existing = Putio.realm.object(ofType: Movie.self, forPrimaryKey: movie.id) {
+                                existing.files.append(objectsIn: term.1.files)
+                            } else {
+                                movie.files.append(objectsIn: term.1.files)
+                                Putio.realm.add(movie, update: true)
+                            }
                         }
                     } catch {
                         print("Could not write movies")
@@ -291,20 +391,8 @@ public class Videos {
                 }
                 
                 if self.folderCount == 0 {
-                    print("TMDB Search Complete")
-                    
-                    // Set movies to be the new movies from the fetch/refresh
-                    self.movies = self.newMovies
-                    self.tvShows = self.newTvShows
-
-                    TMDB.sharedInstance.requests = 0
-                    
-                    UIApplication.shared.isNetworkActivityIndicatorVisible = false
-                    syncing = false
-                    
-                    // Tell the App it's all done
-                    NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "TMDBFinished"), object: self) as Notification)
-                    
+                    print("TMDB Search Complete (cache: \(TMDBCache.sharedInstance.stats), scheduler: \(TMDBScheduler.sharedInstance.stats))")
+                    finishedSearchingTMDB()
                 }
                 
             }
@@ -321,6 +409,23 @@ public class Videos {
     
   
     
+    /**
+     Called once every search term has been looked up on TMDB
+     */
+    private func finishedSearchingTMDB() {
+        
+        // Everything that was found on this or any previous sync is in Realm
+        movies = Array(Putio.realm.objects(Movie.self))
+        tvShows = Array(Putio.realm.objects(TVShow.self))
+        
+        UIApplication.shared.isNetworkActivityIndicatorVisible = false
+        syncing = false
+        
+        // Tell the App it's all done
+        NotificationCenter.default.post(NSNotification(name: NSNotification.Name(rawValue: "TMDBFinished"), object: self) as Notification)
+        
+    }
+    
     /// Atomically wipe the shared instance
     public func wipe() {
         syncing = false
@@ -329,6 +434,7 @@ public class Videos {
         movies = []
         searches = [:]
         UserDefaults.standard.set(0, forKey: "fileCount")
+        FileTreeSnapshot.remove()
     }
 
     
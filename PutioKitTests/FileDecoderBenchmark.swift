@@ -0,0 +1,161 @@
+//
+//  FileDecoderBenchmark.swift
+//  PutioKitTests
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import Foundation
+import SwiftyJSON
+@testable import PutioKit
+
+/// Timing and heap numbers for one way of decoding a listing
+struct FileDecoderBenchmarkResult {
+
+    /// Name of the decoding path
+    let name: String
+
+    /// Entries decoded
+    let entries: Int
+
+    /// Fastest run in seconds
+    let best: TimeInterval
+
+    /// Mean run in seconds
+    let mean: TimeInterval
+
+    /// Heap bytes still in use while the decoded files are held. This is the peak for the result set.
+    let heapBytes: Int
+
+    /// Heap blocks still in use while the decoded files are held
+    let heapBlocks: Int
+
+}
+
+extension FileDecoderBenchmarkResult: CustomStringConvertible {
+
+    var description: String {
+        return String(format: "%@: %d entries, best %.1fms, mean %.1fms, %d KB / %d blocks on the heap", name, entries, best * 1000, mean * 1000, heapBytes / 1024, heapBlocks)
+    }
+
+}
+
+/// Decodes a synthetic `files/list` payload with `FileDecoder` and with the SwiftyJSON mapping
+/// it replaces. `FileDecoderBenchmarkTests` runs it and logs the results.
+class FileDecoderBenchmark {
+
+    /**
+     Build a payload shaped like a real files/list response
+
+     - parameter count: Number of entries
+
+     - returns: The encoded JSON
+     */
+    class func payload(count: Int) -> Data {
+        var files: [[String:Any]] = []
+        files.reserveCapacity(count)
+
+        for i in 0..<count {
+            let folder = i % 10 == 0
+            var entry: [String:Any] = [
+                "id": 100000 + i,
+                "name": folder ? "Folder \(i)" : "Show.Name.S0\(i % 9 + 1)E\(i % 24 + 1).720p.HDTV.x264.mp4",
+                "size": Int64(i) * 1048576,
+                "icon": "https://put.io/images/file_types/video.png",
+                "content_type": folder ? "application/x-directory" : "video/mp4",
+                "is_mp4_available": !folder,
+                "parent_id": i / 10,
+                "opensubtitles_hash": i % 3 == 0 ? NSNull() : "8e245d9679d31e12" as Any,
+                "first_accessed_at": i % 2 == 0 ? NSNull() : "2016-01-08T12:00:00" as Any,
+                "screenshot": "https://put.io/screenshots/\(i).jpg",
+                "is_shared": false,
+                "start_from": i % 5 == 0 ? NSNull() : 120.5 as Any,
+                "created_at": "2016-01-08T12:00:00"
+            ]
+
+            // Some listings leave the key out rather than sending null
+            if i % 4 == 2 {
+                entry["first_accessed_at"] = nil
+            }
+
+            files.append(entry)
+        }
+
+        return try! JSONSerialization.data(withJSONObject: ["status": "OK", "files": files])
+    }
+
+    /**
+     Run the benchmark
+
+     - parameter count:      Number of entries in the payload
+     - parameter iterations: Number of timed runs per decoder
+
+     - returns: One result per decoding path
+     */
+    @discardableResult
+    class func run(count: Int = 10_000, iterations: Int = 5) -> [FileDecoderBenchmarkResult] {
+        let data = payload(count: count)
+        print("Decoding \(data.count) bytes")
+
+        let results = [
+            measure("FileDecoder", iterations: iterations) { FileDecoder.files(from: data) },
+            measure("SwiftyJSON", iterations: iterations) { swiftyJSONFiles(from: data) }
+        ]
+
+        results.forEach { print($0) }
+        return results
+    }
+
+    private class func measure(_ name: String, iterations: Int, decode: () -> [File]) -> FileDecoderBenchmarkResult {
+        var times: [TimeInterval] = []
+        var heapBytes = 0
+        var heapBlocks = 0
+        var entries = 0
+
+        for _ in 0..<iterations {
+            autoreleasepool {
+                let before = heap()
+                let start = CFAbsoluteTimeGetCurrent()
+                let files = decode()
+                times.append(CFAbsoluteTimeGetCurrent() - start)
+
+                let after = heap()
+                heapBytes = max(heapBytes, after.bytes - before.bytes)
+                heapBlocks = max(heapBlocks, after.blocks - before.blocks)
+                entries = files.count
+            }
+        }
+
+        return FileDecoderBenchmarkResult(name: name, entries: entries, best: times.min() ?? 0, mean: times.reduce(0, +) / Double(max(times.count, 1)), heapBytes: heapBytes, heapBlocks: heapBlocks)
+    }
+
+    /// Bytes and blocks currently allocated across every malloc zone
+    private class func heap() -> (bytes: Int, blocks: Int) {
+        var stats = malloc_statistics_t()
+        malloc_zone_statistics(nil, &stats)
+        return (Int(stats.size_in_use), Int(stats.blocks_in_use))
+    }
+
+    /// The per-field SwiftyJSON mapping the app used before `FileDecoder`
+    class func swiftyJSONFiles(from data: Data) -> [File] {
+        return JSON(data: data)["files"].arrayValue.map { f in
+            let file = File()
+            file.id = f["id"].intValue
+            file.name = f["name"].string
+            file.size = f["size"].int64Value
+            file.icon = f["icon"].string
+            file.content_type = f["content_type"].string
+            file.has_mp4 = f["is_mp4_available"].bool ?? false
+            file.parent_id = f["parent_id"].intValue
+            file.subtitles = f["opensubtitles_hash"].string ?? ""
+            file.accessed = f["first_accessed_at"].null == nil
+            file.screenshot = f["screenshot"].string
+            file.is_shared = f["is_shared"].boolValue
+            file.start_from = f["start_from"].double ?? 0
+            file.created_at = f["created_at"].string
+            return file
+        }
+    }
+
+}
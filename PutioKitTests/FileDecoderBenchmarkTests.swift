@@ -0,0 +1,38 @@
+//
+//  FileDecoderBenchmarkTests.swift
+//  PutioKitTests
+//
+//  Created by Stephen Radford on 18/10/2026.
+//  Copyright © 2026 Cocoon Development Ltd. All rights reserved.
+//
+
+import XCTest
+@testable import PutioKit
+
+class FileDecoderBenchmarkTests: XCTestCase {
+
+    func testDecodersAgree() {
+        let data = FileDecoderBenchmark.payload(count: 100)
+        let decoded = FileDecoder.files(from: data)
+        let mapped = FileDecoderBenchmark.swiftyJSONFiles(from: data)
+
+        XCTAssertEqual(decoded.count, mapped.count)
+        for (file, expected) in zip(decoded, mapped) {
+            XCTAssertEqual(file.id, expected.id)
+            XCTAssertEqual(file.name, expected.name)
+            XCTAssertEqual(file.size, expected.size)
+            XCTAssertEqual(file.has_mp4, expected.has_mp4)
+            XCTAssertEqual(file.subtitles, expected.subtitles)
+            XCTAssertEqual(file.accessed, expected.accessed, "first_accessed_at of file \(file.id)")
+            XCTAssertEqual(file.start_from, expected.start_from)
+        }
+    }
+
+    func testBenchmark() {
+        let results = FileDecoderBenchmark.run()
+
+        XCTAssertEqual(results.count, 2)
+        XCTAssertEqual(results[0].entries, results[1].entries)
+    }
+
+}